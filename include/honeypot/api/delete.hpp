@@ -17,8 +17,8 @@ namespace honeypot::api
 {
 	/**
 	 * @brief Handles DELETE requests to /api/delete.
-	 * Parses the model name from the request body and attempts to remove the model
-	 * from the honeypot's state.
+	 * Parses the model name from the request body and removes the model from the
+	 * requesting source's view of the catalog; other sources still see it.
 	 * @param state Shared pointer to the global HoneypotState.
 	 * @param req The incoming crow::request object containing the JSON body.
 	 * @return A crow::response indicating success (200 OK) or failure (400 Bad Request, 404 Not Found).
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <chrono>
+#include <crow.h>
+#include <memory>
+
+namespace honeypot::state
+{
+	class HoneypotState;
+}
+
+namespace crow
+{
+	struct request;
+}
+
+namespace honeypot::api
+{
+	/**
+	 * @brief Handles POST requests to /api/generate.
+	 * Produces a fake completion for a known model, streamed as NDJSON by default or as a
+	 * single JSON object when "stream" is false. Token counts use the model's own vocabulary.
+	 * The response is completed asynchronously once the simulated load, prompt evaluation and
+	 * generation time has passed on the shared timer wheel; no worker blocks meanwhile.
+	 * @param state Shared pointer to the global HoneypotState.
+	 * @param req The incoming crow::request object containing the JSON body.
+	 * @param res The response to fill and end(), immediately for errors (400 Bad Request, 404 Not Found).
+	 * @param tarpit_hold The tarpit's hold for the source, added to every response's delay.
+	 */
+	void handle_generate(const std::shared_ptr<state::HoneypotState>& state, const crow::request& req,
+	                     crow::response& res, std::chrono::milliseconds tarpit_hold);
+
+	/**
+	 * @brief Handles POST requests to /api/chat.
+	 * Same as handle_generate, but takes a "messages" array and answers with assistant messages.
+	 * @param state Shared pointer to the global HoneypotState.
+	 * @param req The incoming crow::request object containing the JSON body.
+	 * @param res The response to fill and end(), immediately for errors (400 Bad Request, 404 Not Found).
+	 * @param tarpit_hold The tarpit's hold for the source, added to every response's delay.
+	 */
+	void handle_chat(const std::shared_ptr<state::HoneypotState>& state, const crow::request& req,
+	                 crow::response& res, std::chrono::milliseconds tarpit_hold);
+} // namespace honeypot::api
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <crow.h>
+#include <nlohmann/json_fwd.hpp>
+
+namespace honeypot::config
+{
+	struct TagModelInfo;
+}
+
+namespace honeypot::state
+{
+	struct ModelPayload;
+}
+
+namespace honeypot::utils
+{
+	class BpeTokenizer;
+}
+
+namespace honeypot::api::generation
+{
+	// Shared by the native (/api/generate, /api/chat) and OpenAI-compatible (/v1/...) generation routes.
+
+	inline constexpr std::chrono::seconds default_keep_alive{300};
+	inline constexpr uint32_t default_max_pieces = 512;
+
+	// Token overhead of a llama3-style prompt template around the user's text.
+	inline constexpr uint64_t generate_template_tokens = 10; // BOS, user header, eot, assistant header
+	inline constexpr uint64_t chat_base_tokens = 5;          // BOS and the trailing assistant header
+	inline constexpr uint64_t chat_message_tokens = 4;       // role header and eot per message
+	inline constexpr size_t max_tokenized_bytes = 256 * 1024; // client text BPE-counted per request; the rest is estimated
+
+	/**
+	 * @brief A finished response plus how long the simulated model would have needed to produce it.
+	 */
+	struct Completion
+	{
+		crow::response response;
+		uint64_t delay_ns = 0;
+	};
+
+	/**
+	 * @brief Accepts Ollama's keep_alive forms: a number of seconds or a duration string such as
+	 * "5m", "1h", "30s". Negative values, and durations of a year or more, keep the model loaded
+	 * indefinitely; "inf" and "nan" fall back to the default.
+	 */
+	std::chrono::seconds parse_keep_alive(const nlohmann::ordered_json& body);
+
+	/**
+	 * @brief @p object's string @p field; empty if it is missing or not a string, so a wrong-typed
+	 * field is ignored instead of failing the request with a type_error.
+	 */
+	std::string string_field(const nlohmann::ordered_json& object, std::string_view field);
+
+	/**
+	 * @brief An Ollama-style {"error": @p message} response with status @p code, as the native
+	 * /api routes return it.
+	 */
+	crow::response json_error(int code, std::string_view message);
+
+	/**
+	 * @brief Tokens in client-supplied @p text: counted with @p tokenizer while @p byte_budget lasts
+	 * (it is charged for every byte counted), estimated beyond it and for models without a tokenizer.
+	 * Callers start each request at max_tokenized_bytes.
+	 */
+	uint64_t count_tokens(const std::shared_ptr<const utils::BpeTokenizer>& tokenizer, std::string_view text,
+	                      size_t& byte_budget);
+
+	/**
+	 * @brief Tokens in text the honeypot generated itself, which is bounded by its piece limit.
+	 */
+	uint64_t count_tokens(const std::shared_ptr<const utils::BpeTokenizer>& tokenizer, std::string_view text);
+
+	/**
+	 * @brief @p payload's catalog entry, or nullptr if the model could not be resolved.
+	 */
+	const config::TagModelInfo* model_info(const std::shared_ptr<const state::ModelPayload>& payload);
+
+	uint64_t random_seed();
+
+	/**
+	 * @brief How many pieces a reply aims for before stopping at a sentence end, drawn from @p seed.
+	 */
+	uint32_t target_pieces(uint64_t seed);
+
+	/**
+	 * @brief Hands @p completion to the client once its simulated duration has passed. The wait is a
+	 * timer wheel entry, and the response is ended on the connection's own io_context. A non-zero
+	 * @p hold (the tarpit's verdict on the source) is added on top and goes through the tarpit.
+	 */
+	void complete_after(const crow::request& req, crow::response& res, Completion completion,
+	                    std::chrono::milliseconds hold);
+
+	/**
+	 * @brief Ends @p res with @p error, right away unless the source is tarpitted (@p hold).
+	 */
+	void fail(const crow::request& req, crow::response& res, crow::response error, std::chrono::milliseconds hold);
+} // namespace honeypot::api::generation
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <crow.h>
+#include <memory>
+
+namespace honeypot::state
+{
+	class HoneypotState;
+}
+
+namespace crow
+{
+	struct request;
+}
+
+namespace honeypot::api
+{
+	/**
+	 * @brief Handles POST requests to /api/copy.
+	 * Makes "source" visible to the requesting source under "destination" as well. The copy
+	 * aliases the original's catalog entry and /api/show details instead of duplicating them.
+	 * @param state Shared pointer to the global HoneypotState.
+	 * @param req The incoming crow::request object containing the JSON body.
+	 * @return A crow::response indicating success (200 OK, no body) or failure (400 Bad Request, 404 Not Found).
+	 */
+	crow::response handle_copy(const std::shared_ptr<state::HoneypotState>& state, const crow::request& req);
+
+	/**
+	 * @brief Handles POST requests to /api/create.
+	 * Creates "model" from an existing one ("from", or the FROM line of a legacy "modelfile"),
+	 * answering with NDJSON status lines by default or a single status when "stream" is false.
+	 * Without system, template, parameters, license or messages the result is an alias of the
+	 * base model; otherwise it gets its own digest but still shares the base model's details.
+	 * @param state Shared pointer to the global HoneypotState.
+	 * @param req The incoming crow::request object containing the JSON body.
+	 * @return A crow::response with the status stream, or an error (400 Bad Request, 500 when not streaming).
+	 */
+	crow::response handle_create(const std::shared_ptr<state::HoneypotState>& state, const crow::request& req);
+} // namespace honeypot::api
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <crow.h>
+
+namespace honeypot::api
+{
+	/**
+	 * @brief Ollama's (gin's) response for unknown routes: text/plain "404 page not found".
+	 */
+	crow::response handle_not_found();
+} // namespace honeypot::api
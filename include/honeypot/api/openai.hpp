@@ -0,0 +1,49 @@
+#pragma once
+
+#include <chrono>
+#include <crow.h>
+#include <memory>
+
+namespace honeypot::state
+{
+	class HoneypotState;
+}
+
+namespace crow
+{
+	struct request;
+}
+
+namespace honeypot::api
+{
+	/**
+	 * @brief Handles POST requests to /v1/chat/completions, Ollama's OpenAI-compatible chat.
+	 * Answers a chat.completion object, or with "stream": true a Server-Sent Events stream of
+	 * chat.completion.chunk objects closed by "data: [DONE]". Errors use OpenAI's error envelope.
+	 * Completed asynchronously after the simulated generation time, like handle_chat, and held
+	 * for @p tarpit_hold on top.
+	 */
+	void handle_openai_chat(const std::shared_ptr<state::HoneypotState>& state, const crow::request& req,
+	                        crow::response& res, std::chrono::milliseconds tarpit_hold);
+
+	/**
+	 * @brief Handles POST requests to /v1/completions (legacy text completions), streamed the
+	 * same way as handle_openai_chat.
+	 */
+	void handle_openai_completion(const std::shared_ptr<state::HoneypotState>& state, const crow::request& req,
+	                              crow::response& res, std::chrono::milliseconds tarpit_hold);
+
+	/**
+	 * @brief Handles POST requests to /v1/embeddings with deterministic unit-length vectors, one
+	 * per input string.
+	 */
+	void handle_openai_embeddings(const std::shared_ptr<state::HoneypotState>& state, const crow::request& req,
+	                              crow::response& res, std::chrono::milliseconds tarpit_hold);
+
+	/**
+	 * @brief Handles GET requests to /v1/models from the state's cached catalog body, with the
+	 * same If-None-Match handling as /api/tags.
+	 */
+	crow::response handle_openai_models(const std::shared_ptr<state::HoneypotState>& state,
+	                                    const crow::request& req);
+} // namespace honeypot::api
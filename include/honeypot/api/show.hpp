@@ -13,6 +13,8 @@ namespace honeypot::api
 	 * @brief Handles POST requests to /api/show.
 	 * Loads model details from configured JSON file (with caching),
 	 * optionally removes verbose fields, and returns the details.
+	 * Both variants are pre-rendered on first load; a matching If-None-Match
+	 * yields 304 Not Modified.
 	 * @param config_ptr Shared pointer to the HoneypotConfig (needed for base path).
 	 * @param state_ptr Shared pointer to the global HoneypotState (for map & cache).
 	 * @param req The incoming crow::request object containing the JSON body.
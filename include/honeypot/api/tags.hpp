@@ -17,9 +17,11 @@ namespace honeypot::api
 {
 	/**
 	 * @brief Handles GET requests to /api/tags.
-	 * Retrieves the current list of available models from the state.
+	 * Serves the state's cached model list body, or 304 Not Modified when the
+	 * request's If-None-Match matches the current catalog generation.
 	 * @param state Shared pointer to the global HoneypotState.
+	 * @param req The incoming crow::request object (for conditional headers).
 	 * @return A crow::response containing the list of models as JSON.
 	 */
-	crow::response handle_tags(const std::shared_ptr<state::HoneypotState>& state);
+	crow::response handle_tags(const std::shared_ptr<state::HoneypotState>& state, const crow::request& req);
 } // namespace honeypot::api
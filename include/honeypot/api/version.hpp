@@ -1,13 +1,13 @@
 #pragma once
 
-#include <crow.h>
+#include <string_view>
 
-namespace honeypot::config
-{
-	struct HoneypotConfig;
-}
+#include <crow.h>
 
 namespace honeypot::api
 {
-	crow::response handle_version(const config::HoneypotConfig& config);
+	/**
+	 * @brief Reports @p version, the configured one or that of the endpoint the request came in on.
+	 */
+	crow::response handle_version(std::string_view version);
 } // namespace honeypot::api
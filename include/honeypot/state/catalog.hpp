@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <tsl/robin_map.h>
+
+#include "utils/config.hpp"
+
+namespace honeypot::state
+{
+	/*
+	 * A model manifest is one file per model in ApiBehaviorConfig::catalog_dir:
+	 *
+	 *   line 1   the /api/tags entry, as a single-line JSON object (same fields as tag_models)
+	 *   rest     optional /api/show body for the model
+	 *
+	 * Indexing reads only the first line of each manifest; the show body is read on demand.
+	 */
+	inline constexpr std::string_view manifest_extension = ".manifest";
+
+	/**
+	 * @brief The base catalog: tag entries plus model name -> detail path (relative to config/).
+	 */
+	struct ModelCatalog
+	{
+		std::vector<config::TagModelInfo> models;
+		tsl::robin_map<std::string, std::string> detail_paths;
+	};
+
+	/**
+	 * @brief Builds the base catalog from the config's tag_models and show_file_map, then from every
+	 * manifest in catalog_dir. Config entries win on name clashes; unreadable manifests are skipped.
+	 */
+	ModelCatalog load_model_catalog(const config::ApiBehaviorConfig& api_behavior);
+
+	/**
+	 * @brief Reads the /api/show body at @p path: the whole file for plain detail files, everything
+	 * after the header line for manifests.
+	 * @throws std::ios_base::failure if the file cannot be read.
+	 */
+	std::string read_detail_file(const std::string& path);
+} // namespace honeypot::state
@@ -1,8 +1,14 @@
 #pragma once
 
 #include "utils/config.hpp"
+#include "utils/hash.hpp"
+#include "utils/tokenizer.hpp"
 #include <nlohmann/json_fwd.hpp>
 #include <tsl/robin_map.h>
+#include <tsl/robin_set.h>
+#include <array>
+#include <atomic>
+#include <utility>
 #include <vector>
 #include <string>
 #include <string_view>
@@ -11,6 +17,7 @@
 #include <shared_mutex>
 #include <mutex>
 #include <chrono>
+#include <list>
 
 namespace honeypot::state {
 
@@ -21,30 +28,341 @@ namespace honeypot::state {
 		uint64_t size_vram = 0;
 	};
 
+	/**
+	 * @brief Outcome of a simulated model load; cold loads pay the full load latency.
+	 */
+	enum class ModelLoadResult
+	{
+		not_found,
+		cold,
+		warm
+	};
+
+	/**
+	 * @brief A fully serialized response body plus its strong entity tag.
+	 * Built once and shared read-only between requests.
+	 */
+	struct CachedBody
+	{
+		std::string body;
+		std::string etag;
+	};
+
+	/**
+	 * @brief Renderings of the model catalog that are served from cache.
+	 */
+	enum class CatalogView : uint8_t
+	{
+		tags,          // /api/tags
+		openai_models, // /v1/models
+	};
+	inline constexpr size_t catalog_view_count = 2;
+
+	/**
+	 * @brief A catalog body and the base catalog generation it was rendered from.
+	 */
+	struct CachedCatalogBody
+	{
+		std::shared_ptr<const CachedBody> body;
+		uint64_t base_generation = 0;
+		size_t memory_bytes = 0; // charged against the catalog cache budget
+	};
+
+	/**
+	 * @brief Pre-rendered /api/show bodies for one detail file.
+	 * The verbose variant keeps the tokenizer arrays, the default one nulls them out.
+	 * The tokenizer is built from the same arrays while the file is parsed.
+	 */
+	struct CachedDetail
+	{
+		CachedBody verbose;
+		CachedBody brief;
+		std::shared_ptr<const utils::BpeTokenizer> tokenizer;
+		size_t memory_bytes = 0; // charged against the detail cache budget
+	};
+
+	/**
+	 * @brief Occupancy of the /api/show detail cache.
+	 */
+	struct DetailCacheStats
+	{
+		size_t entries = 0;
+		size_t bytes = 0;
+		size_t budget = 0;
+	};
+
+	/**
+	 * @brief A model's catalog entry and /api/show mapping, immutable once built.
+	 * Shared by every name the model is reachable under, so copies cost no payload of their own.
+	 */
+	struct ModelPayload
+	{
+		config::TagModelInfo info;
+		std::string detail_path; // show_file_map-style path, empty if /api/show should 404
+	};
+
+	/**
+	 * @brief A model one source pulled, copied or created, visible to that source only.
+	 */
+	struct OverlayModel
+	{
+		std::string name;
+		std::string modified_at; // empty to list the payload's
+		std::shared_ptr<const ModelPayload> payload;
+
+		/**
+		 * @brief The payload's catalog entry as listed under this name.
+		 */
+		config::TagModelInfo tag_info() const;
+	};
+
+	/**
+	 * @brief One source's private changes on top of the shared base catalog.
+	 *
+	 * Deletes name base models, added models shadow base models of the same name, and loaded
+	 * models are tracked per source only. A fresh overlay holds three empty containers, so creating
+	 * one costs a map slot and nothing else.
+	 */
+	struct SessionOverlay
+	{
+		tsl::robin_set<std::string, utils::TransparentStringHash, utils::TransparentStringEqual> deleted;
+		std::vector<OverlayModel> added;
+		std::vector<LoadedModelInfo> loaded;
+		std::chrono::steady_clock::time_point last_seen{};
+		uint64_t catalog_generation = 0; // unique across overlays, replaced whenever deleted or added change
+
+		bool changes_catalog() const { return !deleted.empty() || !added.empty(); }
+		bool is_deleted(std::string_view model_name) const;
+		const OverlayModel* find_added(std::string_view model_name) const;
+	};
+
+	/**
+	 * @brief Per-source overlays in a sharded table, expired after the session TTL.
+	 *
+	 * Overlays are only reachable through with_existing()/with_overlay(), which run the callback
+	 * under the owning shard's lock. A full shard first drops expired overlays, then the least
+	 * recently seen one. An overlay found expired is reset, so a returning source starts clean.
+	 */
+	class SessionOverlays
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+		static constexpr size_t max_models_per_overlay = 64;
+
+		explicit SessionOverlays(const config::SessionConfig& config);
+
+		/**
+		 * @brief Calls @p fn with @p source's live overlay, or nullptr if it has none.
+		 */
+		template <typename Fn>
+		decltype(auto) with_existing(const std::string_view source, Fn&& fn)
+		{
+			Shard& shard = shard_for(source);
+			std::scoped_lock lock(shard.mutex);
+			return std::forward<Fn>(fn)(find_live(shard, source, Clock::now()));
+		}
+
+		/**
+		 * @brief Calls @p fn with @p source's overlay, creating it if needed.
+		 */
+		template <typename Fn>
+		decltype(auto) with_overlay(const std::string_view source, Fn&& fn)
+		{
+			Shard& shard = shard_for(source);
+			std::scoped_lock lock(shard.mutex);
+			return std::forward<Fn>(fn)(overlay_for(shard, source, Clock::now()));
+		}
+
+		uint64_t next_catalog_generation() { return next_catalog_generation_.fetch_add(1, std::memory_order_relaxed); }
+
+		/**
+		 * @brief Copies every unexpired overlay, for snapshots.
+		 */
+		std::vector<std::pair<std::string, SessionOverlay>> live_overlays() const;
+
+		/**
+		 * @brief Installs a restored overlay, replacing any existing one for @p source.
+		 */
+		void restore(std::string source, SessionOverlay overlay);
+
+		std::chrono::seconds ttl() const { return std::chrono::seconds(config_.ttl_seconds); }
+
+	private:
+		struct Shard
+		{
+			mutable std::mutex mutex;
+			tsl::robin_map<std::string, SessionOverlay, utils::TransparentStringHash, utils::TransparentStringEqual>
+			overlays;
+		};
+
+		static constexpr size_t shard_count = 64;
+
+		Shard& shard_for(std::string_view source);
+		SessionOverlay* find_live(Shard& shard, std::string_view source, Clock::time_point now);
+		SessionOverlay& overlay_for(Shard& shard, std::string_view source, Clock::time_point now);
+		void make_room(Shard& shard, Clock::time_point now);
+
+		config::SessionConfig config_;
+		size_t max_per_shard_;
+		std::array<Shard, shard_count> shards_;
+		std::atomic<uint64_t> next_catalog_generation_{1};
+	};
+
 
+	/**
+	 * @brief The shared base catalog plus one copy-on-write overlay per source.
+	 *
+	 * Every catalog accessor takes the requesting source (its IP) and sees the base catalog
+	 * merged with that source's overlay, so deletes, pulls and loads by one client never show up
+	 * for another. The base catalog only changes when a snapshot is restored.
+	 */
 	class HoneypotState {
 	public:
 		explicit HoneypotState(const config::HoneypotConfig& config);
 
-		std::vector<config::TagModelInfo> get_available_models();
-		std::vector<LoadedModelInfo> get_loaded_models();
-		std::optional<std::string> get_detail_file_path(std::string_view model_name);
-		std::optional<nlohmann::ordered_json> get_cached_detail(std::string_view file_path);
+		std::vector<config::TagModelInfo> get_available_models(std::string_view source);
+		std::vector<LoadedModelInfo> get_loaded_models(std::string_view source);
+		std::optional<std::string> get_detail_file_path(std::string_view source, std::string_view model_name);
+		std::shared_ptr<const CachedDetail> get_cached_detail(std::string_view file_path);
 
-		void cache_detail(std::string_view file_path, nlohmann::ordered_json detail);
-		bool delete_model(std::string_view model_name);
-		bool load_or_update_model(std::string_view model_name, std::chrono::seconds keep_alive);
+		/**
+		 * @brief Returns the cached detail for @p file_path, parsing and caching it on a miss.
+		 * The cache holds at most detail_cache_bytes of parsed details and evicts the least
+		 * recently used ones; evicted details stay alive while a request still holds them.
+		 * @throws std::ios_base::failure if the file cannot be read.
+		 * @throws nlohmann::json::parse_error if the file is not valid JSON.
+		 */
+		std::shared_ptr<const CachedDetail> load_detail(const std::string& file_path);
 
-		// bool pull_model(...);
+		/**
+		 * @brief Tokenizer for @p model_name, or nullptr if its details carry no BPE vocabulary.
+		 */
+		std::shared_ptr<const utils::BpeTokenizer> get_tokenizer(std::string_view source, std::string_view model_name);
+
+		/**
+		 * @brief Maps a show_file_map entry to the path detail files are read from.
+		 */
+		static std::string resolve_detail_path(std::string_view relative_path);
+
+		/**
+		 * @brief Returns the serialized @p view of the catalog as @p source sees it.
+		 * Sources without catalog changes share one body per base generation; the others get
+		 * their own, kept in an LRU cache of at most catalog_cache_bytes shared by all overlays.
+		 * ETags are derived from the generations involved.
+		 */
+		std::shared_ptr<const CachedBody> get_catalog_body(std::string_view source, CatalogView view);
+		std::shared_ptr<const CachedBody> get_tags_body(const std::string_view source)
+		{
+			return get_catalog_body(source, CatalogView::tags);
+		}
+		uint64_t generation() const;
+
+		/**
+		 * @brief Hides @p model_name from @p source and unloads it there.
+		 * @return false if @p source could not see the model.
+		 */
+		bool delete_model(std::string_view source, std::string_view model_name);
+
+		/**
+		 * @brief Makes @p info visible to @p source (a pull), shadowing any base model of the same
+		 * name, with /api/show served from @p detail_path.
+		 * @return false if the source's overlay already holds max_models_per_overlay models.
+		 */
+		bool add_model(std::string_view source, const config::TagModelInfo& info, std::string_view detail_path);
+
+		/**
+		 * @brief Makes @p payload visible to @p source as @p model_name (a copy or create), listed
+		 * as modified now. Only the name and a handle are stored, whatever the payload's size.
+		 * @return false if the source's overlay already holds max_models_per_overlay models.
+		 */
+		bool add_model(std::string_view source, std::string_view model_name,
+		               std::shared_ptr<const ModelPayload> payload);
+
+		/**
+		 * @brief The payload behind @p model_name as @p source sees it, or nullptr if the source
+		 * cannot see the model. Base models get one payload each, built on first use.
+		 */
+		std::shared_ptr<const ModelPayload> find_model(std::string_view source, std::string_view model_name);
+
+		/**
+		 * @brief Marks @p model_name loaded for @p source for @p keep_alive. Loading again after the
+		 * keep-alive ran out counts as cold.
+		 */
+		ModelLoadResult load_or_update_model(std::string_view source, std::string_view model_name,
+		                                     std::chrono::seconds keep_alive);
+
+		/**
+		 * @brief Bumped on every change worth persisting: catalog edits, loads and keep-alive updates.
+		 */
+		uint64_t revision() const;
+
+		/**
+		 * @brief Encodes the base catalog, detail mappings and live overlays in the snapshot format
+		 * (see state/snapshot.hpp). Locks are held only while copying.
+		 * @param revision Receives the revision the snapshot reflects.
+		 */
+		std::string encode_snapshot(uint64_t& revision) const;
+
+		/**
+		 * @brief Restores state from a snapshot file. The base catalog is only taken over if the
+		 * config's catalog is unchanged since the snapshot; overlays whose session has not expired
+		 * are restored either way.
+		 * @return false if the file is missing or unusable (the state is left untouched).
+		 */
+		bool restore_snapshot(const std::string& path);
+
+		/**
+		 * @brief Copies every source's unexpired overlay, taking one shard lock at a time.
+		 */
+		std::vector<std::pair<std::string, SessionOverlay>> live_sessions() const;
+
+		DetailCacheStats detail_cache_stats();
+
+		/**
+		 * @brief Empties the detail cache and drops every cached catalog body. Requests still
+		 * holding a detail or body keep it; the next miss re-reads the file or re-renders the body.
+		 * @return The detail cache as it was before the flush.
+		 */
+		DetailCacheStats flush_caches();
 
 	private:
+		void preload_details(const tsl::robin_map<std::string, std::string>& show_file_map);
+		void insert_detail(const std::string& file_path, std::shared_ptr<const CachedDetail> detail); // requires cache_mutex_
+		std::shared_ptr<const CachedBody> find_overlay_body(uint64_t key, uint64_t base_generation); // requires cache_mutex_
+		void insert_overlay_body(uint64_t key, CachedCatalogBody body); // requires cache_mutex_
+		// Base catalog merged with @p overlay; requires state_mutex_.
+		std::vector<config::TagModelInfo> merged_models(const SessionOverlay* overlay) const;
+		const config::TagModelInfo* find_base_model(std::string_view model_name) const; // requires state_mutex_
+		void index_base_catalog(); // requires state_mutex_ held exclusively
+		bool add_overlay_model(std::string_view source, OverlayModel model);
+		std::shared_ptr<const ModelPayload> base_payload(const config::TagModelInfo& model); // requires state_mutex_
+
 		std::vector<config::TagModelInfo> available_models_;
-		std::vector<LoadedModelInfo> loaded_models_;
+		tsl::robin_map<std::string, size_t, utils::TransparentStringHash, utils::TransparentStringEqual>
+		base_index_; // available_models_ positions by name
 		tsl::robin_map<std::string, std::string> show_file_map_;
-		tsl::robin_map<std::string, nlohmann::ordered_json> show_cache_;
+		std::list<std::pair<std::string, std::shared_ptr<const CachedDetail>>> detail_lru_; // most recently used first
+		tsl::robin_map<std::string, decltype(detail_lru_)::iterator, utils::TransparentStringHash,
+		               utils::TransparentStringEqual> detail_index_;
+		size_t detail_cache_bytes_ = 0;
+		const size_t detail_cache_budget_;
+		std::list<std::pair<uint64_t, CachedCatalogBody>> overlay_body_lru_; // by overlay generation and view, most recently used first
+		tsl::robin_map<uint64_t, decltype(overlay_body_lru_)::iterator> overlay_body_index_;
+		size_t overlay_body_bytes_ = 0;
+		const size_t overlay_body_budget_;
+		mutable SessionOverlays overlays_;
+
+		uint64_t generation_ = 0; // bumped on every change to available_models_
+		std::atomic<uint64_t> revision_{0}; // bumped on every change to the base catalog or an overlay
+		std::array<CachedCatalogBody, catalog_view_count> catalog_bodies_; // for sources without catalog changes
+		tsl::robin_map<std::string, std::shared_ptr<const ModelPayload>, utils::TransparentStringHash,
+		               utils::TransparentStringEqual> base_payloads_; // base models copied so far, by name
+		const uint64_t instance_id_;
+		uint64_t config_fingerprint_ = 0;
 
-		mutable std::shared_mutex state_mutex_; // protects available_models_, show_file_map_, loaded_models_
-		std::mutex cache_mutex_;                // protects show_cache_
+		mutable std::shared_mutex state_mutex_; // protects available_models_, base_index_, show_file_map_, generation_, catalog_bodies_; taken before any overlay shard
+		std::mutex cache_mutex_;                // protects the detail and overlay body caches
+		std::mutex payload_mutex_;              // protects base_payloads_; taken under state_mutex_
 	};
 
 } // namespace honeypot::state
\ No newline at end of file
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "utils/config.hpp"
+
+namespace honeypot::state
+{
+	class HoneypotState;
+
+	/*
+	 * On-disk layout of a state snapshot.
+	 *
+	 * Same conventions as the other mapped formats: position independent, little-endian,
+	 * 8-byte aligned sections addressed by offset. Strings live in one blob and are referenced
+	 * by (offset, length). The payload checksum guards against partially written files.
+	 *
+	 * The models section holds the base catalog first, then every overlay's added models.
+	 * Expiry and last-seen times are wall-clock Unix milliseconds so they survive a restart.
+	 */
+	inline constexpr char snapshot_magic[8] = {'H', 'P', 'S', 'T', 'A', 'T', 'E', '\0'};
+	inline constexpr uint32_t snapshot_format_version = 2;
+	inline constexpr uint32_t snapshot_endian_tag = 0x01020304;
+
+	struct SnapshotString
+	{
+		uint32_t offset;
+		uint32_t length;
+	};
+
+	struct SnapshotHeader
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t endian_tag;
+		uint64_t file_size;
+		uint64_t checksum;           // fnv1a_64 of everything after the header
+		int64_t saved_at_unix_ms;
+		uint64_t config_fingerprint; // catalog in the config file when the snapshot was taken
+		uint64_t generation;
+		uint32_t base_model_count;   // models[0, base_model_count) are the base catalog
+		uint32_t model_count;
+		uint32_t family_count;
+		uint32_t show_entry_count;
+		uint32_t overlay_count;
+		uint32_t deleted_count;
+		uint32_t loaded_count;
+		uint32_t reserved;
+		uint64_t models_offset;       // SnapshotModel[model_count]
+		uint64_t families_offset;     // SnapshotString[family_count]
+		uint64_t show_entries_offset; // SnapshotShowEntry[show_entry_count]
+		uint64_t overlays_offset;     // SnapshotOverlay[overlay_count]
+		uint64_t deleted_offset;      // SnapshotString[deleted_count]
+		uint64_t loaded_offset;       // SnapshotLoadedModel[loaded_count]
+		uint64_t strings_offset;
+		uint64_t strings_size;
+	};
+
+	struct SnapshotModel
+	{
+		SnapshotString name;
+		SnapshotString model;
+		SnapshotString modified_at;
+		SnapshotString digest;
+		SnapshotString format;
+		SnapshotString family;
+		SnapshotString parent_model;
+		SnapshotString parameter_size;
+		SnapshotString quantization_level;
+		SnapshotString detail_path; // overlay models only
+		uint64_t size;
+		uint32_t families_begin;
+		uint32_t families_count; // UINT32_MAX when the model has no families list
+	};
+
+	struct SnapshotOverlay
+	{
+		SnapshotString source;
+		int64_t last_seen_unix_ms;
+		uint32_t deleted_begin; // into the deleted names
+		uint32_t deleted_count;
+		uint32_t added_begin;   // into the models, at or after base_model_count
+		uint32_t added_count;
+		uint32_t loaded_begin;  // into the loaded models
+		uint32_t loaded_count;
+	};
+
+	struct SnapshotLoadedModel
+	{
+		SnapshotString name; // resolved against the owning overlay's view of the catalog
+		int64_t expires_at_unix_ms;
+		uint64_t size_vram;
+	};
+
+	struct SnapshotShowEntry
+	{
+		SnapshotString model_name;
+		SnapshotString path;
+	};
+
+	static_assert(sizeof(SnapshotHeader) == 152);
+	static_assert(sizeof(SnapshotModel) == 96);
+	static_assert(sizeof(SnapshotOverlay) == 40);
+	static_assert(sizeof(SnapshotLoadedModel) == 24);
+	static_assert(sizeof(SnapshotShowEntry) == 16);
+
+	/**
+	 * @brief Restores HoneypotState from its snapshot file on construction and keeps the file
+	 * current from a background thread.
+	 *
+	 * The thread wakes every interval and, if the state's revision moved, encodes a snapshot
+	 * (holding the state's shared lock only while copying) and replaces the file via a
+	 * temporary file and rename. A final snapshot is written on destruction.
+	 */
+	class StateSnapshotter
+	{
+	public:
+		StateSnapshotter(std::shared_ptr<HoneypotState> state, const config::SnapshotConfig& config);
+		~StateSnapshotter();
+		StateSnapshotter(const StateSnapshotter&) = delete;
+		StateSnapshotter& operator=(const StateSnapshotter&) = delete;
+
+		/**
+		 * @brief Writes a snapshot now if the state changed since the last one.
+		 * @return true if a file was written.
+		 */
+		bool write_if_changed();
+
+		/**
+		 * @brief Writes a snapshot now, changed or not. Safe to call from any thread.
+		 * @return false if snapshots are disabled or the write failed.
+		 */
+		bool write_now();
+
+	private:
+		bool write(bool force);
+		void run();
+
+		std::shared_ptr<HoneypotState> state_;
+		config::SnapshotConfig config_;
+		std::mutex write_mutex_; // serializes writes; guards written_revision_
+		uint64_t written_revision_ = UINT64_MAX;
+
+		std::mutex mutex_;
+		std::condition_variable wake_;
+		bool stopping_ = false;
+		std::thread thread_;
+	};
+} // namespace honeypot::state
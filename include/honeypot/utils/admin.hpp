@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace honeypot::utils
+{
+	/*
+	 * Wire format of the admin socket: the client sends one command per line, "<name>" or
+	 * "<name> <argument>", and gets one line of compact JSON back for each, either
+	 * {"ok":true,"result":...} or {"ok":false,"error":"..."}. A connection may send any number of
+	 * commands; lines longer than admin_max_line_bytes close it.
+	 */
+	inline constexpr size_t admin_max_line_bytes = 4096;
+
+	/**
+	 * @brief Local control plane on a Unix domain socket, apart from the attacker-facing app.
+	 *
+	 * One thread accepts clients and runs their commands in order, so a slow command only delays
+	 * other admin clients. Commands must read state the way the snapshot writer does (shared or
+	 * per-shard locks held only while copying), never anything a request waits on for long. The
+	 * socket file is created owner-only.
+	 */
+	class AdminServer
+	{
+	public:
+		/**
+		 * @brief Runs a command; the return value becomes "result". Throwing reports the
+		 * exception's message as "error".
+		 */
+		using Handler = std::function<nlohmann::json(std::string_view argument)>;
+
+		/**
+		 * @param socket_path Filesystem path to listen on; a stale socket file is replaced.
+		 * @throws std::runtime_error if the socket cannot be created.
+		 */
+		explicit AdminServer(std::string socket_path);
+		~AdminServer();
+		AdminServer(const AdminServer&) = delete;
+		AdminServer& operator=(const AdminServer&) = delete;
+
+		/**
+		 * @brief Registers @p name. Must be called before start(); "help" is built in.
+		 */
+		void on_command(std::string name, std::string usage, Handler handler);
+
+		void start();
+
+		const std::string& socket_path() const { return socket_path_; }
+
+	private:
+		struct Command
+		{
+			std::string name;
+			std::string usage;
+			Handler handler;
+		};
+
+		struct Client
+		{
+			int fd = -1;
+			std::string input;
+			std::string output; // replies the socket has not taken yet
+			bool reading = true; // false once the client shut down its sending side
+		};
+
+		void run();
+		void accept_clients();
+		// Runs the complete lines in the client's input; false once the client must be closed.
+		bool serve(Client& client);
+		// Sends what the socket takes without blocking; false once the client is gone or, having
+		// shut down its side, has all its replies.
+		bool flush(Client& client);
+		std::string execute(std::string_view line) const;
+
+		const std::string socket_path_;
+		int listen_fd_ = -1;
+		int wake_fds_[2] = {-1, -1};
+		std::vector<Command> commands_;
+		std::vector<std::unique_ptr<Client>> clients_; // only touched by the I/O thread
+		std::atomic<bool> stopping_{false};
+		std::thread io_thread_;
+	};
+} // namespace honeypot::utils
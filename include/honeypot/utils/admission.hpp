@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include <crow.h>
+#include <tsl/robin_map.h>
+
+#include "utils/config.hpp"
+#include "utils/hash.hpp"
+
+namespace honeypot::utils
+{
+	/**
+	 * @brief Decides in the request middleware whether a request is served or shed.
+	 *
+	 * Load is measured two ways: the in-process queueing delay of the Crow workers, sampled by
+	 * posting a probe to the request's io_context and timing how long it waits behind queued
+	 * handlers, and the number of requests currently in handlers. While either is past its
+	 * threshold, low-value requests (from tarpit-flagged sources, or repeating a method and path
+	 * the source already sent within the repeat window) get a prebuilt 503 instead of a handler.
+	 * Sources that generated text within the conversation window are always served.
+	 */
+	class AdmissionController
+	{
+	public:
+		enum class Decision : uint8_t
+		{
+			uncounted, // served, not counted in flight (disabled, or a tarpit-held source)
+			counted,   // served and counted in flight until release()
+			shed,      // answered with the busy response, no handler ran
+		};
+
+		struct Stats
+		{
+			uint64_t admitted = 0;
+			uint64_t shed_flagged = 0;
+			uint64_t shed_repeated = 0;
+			uint64_t overload_episodes = 0;
+			uint64_t queue_delay_us = 0; // smoothed
+			uint64_t in_flight = 0;
+		};
+
+		explicit AdmissionController(const config::AdmissionConfig& config);
+
+		/**
+		 * @brief Admits or sheds @p req. @p flagged is whether the tarpit is holding its source.
+		 * A shed request has @p res completed with the busy response.
+		 */
+		Decision admit(const crow::request& req, crow::response& res, bool flagged);
+
+		/**
+		 * @brief Called once the response of an admitted request is complete; successful
+		 * generation requests mark their source as mid-conversation.
+		 */
+		void release(const crow::request& req, const crow::response& res, Decision decision);
+
+		Stats stats() const;
+		bool enabled() const { return config_.enabled; }
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		struct Shard
+		{
+			std::mutex mutex;
+			tsl::robin_map<std::string, Clock::time_point, TransparentStringHash, TransparentStringEqual>
+			conversations; // source -> end of its conversation window
+		};
+
+		static constexpr size_t shard_count = 64;
+		static constexpr size_t max_conversations_per_shard = 4096;
+		static constexpr size_t repeat_slots = 1 << 16;
+		static constexpr std::chrono::milliseconds probe_interval{10};
+
+		void sample_queue_delay(const crow::request& req, Clock::time_point now);
+		bool overloaded(Clock::time_point now);
+		bool is_repeat(const crow::request& req, Clock::time_point now);
+		bool in_conversation(std::string_view source_ip, Clock::time_point now);
+		void note_conversation(std::string_view source_ip, Clock::time_point now);
+
+		config::AdmissionConfig config_;
+		const Clock::time_point epoch_;
+
+		std::atomic<int64_t> next_probe_ns_{0};
+		std::atomic<uint64_t> queue_delay_ns_{0}; // EWMA of probe delays
+		std::atomic<uint64_t> in_flight_{0};
+
+		// Direct-mapped, lossy: each slot holds a request fingerprint's high bits and when it was seen.
+		std::unique_ptr<std::atomic<uint64_t>[]> repeat_slots_;
+		std::array<Shard, shard_count> shards_;
+
+		std::atomic<bool> overloaded_{false};
+		std::atomic<uint64_t> admitted_{0};
+		std::atomic<uint64_t> shed_flagged_{0};
+		std::atomic<uint64_t> shed_repeated_{0};
+		std::atomic<uint64_t> overload_episodes_{0};
+
+		std::mutex transition_mutex_; // serializes overload transitions and guards the two fields below
+		uint64_t shed_at_overload_start_ = 0;
+		Clock::time_point overload_started_{};
+	};
+
+	void init_admission(const config::HoneypotConfig& config);
+	AdmissionController& get_admission();
+} // namespace honeypot::utils
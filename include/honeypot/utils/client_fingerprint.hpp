@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include <crow.h>
+
+#include "utils/hash.hpp"
+
+namespace honeypot::utils
+{
+	/**
+	 * @brief Short HTTP client fingerprint in the spirit of JA4H, e.g. "po11o07_4c1f0e9a2b73_9d04e1c2_5a7be013".
+	 *
+	 * The prefix is readable: method (two letters), HTTP version, 'o' when header names were hashed
+	 * in arrival order or 's' when only Crow's unordered header map was available and they were
+	 * sorted first, and the header count. Then three hashes: of the lowercased header names in that
+	 * order, of their casing, and of the Accept value plus the User-Agent's product name. Only
+	 * fingerprints with the same order flag are comparable.
+	 *
+	 * The fingerprint is stored inline; building one allocates nothing.
+	 */
+	class ClientFingerprint
+	{
+	public:
+		static constexpr size_t max_length = 40;
+
+		/**
+		 * @brief Streams header fields, in the order the client sent them, into fixed-size hashes.
+		 */
+		class Builder
+		{
+		public:
+			void add_header(std::string_view name, std::string_view value);
+
+			/**
+			 * @param method Request method as sent, e.g. "GET".
+			 * @param version Request version as sent, e.g. "HTTP/1.1".
+			 * @param arrival_order Whether add_header() saw the headers in arrival order.
+			 */
+			ClientFingerprint finish(std::string_view method, std::string_view version, bool arrival_order) const;
+
+		private:
+			uint64_t names_ = fnv1a_offset_basis;
+			uint64_t casing_ = fnv1a_offset_basis;
+			uint64_t accept_ = 0;
+			uint64_t user_agent_family_ = 0;
+			bool has_accept_ = false;
+			bool has_user_agent_ = false;
+			uint32_t count_ = 0;
+		};
+
+		ClientFingerprint() = default;
+
+		/**
+		 * @brief Fingerprints a request as Crow parsed it. Crow keeps headers in a hash map, so the
+		 * names are sorted rather than in arrival order.
+		 */
+		static ClientFingerprint of_request(const crow::request& req);
+
+		/**
+		 * @brief Reads a fingerprint produced elsewhere (the fast path forwards its own); empty if
+		 * @p text is not one.
+		 */
+		static ClientFingerprint parse(std::string_view text);
+
+		std::string_view view() const { return {text_.data(), size_}; }
+		bool empty() const { return size_ == 0; }
+
+	private:
+		std::array<char, max_length> text_{};
+		uint8_t size_ = 0;
+	};
+} // namespace honeypot::utils
@@ -35,14 +35,34 @@ namespace honeypot::config
     void to_json(nlohmann::ordered_json& j, const TagModelInfo& p);
     void from_json(const nlohmann::ordered_json& j, TagModelInfo& p);
 
+    struct ListenerConfig
+    {
+        std::string address = "0.0.0.0";
+        uint16_t port = 11434;
+        std::string name{};           // tag in request records, empty = "address:port"
+        std::string ollama_version{}; // what /api/version reports on this listener, empty = api_behavior.ollama_version
+    };
+    void to_json(nlohmann::ordered_json& j, const ListenerConfig& p);
+    void from_json(const nlohmann::ordered_json& j, ListenerConfig& p);
+
     struct ServerConfig
     {
         std::string listen_address = "0.0.0.0";
         uint16_t listen_port = 11434;
+        std::vector<ListenerConfig> listeners{}; // if set, replaces listen_address/listen_port; served by the front listener
     };
     void to_json(nlohmann::ordered_json& j, const ServerConfig& p);
     void from_json(const nlohmann::ordered_json& j, ServerConfig& p);
 
+    struct FastPathConfig
+    {
+        bool enabled = false;
+        uint16_t backend_port = 11435; // Crow's loopback port while the fast path owns the public one
+        uint32_t threads = 2;
+    };
+    void to_json(nlohmann::ordered_json& j, const FastPathConfig& p);
+    void from_json(const nlohmann::ordered_json& j, FastPathConfig& p);
+
     struct LoggingConfig
     {
         std::string log_level = "info";
@@ -50,6 +70,11 @@ namespace honeypot::config
         std::string log_file_path = "honeypot_operational.log";
         std::string log_pattern = "[%Y-%m-%d %H:%M:%S.%e] [%^%l%$] [%t] %v";
         std::string request_log_path = "honeypot_requests.jsonl";
+        std::string ip_index_path{}; // compiled IP range index relative to config/, empty = no enrichment
+        uint32_t collapse_window_seconds = 0; // identical requests from a source within this window become one record, 0 = off
+        std::string event_socket_path{};      // owner-only Unix socket streaming request records to local consumers, empty = off
+        uint64_t event_buffer_bytes = 4ULL << 20; // per-consumer queue; frames that do not fit are dropped
+        std::string prompt_signatures_path{}; // prompt signature set relative to config/, empty = bodies are not tagged
     };
     void to_json(nlohmann::ordered_json& j, const LoggingConfig& p);
     void from_json(const nlohmann::ordered_json& j, LoggingConfig& p);
@@ -59,15 +84,99 @@ namespace honeypot::config
         std::string ollama_version = "0.6.0";
         std::vector<TagModelInfo> tag_models{};
         tsl::robin_map<std::string, std::string> show_file_map{};
+        std::string response_template_dir{}; // relative to config/, empty = built-in templates
+        std::string text_model_path{};       // compiled n-gram model relative to config/, empty = disabled
+        std::string catalog_dir{};           // per-model *.manifest files relative to config/, empty = tag_models only
+        uint64_t detail_cache_bytes = 64ULL << 20; // budget for parsed /api/show details, least recently used evicted first
+        uint64_t catalog_cache_bytes = 16ULL << 20; // budget for catalog bodies of sources with their own catalog, LRU as above
     };
     void to_json(nlohmann::ordered_json& j, const ApiBehaviorConfig& p);
     void from_json(const nlohmann::ordered_json& j, ApiBehaviorConfig& p);
 
+    struct LatencyConfig
+    {
+        bool enabled = true;
+        double jitter = 0.15;                 // relative spread applied to every simulated duration
+        double memory_bandwidth_gbps = 400.0; // token generation is bound by reading the weights once per token
+        double prompt_speedup = 25.0;         // prompt evaluation throughput relative to generation
+        double load_bandwidth_mbps = 2000.0;  // disk-to-VRAM rate for cold loads
+        uint32_t load_overhead_ms = 400;      // fixed cold load cost (runner start, context allocation)
+        uint32_t warm_load_ms = 15;           // load_duration reported when the model is already resident
+    };
+    void to_json(nlohmann::ordered_json& j, const LatencyConfig& p);
+    void from_json(const nlohmann::ordered_json& j, LatencyConfig& p);
+
+    struct TarpitConfig
+    {
+        bool enabled = false;
+        uint32_t window_seconds = 60;
+        uint32_t max_requests_per_window = 300; // sources above this rate are flagged hostile
+        uint32_t flag_seconds = 900;            // how long a flag lasts after the last offence
+        uint32_t initial_hold_ms = 2000;        // hold for a freshly flagged source, doubled per repeat offence
+        uint32_t max_hold_ms = 120000;
+        uint32_t max_held_connections = 100000; // beyond this, flagged sources are served normally
+    };
+    void to_json(nlohmann::ordered_json& j, const TarpitConfig& p);
+    void from_json(const nlohmann::ordered_json& j, TarpitConfig& p);
+
+    struct AdmissionConfig
+    {
+        bool enabled = false;
+        uint32_t max_queue_delay_ms = 50;    // worker run-queue delay above which low-value requests are shed
+        uint32_t max_in_flight = 4096;       // requests being handled (tarpit holds excluded) above which the same applies
+        uint32_t repeat_window_seconds = 60; // a request repeating this source's method and path within this is a repeat
+        uint32_t conversation_seconds = 300; // sources that generated within this are never shed
+    };
+    void to_json(nlohmann::ordered_json& j, const AdmissionConfig& p);
+    void from_json(const nlohmann::ordered_json& j, AdmissionConfig& p);
+
+    struct SnapshotConfig
+    {
+        bool enabled = true;
+        std::string path = "honeypot_state.snapshot"; // relative to the working directory, like the logs
+        uint32_t interval_seconds = 30;               // how often a changed state is written out
+    };
+    void to_json(nlohmann::ordered_json& j, const SnapshotConfig& p);
+    void from_json(const nlohmann::ordered_json& j, SnapshotConfig& p);
+
+    struct SessionConfig
+    {
+        uint32_t ttl_seconds = 3600;   // a source's overlay is dropped after this long without requests
+        uint32_t max_sessions = 50000; // beyond this, the least recently seen overlays are evicted
+    };
+    void to_json(nlohmann::ordered_json& j, const SessionConfig& p);
+    void from_json(const nlohmann::ordered_json& j, SessionConfig& p);
+
+    struct TracingConfig
+    {
+        bool enabled = false;
+        double sample_rate = 0.01;                     // fraction of requests whose phases are traced
+        uint32_t spans_per_thread = 16384;             // ring size per thread, rounded up to a power of two
+        std::string dump_path = "honeypot_trace.json"; // written on SIGUSR2
+    };
+    void to_json(nlohmann::ordered_json& j, const TracingConfig& p);
+    void from_json(const nlohmann::ordered_json& j, TracingConfig& p);
+
+    struct AdminConfig
+    {
+        std::string socket_path{}; // Unix socket for the local control plane, empty = off
+    };
+    void to_json(nlohmann::ordered_json& j, const AdminConfig& p);
+    void from_json(const nlohmann::ordered_json& j, AdminConfig& p);
+
     struct HoneypotConfig
     {
         ServerConfig server{};
+        FastPathConfig fast_path{};
         LoggingConfig logging{};
         ApiBehaviorConfig api_behavior{};
+        LatencyConfig latency{};
+        TarpitConfig tarpit{};
+        AdmissionConfig admission{};
+        SnapshotConfig snapshot{};
+        SessionConfig sessions{};
+        TracingConfig tracing{};
+        AdminConfig admin{};
     };
     void to_json(nlohmann::ordered_json& j, const HoneypotConfig& p);
     void from_json(const nlohmann::ordered_json& j, HoneypotConfig& p);
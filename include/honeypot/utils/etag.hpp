@@ -0,0 +1,32 @@
+#pragma once
+
+#include <crow.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace honeypot::utils
+{
+	/**
+	 * @brief Formats a strong entity tag (quoted, no W/ prefix) from a 64-bit value.
+	 * @param prefix Short discriminator so tags from different resources never collide.
+	 */
+	std::string make_strong_etag(std::string_view prefix, uint64_t value);
+
+	/**
+	 * @brief Evaluates an If-None-Match header value against the current entity tag.
+	 * Uses the weak comparison required by RFC 9110 for If-None-Match and accepts '*'.
+	 */
+	bool if_none_match_hits(std::string_view if_none_match, std::string_view etag);
+
+	/**
+	 * @brief Returns true if @p req carries an If-None-Match header matching @p etag.
+	 */
+	bool request_matches_etag(const crow::request& req, std::string_view etag);
+
+	/**
+	 * @brief Builds an empty 304 Not Modified response carrying @p etag.
+	 */
+	crow::response make_not_modified(std::string_view etag);
+} // namespace honeypot::utils
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace honeypot::utils
+{
+	/*
+	 * Wire format of the request event stream: a sequence of frames on a Unix stream socket,
+	 * each a 4-byte little-endian payload length followed by one request record (compact JSON,
+	 * no trailing newline). Consumers only read; anything they send is discarded.
+	 */
+	inline constexpr size_t event_frame_header_bytes = 4;
+
+	/**
+	 * @brief Publishes request records to local consumers connected to a Unix domain socket.
+	 *
+	 * Every consumer has its own ring buffer. publish() copies the frame into each ring under
+	 * that consumer's lock and never touches a socket, so request threads never wait for a
+	 * consumer; a frame that does not fit is dropped for that consumer and counted. One I/O
+	 * thread accepts consumers and drains the rings with non-blocking sends.
+	 */
+	class EventStream
+	{
+	public:
+		/**
+		 * @param socket_path Filesystem path to listen on; a stale socket file is replaced.
+		 * @param buffer_bytes Ring buffer size per consumer.
+		 * @throws std::runtime_error if the socket cannot be created.
+		 */
+		EventStream(std::string socket_path, size_t buffer_bytes);
+		~EventStream();
+		EventStream(const EventStream&) = delete;
+		EventStream& operator=(const EventStream&) = delete;
+
+		void publish(std::string_view record);
+
+		uint64_t frames_dropped() const { return frames_dropped_.load(std::memory_order_relaxed); }
+		size_t consumer_count() const;
+
+	private:
+		struct Consumer
+		{
+			explicit Consumer(int fd, size_t capacity) : fd(fd), ring(capacity) {}
+
+			const int fd;
+			std::mutex mutex;
+			std::vector<char> ring;
+			size_t head = 0; // next byte to send
+			size_t size = 0; // bytes queued
+			uint64_t frames_sent = 0;
+			uint64_t frames_dropped = 0;
+
+			bool push(std::string_view header, std::string_view payload);
+		};
+
+		void run();
+		void accept_consumers();
+		// Sends what the socket takes without blocking; false once the consumer is gone.
+		bool drain(Consumer& consumer);
+		void wake();
+		void close_consumer(const std::shared_ptr<Consumer>& consumer);
+
+		const std::string socket_path_;
+		const size_t buffer_bytes_;
+		int listen_fd_ = -1;
+		int wake_fds_[2] = {-1, -1};
+
+		mutable std::shared_mutex consumers_mutex_; // guards the list; each consumer guards its ring
+		std::vector<std::shared_ptr<Consumer>> consumers_;
+		std::atomic<uint64_t> frames_dropped_{0};
+		std::atomic<bool> stopping_{false};
+		std::thread io_thread_;
+	};
+} // namespace honeypot::utils
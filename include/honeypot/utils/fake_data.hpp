@@ -1,16 +1,27 @@
 #pragma once
 #include <nlohmann/json_fwd.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
 #include <string_view>
 #include <vector>
 
+#include "utils/ngram_model.hpp"
+#include "utils/response_templates.hpp"
+
 namespace honeypot::config
 {
 	struct TagModelInfo;
+	struct HoneypotConfig;
 }
 
 namespace honeypot::utils::fake_data
 {
-	nlohmann::ordered_json generate_error(std::string_view message);
+	/**
+	 * @brief Serializes Ollama's error object, {"error": message}. Built in the request arena, so the
+	 * returned body is the only heap allocation.
+	 */
+	std::string generate_error_body(std::string_view message);
 
 	nlohmann::ordered_json generate_ok_status();
 
@@ -23,13 +34,110 @@ namespace honeypot::utils::fake_data
 		const std::vector<config::TagModelInfo>& tag_models
 	);
 
+	/**
+	 * @brief Serializes the catalog as Ollama's OpenAI-compatible /v1/models list.
+	 */
+	std::string generate_openai_model_list(const std::vector<config::TagModelInfo>& tag_models);
+
+	/**
+	 * @brief Appends a unit-length embedding of @p dimensions floats as a JSON array to @p out.
+	 * The vector is derived from a hash of @p input, so equal inputs embed identically.
+	 */
+	void generate_embedding(std::string& out, std::string_view input, size_t dimensions);
+
+	/**
+	 * @brief A 64-hex-digit digest in the form Ollama reports (without the "sha256:" prefix),
+	 * derived from @p content so equal content gets equal digests.
+	 */
+	std::string generate_digest(std::string_view content);
+
+	/**
+	 * @brief Appends @p text to @p out escaped as JSON string contents (no surrounding quotes).
+	 */
+	void append_json_escaped(std::string& out, std::string_view text);
+
+	/**
+	 * @brief Current UTC time in RFC 3339 with nanoseconds, as Ollama emits in created_at.
+	 */
+	std::string generate_timestamp_iso8601();
+
+	/**
+	 * @brief Appends one streaming /api/generate NDJSON line ("done": false) to @p out.
+	 * Written directly as text so per-chunk cost is a handful of appends.
+	 */
+	void generate_completion_chunk(std::string& out, std::string_view model, std::string_view created_at,
+	                               std::string_view response_piece);
+
+	/**
+	 * @brief Appends one streaming /api/chat NDJSON line ("done": false) to @p out.
+	 */
+	void generate_chat_chunk(std::string& out, std::string_view model, std::string_view created_at,
+	                         std::string_view content_piece);
+
+	/**
+	 * @brief Appends one streaming /api/create NDJSON status line ({"status": ...}) to @p out.
+	 */
+	void generate_create_status_chunk(std::string& out, std::string_view status);
+
+	/**
+	 * @brief Timing and token counters reported in the final line of a generation.
+	 * Durations are in nanoseconds, as Ollama reports them.
+	 */
+	struct GenerationStats
+	{
+		uint64_t total_duration = 0;
+		uint64_t load_duration = 0;
+		uint64_t prompt_eval_count = 0;
+		uint64_t prompt_eval_duration = 0;
+		uint64_t eval_count = 0;
+		uint64_t eval_duration = 0;
+	};
+
+	/**
+	 * @brief Appends the stats fields (with a leading comma) to a JSON object being written into @p out.
+	 */
+	void generate_final_stats(std::string& out, const GenerationStats& stats);
+
+	/**
+	 * @brief Maps api_behavior.text_model_path, if configured, as the shared n-gram model.
+	 * A missing or invalid model is logged and generation falls back to response templates.
+	 */
+	void init_text_model(const config::HoneypotConfig& config);
+
+	std::shared_ptr<const NgramModel> get_text_model();
+
+	/**
+	 * @brief Yields response text piece by piece, the way a model streams tokens.
+	 * Backed by the shared n-gram model when one is loaded, otherwise by a rendered
+	 * response template split at word boundaries. Stops at the first sentence end after
+	 * @p target_pieces, and never later than @p max_pieces.
+	 */
+	class TextPieceSource
+	{
+	public:
+		TextPieceSource(TemplateKind kind, std::string_view model, std::string_view prompt, uint64_t seed,
+		                uint32_t target_pieces, uint32_t max_pieces);
+
+		/**
+		 * @brief Next piece, or an empty view once the response is complete.
+		 * The view is valid until the next call.
+		 */
+		std::string_view next();
+
+		uint32_t pieces_emitted() const { return emitted_; }
+
+	private:
+		std::shared_ptr<const NgramModel> ngram_;
+		NgramStream stream_{};
+		std::string text_;
+		size_t text_pos_ = 0;
+		uint32_t emitted_ = 0;
+		uint32_t target_pieces_;
+		uint32_t max_pieces_;
+		bool finished_ = false;
+	};
+
 	// TODO: generate_ps_list_json
-	// TODO: generate_embedding_response
-	// TODO: generate_completion_chunk
-	// TODO: generate_chat_chunk
-	// TODO: generate_final_stats
 	// TODO: generate_pull_progress_chunk
 	// TODO: generate_push_progress_chunk
-	// TODO: generate_create_status_chunk
-	// TODO: generate_timestamp_iso8601
 } // namespace honeypot::utils::fake_data
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <asio.hpp>
+#include <crow.h>
+
+#include "utils/client_fingerprint.hpp"
+#include "utils/config.hpp"
+
+namespace honeypot::state
+{
+	class HoneypotState;
+}
+
+namespace honeypot::utils
+{
+	/**
+	 * @brief One public endpoint of the front listener, as request records and /api/version see it.
+	 */
+	struct ListenerIdentity
+	{
+		std::string name;           // "listener" tag of its request records
+		std::string ollama_version; // reported by /api/version
+	};
+
+	/**
+	 * @brief What the front listener knew about a request it forwarded to Crow.
+	 */
+	struct ForwardedRequest
+	{
+		ClientFingerprint fingerprint;              // empty if the request was not forwarded
+		const ListenerIdentity* listener = nullptr; // endpoint that accepted it; lives as long as the listener
+	};
+
+	/**
+	 * @brief Front listener that owns the public endpoints and answers GET /api/version and
+	 * GET /api/tags without going through Crow.
+	 *
+	 * It accepts on every server.listeners entry (or server.listen_address:listen_port) while Crow
+	 * moves to 127.0.0.1:fast_path.backend_port, so all endpoints share one state, one set of caches
+	 * and one request log. With fast_path.enabled, request heads are parsed just far enough to
+	 * recognise the hot routes; those are answered with prebuilt header blocks and bodies in a single
+	 * gather write and logged like any other request. Everything else (including any request after
+	 * the first forwarded one on a connection, which keeps pipelined responses in order) is proxied
+	 * to Crow with the client's address in peer_header, its fingerprint, taken here while the header
+	 * order is still known, in fingerprint_header, and the accepting endpoint in listener_header;
+	 * the middleware adopts them via adopt_forwarded_peer(). Those are only trusted alongside
+	 * secret_header carrying a random per-process value, and clients' own copies of all four are
+	 * stripped from every request, including those after a chunked body, which is relayed chunk by
+	 * chunk so the connection stays parsed.
+	 */
+	class FastPathListener
+	{
+	public:
+		static constexpr std::string_view peer_header = "X-Honeypot-Peer";
+		static constexpr std::string_view fingerprint_header = "X-Honeypot-Client";
+		static constexpr std::string_view listener_header = "X-Honeypot-Listener";
+		static constexpr std::string_view secret_header = "X-Honeypot-Forwarded";
+
+		FastPathListener(const config::HoneypotConfig& config, std::shared_ptr<state::HoneypotState> state);
+
+		/**
+		 * @brief Stops accepting and drops open connections.
+		 */
+		~FastPathListener();
+		FastPathListener(const FastPathListener&) = delete;
+		FastPathListener& operator=(const FastPathListener&) = delete;
+
+		/**
+		 * @brief Binds every public endpoint and starts the listener threads.
+		 * @throws std::system_error if an endpoint cannot be bound.
+		 */
+		void start();
+
+		/**
+		 * @brief Whether the front listener must run: for the fast path, or to serve several endpoints.
+		 */
+		static bool required(const config::HoneypotConfig& config);
+
+		const config::HoneypotConfig& config() const { return config_; }
+		const std::shared_ptr<state::HoneypotState>& state() const { return state_; }
+		bool answers_hot_routes() const { return config_.fast_path.enabled; }
+		const std::string& forward_secret() const { return forward_secret_; }
+
+		/**
+		 * @brief The endpoint at @p index in accept order, or nullptr.
+		 */
+		const ListenerIdentity* identity(size_t index) const;
+
+		struct Endpoint
+		{
+			Endpoint(asio::io_context& io_context, const config::ListenerConfig& listener, ListenerIdentity identity);
+
+			asio::ip::tcp::endpoint address;
+			ListenerIdentity identity;
+			std::string index;         // position in endpoints_, as forwarded in listener_header
+			std::string version_head;  // status line and headers up to (excluding) Date
+			std::string version_body;
+			asio::ip::tcp::acceptor acceptor;
+		};
+
+	private:
+		asio::awaitable<void> accept_loop(Endpoint& endpoint);
+
+		const config::HoneypotConfig& config_;
+		std::shared_ptr<state::HoneypotState> state_;
+		std::string forward_secret_; // proves to adopt_forwarded_peer() that a request came through here
+
+		asio::io_context io_context_;
+		std::vector<std::unique_ptr<Endpoint>> endpoints_; // stable addresses: connections keep references
+		std::vector<std::thread> threads_;
+	};
+
+	/**
+	 * @brief Replaces a forwarded request's loopback address with the client address the front
+	 * listener put in FastPathListener::peer_header and reads its fingerprint and endpoint from the
+	 * other headers, if FastPathListener::secret_header proves it was forwarded. The internal
+	 * headers are removed either way. No-op, returning an empty result, unless the front listener runs.
+	 */
+	ForwardedRequest adopt_forwarded_peer(crow::request& req);
+} // namespace honeypot::utils
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+namespace honeypot::utils
+{
+	inline constexpr uint64_t fnv1a_offset_basis = 0xcbf29ce484222325ULL;
+	inline constexpr uint64_t fnv1a_prime = 0x100000001b3ULL;
+
+	/**
+	 * @brief 64-bit FNV-1a over a byte range.
+	 * Pass a previous result as @p seed to hash several ranges as one stream.
+	 */
+	constexpr uint64_t fnv1a_64(const std::string_view data, uint64_t seed = fnv1a_offset_basis) noexcept
+	{
+		for (const char c : data)
+		{
+			seed ^= static_cast<unsigned char>(c);
+			seed *= fnv1a_prime;
+		}
+		return seed;
+	}
+
+	/**
+	 * @brief Transparent hash/equality pair so string-keyed maps can be probed with a
+	 * std::string_view without materializing a temporary std::string.
+	 */
+	struct TransparentStringHash
+	{
+		using is_transparent = void;
+
+		size_t operator()(const std::string_view s) const noexcept
+		{
+			return std::hash<std::string_view>{}(s);
+		}
+	};
+
+	struct TransparentStringEqual
+	{
+		using is_transparent = void;
+
+		bool operator()(const std::string_view lhs, const std::string_view rhs) const noexcept
+		{
+			return lhs == rhs;
+		}
+	};
+} // namespace honeypot::utils
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "utils/config.hpp"
+
+namespace honeypot::utils
+{
+	/*
+	 * On-disk layout of a compiled IP range index (produced by honeypot_ip_index_build).
+	 *
+	 * Like the n-gram model, the file is position independent, little-endian and 8-byte aligned
+	 * per section, and the server looks addresses up straight out of a read-only mapping.
+	 *
+	 * The index is a multibit trie with a stride of one byte, with leaf pushing, so every slot
+	 * is either a child node or a final answer. Nodes are bitmap-compressed (as in Poptrie):
+	 * children of a node are stored contiguously and found by popcount rank, and runs of equal
+	 * answers collapse into one leaf. IPv4 and IPv6 have separate roots, so an IPv4 lookup
+	 * touches at most four 80-byte nodes.
+	 */
+	inline constexpr char ip_index_magic[8] = {'H', 'P', 'I', 'P', 'I', 'D', 'X', '\0'};
+	inline constexpr uint32_t ip_index_format_version = 1;
+	inline constexpr uint32_t ip_index_endian_tag = 0x01020304;
+
+	struct IpIndexFileHeader
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t endian_tag;
+		uint32_t node_count;
+		uint32_t leaf_count;
+		uint32_t record_count;
+		uint32_t v4_root;
+		uint32_t v6_root;
+		uint32_t reserved;
+		uint64_t file_size;
+		uint64_t nodes_offset;   // IpIndexNode[node_count]
+		uint64_t leaves_offset;  // uint32_t[leaf_count]: 0 = no match, otherwise record index + 1
+		uint64_t records_offset; // IpIndexRecord[record_count]
+		uint64_t strings_offset; // organization names
+		uint64_t strings_size;
+	};
+
+	struct IpIndexNode
+	{
+		uint64_t child_bits[4]; // slot leads to a child node
+		uint64_t leaf_bits[4];  // slot starts a new run of equal leaves (never set on child slots)
+		uint32_t child_base;    // index of the first child
+		uint32_t leaf_base;     // index of the first leaf run
+		uint8_t child_rank[4];  // set child bits in the words before each word
+		uint8_t leaf_rank[4];   // same for leaf bits; keeps a lookup to one popcount per level
+	};
+
+	struct IpIndexRecord
+	{
+		uint32_t asn;
+		uint32_t organization_offset;
+		uint16_t organization_length;
+		char country[2]; // ISO 3166-1 alpha-2, "\0\0" when unknown
+	};
+
+	static_assert(sizeof(IpIndexFileHeader) == 88);
+	static_assert(sizeof(IpIndexNode) == 80);
+	static_assert(sizeof(IpIndexRecord) == 12);
+
+	/**
+	 * @brief What the index knows about an address. Views point into the mapping.
+	 */
+	struct IpInfo
+	{
+		uint32_t asn = 0;
+		std::string_view organization;
+		std::string_view country;
+	};
+
+	/**
+	 * @brief Read-only longest-prefix-match index backed by a memory mapping.
+	 * Safe to share between threads.
+	 */
+	class IpIndex
+	{
+	public:
+		/**
+		 * @brief Maps @p path and validates the header and section bounds.
+		 * @throws std::runtime_error if the file cannot be mapped or is not a valid index.
+		 */
+		static std::shared_ptr<const IpIndex> open(const std::string& path);
+
+		~IpIndex();
+		IpIndex(const IpIndex&) = delete;
+		IpIndex& operator=(const IpIndex&) = delete;
+
+		/**
+		 * @brief Looks up a textual IPv4 or IPv6 address (IPv4-mapped IPv6 counts as IPv4).
+		 */
+		std::optional<IpInfo> lookup(std::string_view address) const;
+
+		std::optional<IpInfo> lookup_v4(uint32_t address) const;
+		std::optional<IpInfo> lookup_v6(const std::array<uint8_t, 16>& address) const;
+
+		uint32_t node_count() const { return header_->node_count; }
+		uint32_t leaf_count() const { return header_->leaf_count; }
+		uint32_t record_count() const { return header_->record_count; }
+		size_t mapped_bytes() const { return size_; }
+
+	private:
+		IpIndex() = default;
+
+		std::optional<IpInfo> walk(uint32_t root, const uint8_t* bytes, size_t length) const;
+
+		const std::byte* data_ = nullptr;
+		size_t size_ = 0;
+		bool owns_mapping_ = false;
+		std::unique_ptr<std::byte[]> heap_copy_; // used where mmap is unavailable
+
+		const IpIndexFileHeader* header_ = nullptr;
+		const IpIndexNode* nodes_ = nullptr;
+		const uint32_t* leaves_ = nullptr;
+		const IpIndexRecord* records_ = nullptr;
+		const char* strings_ = nullptr;
+	};
+
+	/**
+	 * @brief Maps logging.ip_index_path, if configured, as the process-wide index.
+	 */
+	void init_ip_index(const config::HoneypotConfig& config);
+
+	/**
+	 * @brief Re-maps the configured index file; readers keep using the old mapping until they
+	 * next look an address up. Keeps the current index if the new file is invalid.
+	 * @return true if a new index was installed.
+	 */
+	bool reload_ip_index();
+
+	/**
+	 * @brief Looks @p address up in the current index; empty if there is no index or no match.
+	 * The returned views stay valid for the calling thread until its next lookup.
+	 */
+	std::optional<IpInfo> lookup_ip(std::string_view address);
+} // namespace honeypot::utils
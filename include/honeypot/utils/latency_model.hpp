@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <tsl/robin_map.h>
+
+#include "utils/config.hpp"
+#include "utils/hash.hpp"
+
+namespace honeypot::utils
+{
+	/**
+	 * @brief Nominal per-model costs derived from the advertised size and quantization.
+	 */
+	struct ModelTiming
+	{
+		double cold_load_ns = 0;
+		double prompt_ns_per_token = 0;
+		double eval_ns_per_token = 0;
+	};
+
+	/**
+	 * @brief Durations for one simulated request, in nanoseconds as Ollama reports them.
+	 */
+	struct SimulatedTiming
+	{
+		uint64_t load_duration = 0;
+		uint64_t prompt_eval_duration = 0;
+		uint64_t eval_duration = 0;
+
+		uint64_t total() const { return load_duration + prompt_eval_duration + eval_duration; }
+	};
+
+	/**
+	 * @brief Timing model for fake inference.
+	 *
+	 * Generation is treated as memory-bandwidth bound (every token reads the whole weight file
+	 * once), prompt evaluation as a fixed multiple faster, and a cold load as streaming the
+	 * weights from disk plus a fixed overhead. Weight size comes from the advertised
+	 * parameter_size and quantization_level, falling back to the catalog size.
+	 */
+	class LatencyModel
+	{
+	public:
+		/**
+		 * @brief Precomputes timings for every model in @p catalog, the base catalog as loaded by
+		 * state::load_model_catalog() (config tag_models plus manifests).
+		 */
+		LatencyModel(const config::LatencyConfig& config, const std::vector<config::TagModelInfo>& catalog);
+
+		/**
+		 * @brief Timing for @p model as a source sees it. Base models use their precomputed profile;
+		 * copies and creates, which list a different name or digest, are costed from their own
+		 * details. nullptr (a model that vanished mid-request) gets an 8B Q4_K_M profile.
+		 */
+		ModelTiming timing(const config::TagModelInfo* model) const;
+
+		/**
+		 * @brief Draws jittered durations for a request of the given size.
+		 */
+		SimulatedTiming simulate(const config::TagModelInfo* model, bool cold_load, uint64_t prompt_tokens,
+		                         uint64_t eval_tokens) const;
+
+		bool enabled() const { return config_.enabled; }
+
+		static ModelTiming compute_timing(const config::LatencyConfig& config, const config::ModelDetails& details,
+		                                  uint64_t size_bytes);
+
+	private:
+		struct CatalogTiming
+		{
+			std::string digest; // the profile only applies to this exact model
+			ModelTiming timing;
+		};
+
+		config::LatencyConfig config_;
+		ModelTiming default_timing_;
+		tsl::robin_map<std::string, CatalogTiming, TransparentStringHash, TransparentStringEqual> timings_;
+	};
+
+	void init_latency_model(const config::HoneypotConfig& config, const std::vector<config::TagModelInfo>& catalog);
+	const LatencyModel& get_latency_model();
+
+	/**
+	 * @brief Parses Ollama's parameter_size strings ("8.0B", "137M", "1.5T"); 0 if unparsable.
+	 */
+	double parse_parameter_count(std::string_view parameter_size);
+
+	/**
+	 * @brief Approximate bits per weight for a GGUF quantization level such as "Q4_K_M".
+	 */
+	double bits_per_weight(std::string_view quantization_level);
+} // namespace honeypot::utils
@@ -4,6 +4,7 @@
 #include <crow.h>
 
 #include <memory> // For std::shared_ptr
+#include <string_view>
 
 #include "utils/config.hpp"
 
@@ -14,5 +15,24 @@ namespace honeypot::utils
 
 	std::shared_ptr<spdlog::logger> get_operational_logger();
 
-	void log_request(const crow::request& req, const crow::response& res);
+	/**
+	 * @brief What the request path learned about a request beyond the request itself.
+	 */
+	struct RequestTags
+	{
+		std::string_view probe_class{};        // set for catch-all traffic
+		std::string_view client_fingerprint{}; // ClientFingerprint of its headers
+		std::string_view listener{};           // front-listener endpoint that accepted it
+	};
+
+	/**
+	 * @brief Appends one JSON line for the request, with its @p tags.
+	 */
+	void log_request(const crow::request& req, const crow::response& res, const RequestTags& tags = {});
+
+	/**
+	 * @brief Writes out request records still held back for collapsing and closes the event stream;
+	 * call before spdlog::shutdown().
+	 */
+	void shutdown_request_log();
 } // namespace honeypot::utils
\ No newline at end of file
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace honeypot::utils
+{
+	/*
+	 * On-disk layout of a compiled n-gram model (produced by honeypot_ngram_build).
+	 *
+	 * The file is position independent: every section is addressed by a byte offset from the
+	 * start of the file, all integers are little-endian and every section is 8-byte aligned.
+	 * The server maps the file read-only and samples straight out of the mapping.
+	 *
+	 * States are order-2 contexts (two previous tokens). Each edge stores the index of the
+	 * context it leads to, so generation never hashes; successors of a context are laid out
+	 * as a Walker alias table, which makes every sampling step O(1).
+	 */
+	inline constexpr char ngram_magic[8] = {'H', 'P', 'N', 'G', 'R', 'A', 'M', '\0'};
+	inline constexpr uint32_t ngram_format_version = 1;
+	inline constexpr uint32_t ngram_endian_tag = 0x01020304;
+
+	struct NgramFileHeader
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t endian_tag;
+		uint32_t token_count;
+		uint32_t context_count;
+		uint32_t edge_count;
+		uint32_t start_count;
+		uint64_t file_size;
+		uint64_t token_offsets_offset; // uint32_t[token_count + 1] into the string blob
+		uint64_t strings_offset;       // concatenated token text
+		uint64_t contexts_offset;      // NgramContext[context_count]
+		uint64_t edges_offset;         // NgramEdge[edge_count]
+		uint64_t starts_offset;        // uint32_t[start_count], contexts that begin a sentence
+	};
+
+	struct NgramContext
+	{
+		uint32_t token;      // last token of the context, emitted when the context is entered
+		uint32_t edge_begin;
+		uint32_t edge_count; // 0 marks a dead end (end of corpus)
+	};
+
+	struct NgramEdge
+	{
+		uint32_t threshold; // alias-table acceptance threshold scaled to 2^32
+		uint32_t alias;     // edge index (relative to edge_begin) used when rejected
+		uint32_t next_context;
+	};
+
+	static_assert(sizeof(NgramFileHeader) == 80);
+	static_assert(sizeof(NgramContext) == 12);
+	static_assert(sizeof(NgramEdge) == 12);
+
+	/**
+	 * @brief Per-stream generation state. Sixteen bytes, trivially copyable.
+	 */
+	struct NgramStream
+	{
+		uint32_t context = 0;
+		uint32_t emitted = 0;
+		uint64_t rng_state = 0;
+	};
+
+	/**
+	 * @brief Read-only view of a compiled n-gram model backed by a memory mapping.
+	 * Safe to share between threads; all mutable state lives in NgramStream.
+	 */
+	class NgramModel
+	{
+	public:
+		/**
+		 * @brief Maps @p path and validates the header and section bounds.
+		 * @throws std::runtime_error if the file cannot be mapped or is not a valid model.
+		 */
+		static std::shared_ptr<const NgramModel> open(const std::string& path);
+
+		~NgramModel();
+		NgramModel(const NgramModel&) = delete;
+		NgramModel& operator=(const NgramModel&) = delete;
+
+		/**
+		 * @brief Starts a stream at a random sentence-initial context derived from @p seed.
+		 */
+		NgramStream start(uint64_t seed) const;
+
+		/**
+		 * @brief Advances @p stream by one token and returns its text (with leading whitespace).
+		 * The view points into the mapping and stays valid for the model's lifetime.
+		 */
+		std::string_view next(NgramStream& stream) const;
+
+		uint32_t token_count() const { return header_->token_count; }
+		uint32_t context_count() const { return header_->context_count; }
+		size_t mapped_bytes() const { return size_; }
+
+	private:
+		NgramModel() = default;
+
+		std::string_view token_text(uint32_t token) const;
+
+		const std::byte* data_ = nullptr;
+		size_t size_ = 0;
+		bool owns_mapping_ = false;
+		std::unique_ptr<std::byte[]> heap_copy_; // used where mmap is unavailable
+
+		const NgramFileHeader* header_ = nullptr;
+		const uint32_t* token_offsets_ = nullptr;
+		const char* strings_ = nullptr;
+		uint32_t strings_bytes_ = 0; // string table size, validated at load
+		const NgramContext* contexts_ = nullptr;
+		const NgramEdge* edges_ = nullptr;
+		const uint32_t* starts_ = nullptr;
+	};
+} // namespace honeypot::utils
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace honeypot::utils
+{
+	/**
+	 * @brief A known scanner path and the class of probe it belongs to.
+	 *
+	 * Patterns match case-insensitively as prefixes of a path segment boundary ("/.env" also
+	 * matches "/app/.env.local"); a trailing '$' restricts the pattern to the whole rest of the path,
+	 * and a leading '^' to the start of the path ("^/console" matches "/console" but not
+	 * "/v1/console"), for names too generic to flag deeper in a legitimate URL.
+	 */
+	struct ProbePattern
+	{
+		std::string_view pattern;
+		std::string_view probe_class;
+	};
+
+	/**
+	 * @brief Compiled set of scanner path patterns.
+	 *
+	 * Patterns are compiled into a byte trie with sorted, contiguous edge lists. classify() walks
+	 * it from every segment start of the path and returns the class of the longest match, as a
+	 * view of static storage, so classifying never allocates.
+	 */
+	class ProbeClassifier
+	{
+	public:
+		explicit ProbeClassifier(std::span<const ProbePattern> patterns);
+
+		/**
+		 * @brief Classifies a request path (without query string).
+		 * @return The probe class, "root" for "/", or "unknown" if no pattern matches.
+		 */
+		std::string_view classify(std::string_view path) const;
+
+	private:
+		static constexpr uint32_t no_class = UINT32_MAX;
+
+		struct Node
+		{
+			uint32_t first_edge = 0;
+			uint32_t edge_count = 0;
+			uint32_t prefix_class = no_class; // pattern ends here, anything may follow
+			uint32_t exact_class = no_class;  // pattern ends here, nothing may follow
+			uint32_t root_prefix_class = no_class; // as prefix_class, only at the start of the path
+			uint32_t root_exact_class = no_class;  // as exact_class, only at the start of the path
+		};
+
+		struct Edge
+		{
+			char byte;
+			uint32_t child;
+		};
+
+		// Length of the longest match starting at path[0], with its class; anchored patterns
+		// only count when @p at_root.
+		std::pair<size_t, uint32_t> match_at(std::string_view path, bool at_root) const;
+
+		std::vector<Node> nodes_;
+		std::vector<Edge> edges_;
+		std::vector<std::string_view> classes_;
+	};
+
+	/**
+	 * @brief Built-in classifier covering common scanner and exploit paths.
+	 */
+	const ProbeClassifier& get_probe_classifier();
+
+	/**
+	 * @brief Whether @p probe_class is a built-in class no Ollama client has a reason to hit:
+	 * credential and source leaks, CMS and admin panels, and PHP or device exploits.
+	 */
+	bool is_exploit_probe(std::string_view probe_class);
+} // namespace honeypot::utils
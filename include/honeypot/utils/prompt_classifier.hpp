@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "utils/config.hpp"
+
+namespace honeypot::utils
+{
+	/**
+	 * @brief One prompt signature: a literal, or a restricted regular expression.
+	 *
+	 * The regex dialect has literals, '.', classes ("[a-z]", "[^0-9]", "\d", "\w", "\s" and their
+	 * negations), groups, '|', and the quantifiers '?', '*' and '+'. Anchors, counted repetition
+	 * and backreferences are rejected. Matching is ASCII case-insensitive and unanchored.
+	 */
+	struct PromptSignature
+	{
+		std::string category;
+		std::string expression;
+		bool literal = false;
+	};
+
+	/**
+	 * @brief Tags text with the categories of every signature it contains.
+	 *
+	 * All signatures are compiled into one DFA over byte equivalence classes, so a scan reads
+	 * each byte once, whatever the number of signatures. While the DFA is in its start state a
+	 * double-shufti prefilter (SSSE3 where the CPU has it) skips 16 bytes at a time to the next
+	 * position whose first two bytes can begin some signature.
+	 */
+	class PromptClassifier
+	{
+	public:
+		static constexpr size_t max_categories = 64;
+		static constexpr size_t max_states = 16384;
+
+		/**
+		 * @brief Compiles @p signatures.
+		 * @throws std::invalid_argument if a signature does not parse, matches the empty string,
+		 * or the set exceeds max_categories or max_states.
+		 */
+		explicit PromptClassifier(std::span<const PromptSignature> signatures);
+
+		/**
+		 * @brief Reads a signature file: {"signatures": [{"category", "literal" | "pattern"}, ...]}.
+		 * @throws std::runtime_error if the file cannot be read or parsed, std::invalid_argument
+		 * if the signatures do not compile.
+		 */
+		static std::shared_ptr<const PromptClassifier> load(const std::string& path);
+
+		/**
+		 * @brief Bit i is set if @p text contains a signature of category(i).
+		 */
+		uint64_t scan(std::string_view text) const;
+
+		std::string_view category(const size_t index) const { return categories_[index]; }
+		size_t category_count() const { return categories_.size(); }
+		size_t state_count() const { return state_count_; }
+		size_t class_count() const { return class_count_; }
+		size_t signature_count() const { return signature_count_; }
+		bool prefiltered() const { return prefilter_ != nullptr; }
+
+		/**
+		 * @brief Nibble tables of the prefilter: position i is a candidate if the buckets of
+		 * text[i] (first_lo/first_hi) and text[i + 1] (second_lo/second_hi) intersect.
+		 */
+		struct PrefilterTables
+		{
+			alignas(16) std::array<uint8_t, 16> first_lo{};
+			alignas(16) std::array<uint8_t, 16> first_hi{};
+			alignas(16) std::array<uint8_t, 16> second_lo{};
+			alignas(16) std::array<uint8_t, 16> second_hi{};
+		};
+
+	private:
+		using Prefilter = size_t (*)(const PrefilterTables& tables, const uint8_t* data, size_t pos, size_t size);
+
+		std::vector<std::string> categories_;
+		std::array<uint8_t, 256> byte_class_{};
+		std::vector<uint32_t> transitions_;   // [state * class_count_ + class] = next state * class_count_
+		std::vector<uint64_t> accept_;        // category mask per accepting state, in state order
+		uint32_t start_ = 0;                  // premultiplied, like every state in transitions_
+		uint32_t first_accepting_ = 0;        // accepting states are numbered last
+		uint64_t all_categories_ = 0;
+		size_t class_count_ = 0;
+		size_t state_count_ = 0;
+		size_t signature_count_ = 0;
+		PrefilterTables prefilter_tables_{};
+		Prefilter prefilter_ = nullptr;
+	};
+
+	/**
+	 * @brief Compiles logging.prompt_signatures_path, if configured, as the process-wide classifier.
+	 */
+	void init_prompt_classifier(const config::HoneypotConfig& config);
+
+	/**
+	 * @brief Recompiles the configured signature file. Keeps the current classifier if the new
+	 * file does not load or compile.
+	 * @return true if a new classifier was installed.
+	 */
+	bool reload_prompt_classifier();
+
+	/**
+	 * @brief Names of the categories whose signatures occur in @p text; empty without a classifier.
+	 * The views stay valid until this thread next calls it.
+	 */
+	std::vector<std::string_view> classify_prompt(std::string_view text);
+} // namespace honeypot::utils
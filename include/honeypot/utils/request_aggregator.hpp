@@ -0,0 +1,99 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <crow.h>
+#include <nlohmann/json.hpp>
+#include <tsl/robin_map.h>
+
+namespace honeypot::utils
+{
+	/**
+	 * @brief Collapses repeated identical requests into one counted request-log record.
+	 *
+	 * Requests are fingerprinted by source, method, URL, headers (in any order), body and response
+	 * status. The first request of a fingerprint opens a window; repeats inside it only bump a
+	 * counter. Each thread counts into its own table, so recording takes only that thread's lock,
+	 * which the flusher touches once a second. The flusher takes every entry whose window has
+	 * closed, merges equal fingerprints across threads and emits one record per fingerprint with
+	 * count, first_seen and last_seen added.
+	 */
+	class RequestAggregator
+	{
+	public:
+		using Clock = std::chrono::system_clock;
+		using Emit = std::function<void(const nlohmann::json& record)>;
+
+		RequestAggregator(std::chrono::seconds window, Emit emit);
+
+		/**
+		 * @brief Stops the flusher and emits everything still pending.
+		 */
+		~RequestAggregator();
+		RequestAggregator(const RequestAggregator&) = delete;
+		RequestAggregator& operator=(const RequestAggregator&) = delete;
+
+		static uint64_t fingerprint(const crow::request& req, int status);
+
+		/**
+		 * @brief Counts one request. @p make_record builds its log record and is only called for
+		 * the first request of a window.
+		 */
+		template <typename MakeRecord>
+		void record(const uint64_t fingerprint, MakeRecord&& make_record)
+		{
+			const auto now = Clock::now();
+			if (!count_repeat(fingerprint, now))
+			{
+				open_window(fingerprint, now, std::forward<MakeRecord>(make_record)());
+			}
+		}
+
+		/**
+		 * @brief Emits entries whose window has closed, or all of them if @p everything is set.
+		 */
+		void flush(bool everything);
+
+	private:
+		struct Entry
+		{
+			nlohmann::json record;
+			Clock::time_point first_seen;
+			Clock::time_point last_seen;
+			uint64_t count = 0;
+		};
+
+		struct ThreadTable
+		{
+			std::mutex mutex;
+			tsl::robin_map<uint64_t, Entry> entries;
+		};
+
+		// Beyond this many open windows on one thread, new fingerprints are logged right away.
+		static constexpr size_t max_entries_per_thread = 16384;
+
+		ThreadTable& local_table();
+		bool count_repeat(uint64_t fingerprint, Clock::time_point now);
+		void open_window(uint64_t fingerprint, Clock::time_point now, nlohmann::json record);
+		void emit(Entry& entry) const;
+		void run();
+
+		const std::chrono::seconds window_;
+		const Emit emit_;
+
+		std::mutex tables_mutex_;
+		std::vector<std::unique_ptr<ThreadTable>> tables_; // one per thread that ever logged, never shrinks
+
+		std::mutex flusher_mutex_;
+		std::condition_variable wake_;
+		bool stopping_ = false;
+		std::thread flusher_;
+	};
+} // namespace honeypot::utils
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <memory_resource>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+#include <nlohmann/json.hpp>
+
+namespace honeypot::utils
+{
+	/**
+	 * @brief Opens the calling thread's request arena, a monotonic buffer that keeps its first
+	 * block between requests.
+	 *
+	 * Scopes nest; when the outermost one ends, everything allocated in the arena is released in
+	 * one reset. Arena objects must therefore be created and destroyed inside the same outermost
+	 * scope (in practice: locals declared after it), and a scope must not span an asynchronous
+	 * wait, since other requests run on the thread in between.
+	 */
+	class ArenaScope
+	{
+	public:
+		ArenaScope();
+		~ArenaScope();
+		ArenaScope(const ArenaScope&) = delete;
+		ArenaScope& operator=(const ArenaScope&) = delete;
+	};
+
+	/**
+	 * @brief The calling thread's arena while an ArenaScope is open, the heap otherwise.
+	 */
+	std::pmr::memory_resource* arena_resource() noexcept;
+
+	/**
+	 * @brief Allocator bound to the resource arena_resource() returned when it was constructed, so a
+	 * container frees into the memory it allocated from even if a scope opened or closed meanwhile.
+	 * Copies and rebinds share the resource, as with std::pmr::polymorphic_allocator.
+	 *
+	 * nlohmann::basic_json default-constructs a fresh allocator for each value it creates or destroys,
+	 * so ArenaJson values still have to be destroyed inside the scope they were built in; debug builds
+	 * assert that nothing allocated in an arena is still live when its outermost scope ends.
+	 */
+	template <typename T>
+	class ArenaAllocator
+	{
+	public:
+		using value_type = T;
+
+		ArenaAllocator() noexcept
+			: resource_(arena_resource())
+		{
+		}
+
+		template <typename U>
+		ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+			: resource_(other.resource())
+		{
+		}
+
+		T* allocate(const size_t n)
+		{
+			return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
+		}
+
+		void deallocate(T* p, const size_t n) noexcept
+		{
+			resource_->deallocate(p, n * sizeof(T), alignof(T));
+		}
+
+		std::pmr::memory_resource* resource() const noexcept { return resource_; }
+
+		template <typename U>
+		bool operator==(const ArenaAllocator<U>& other) const noexcept
+		{
+			return resource_ == other.resource();
+		}
+
+	private:
+		std::pmr::memory_resource* resource_;
+	};
+
+	using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+	/**
+	 * @brief nlohmann::json whose nodes and strings live in the request arena.
+	 */
+	using ArenaJson = nlohmann::basic_json<std::map, std::vector, ArenaString, bool, std::int64_t, std::uint64_t,
+	                                       double, ArenaAllocator>;
+
+	/**
+	 * @brief fmt::format into an ArenaString.
+	 */
+	template <typename... Args>
+	ArenaString arena_format(fmt::format_string<Args...> format, Args&&... args)
+	{
+		ArenaString out;
+		fmt::format_to(std::back_inserter(out), format, std::forward<Args>(args)...);
+		return out;
+	}
+} // namespace honeypot::utils
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <tsl/robin_map.h>
+
+#include "utils/hash.hpp"
+
+namespace honeypot::config
+{
+	struct HoneypotConfig;
+}
+
+namespace honeypot::utils::fake_data
+{
+	enum class TemplateKind : uint8_t
+	{
+		generate,
+		chat,
+	};
+
+	/**
+	 * @brief Per-model persona templates compiled into a flat op stream.
+	 *
+	 * Template source text such as "Sure, {{model}} here. {{pick:Hi|Hello}}" is parsed once
+	 * at load time. Literal runs and pick choices live in a single string arena, so rendering
+	 * is a linear walk over ops that appends into a caller buffer reserved up front.
+	 *
+	 * Supported placeholders: {{model}}, {{prompt}}, {{prompt:N}}, {{timestamp}}, {{date}},
+	 * {{pick:a|b|...}}. Unknown placeholders are kept as literal text.
+	 */
+	class TemplateSet
+	{
+	public:
+		/**
+		 * @brief Loads every *.json persona file in @p directory.
+		 * Each file holds {"models": [...], "generate": [...], "chat": [...]}; a "*" model entry
+		 * makes it the fallback persona.
+		 * @throws std::runtime_error on unreadable files or malformed templates.
+		 */
+		static std::shared_ptr<const TemplateSet> load_directory(const std::string& directory);
+
+		/**
+		 * @brief Built-in fallback used when no template directory is configured.
+		 */
+		static std::shared_ptr<const TemplateSet> builtin();
+
+		/**
+		 * @brief Renders a randomly chosen template for @p model into @p out (cleared first).
+		 * @return false if no template of @p kind exists for the model or the fallback persona.
+		 */
+		bool render(TemplateKind kind, std::string_view model, std::string_view prompt, std::string& out) const;
+
+		size_t template_count() const { return templates_.size(); }
+
+	private:
+		enum class OpCode : uint8_t
+		{
+			literal,
+			model,
+			prompt,
+			timestamp,
+			date,
+			pick,
+		};
+
+		struct Op
+		{
+			OpCode code;
+			uint32_t a; // literal: arena offset, prompt: max bytes, pick: first choice index
+			uint32_t b; // literal: length, pick: choice count
+		};
+
+		struct Span
+		{
+			uint32_t offset;
+			uint32_t length;
+		};
+
+		struct CompiledTemplate
+		{
+			uint32_t first_op;
+			uint32_t op_count;
+			uint32_t static_bytes; // literal bytes plus the longest pick choice of each pick op
+			uint32_t prompt_bytes; // upper bound contributed by prompt ops
+			uint16_t model_refs;
+			uint16_t time_refs;
+		};
+
+		struct Persona
+		{
+			std::vector<uint32_t> generate;
+			std::vector<uint32_t> chat;
+		};
+
+		uint32_t compile(std::string_view source);
+		uint32_t intern(std::string_view text);
+		void add_persona_from_json(const std::string& file_name, const std::string& text);
+
+		const Persona* find_persona(std::string_view model) const;
+
+		std::string arena_;
+		std::vector<Op> ops_;
+		std::vector<Span> choices_;
+		std::vector<CompiledTemplate> templates_;
+		tsl::robin_map<std::string, Persona, TransparentStringHash, TransparentStringEqual> personas_;
+		Persona fallback_;
+	};
+
+	/**
+	 * @brief Loads the template directory named by api_behavior.response_template_dir.
+	 * Falls back to the built-in persona if the directory is unset or fails to load.
+	 */
+	void init_response_templates(const config::HoneypotConfig& config);
+
+	/**
+	 * @brief Recompiles the template directory and swaps it in atomically.
+	 * In-flight renders keep the previous set alive. On failure the old set stays active.
+	 * @return true if the new set was installed.
+	 */
+	bool reload_response_templates();
+
+	std::shared_ptr<const TemplateSet> get_response_templates();
+
+	/**
+	 * @brief Renders a response text into a per-thread buffer.
+	 * The returned view stays valid until the next call on the same thread.
+	 */
+	std::string_view generate_response_text(TemplateKind kind, std::string_view model, std::string_view prompt);
+} // namespace honeypot::utils::fake_data
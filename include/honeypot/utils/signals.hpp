@@ -0,0 +1,27 @@
+#pragma once
+
+#include <functional>
+
+namespace honeypot::utils
+{
+	/**
+	 * @brief Blocks the signals the listener serves (SIGHUP and SIGUSR2) in the calling thread.
+	 * Threads spawned afterwards inherit the mask, so call it first thing in main(); an internal
+	 * thread that may start before that calls it itself. No-op on Windows.
+	 */
+	void block_listener_signals();
+
+	/**
+	 * @brief Registers a callback run on the signal thread whenever @p signum arrives.
+	 * Must be called before start_signal_listener(). Several callbacks per signal are allowed.
+	 */
+	void on_signal(int signum, std::function<void()> handler);
+
+	/**
+	 * @brief Starts a detached thread that waits with sigwait() for the listener signals and any
+	 * other registered ones, which it also blocks in the calling thread. Only threads spawned
+	 * after block_listener_signals() are safe from the default action (for SIGHUP, termination).
+	 * No-op on Windows.
+	 */
+	void start_signal_listener();
+} // namespace honeypot::utils
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include <crow.h>
+#include <tsl/robin_map.h>
+
+#include "utils/config.hpp"
+#include "utils/hash.hpp"
+
+namespace honeypot::utils
+{
+	/**
+	 * @brief Slows down hostile sources instead of serving them fast.
+	 *
+	 * Sources are scored per fixed window in a sharded table of bounded size (a full shard evicts
+	 * idle sources first, then the oldest unflagged); exceeding the request budget (or an explicit
+	 * flag()) marks the source hostile for a while, and every repeat offence doubles the hold. Held
+	 * responses wait in a C++20 coroutine on the request's own io_context, suspended on timer wheel
+	 * entries, so a held connection costs one coroutine frame and one wheel entry and never occupies
+	 * a worker.
+	 */
+	class Tarpit
+	{
+	public:
+		explicit Tarpit(const config::TarpitConfig& config);
+
+		/**
+		 * @brief Records one request from @p source_ip.
+		 * @return How long to hold the response; zero for sources in good standing.
+		 */
+		std::chrono::milliseconds observe(std::string_view source_ip);
+
+		/**
+		 * @brief Marks @p source_ip hostile immediately (counts as an offence); @p reason is logged.
+		 */
+		void flag(std::string_view source_ip, std::string_view reason);
+
+		/**
+		 * @brief Whether @p source_ip is currently held, without counting a request.
+		 */
+		bool is_flagged(std::string_view source_ip);
+
+		/**
+		 * @brief Completes @p res with @p ready, after @p hold if it is non-zero and the held
+		 * connection budget allows it.
+		 */
+		void complete(const crow::request& req, crow::response& res, crow::response ready,
+		              std::chrono::milliseconds hold);
+
+		size_t held_connections() const { return held_.load(std::memory_order_relaxed); }
+		bool enabled() const { return config_.enabled; }
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		struct SourceScore
+		{
+			Clock::time_point window_start{};
+			Clock::time_point flagged_until{};
+			uint32_t window_requests = 0;
+			uint32_t offences = 0;
+		};
+
+		struct Shard
+		{
+			std::mutex mutex;
+			tsl::robin_map<std::string, SourceScore, TransparentStringHash, TransparentStringEqual> sources;
+			std::deque<std::string> arrival; // the same sources, oldest first; eviction candidates
+		};
+
+		static constexpr size_t shard_count = 64;
+		static constexpr size_t max_sources_per_shard = 4096;
+		// Active sources a full shard passes over before it evicts the oldest unflagged one anyway.
+		static constexpr size_t max_eviction_checks = 8;
+
+		Shard& shard_for(std::string_view source_ip);
+		void make_room(Shard& shard, Clock::time_point now) const;
+		SourceScore& score_for(Shard& shard, std::string_view source_ip, Clock::time_point now);
+		std::chrono::milliseconds hold_for(const SourceScore& score) const;
+
+		config::TarpitConfig config_;
+		std::array<Shard, shard_count> shards_;
+		std::atomic<size_t> held_{0};
+	};
+
+	void init_tarpit(const config::HoneypotConfig& config);
+	Tarpit& get_tarpit();
+} // namespace honeypot::utils
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <asio.hpp>
+
+namespace honeypot::utils
+{
+	/**
+	 * @brief Hierarchical timer wheel shared by everything that simulates delay.
+	 *
+	 * Four levels of 256 slots cover 2^32 ticks. Entries are pooled intrusive nodes, so tens of
+	 * thousands of pending delays cost a few MB and no threads beyond the single one driving
+	 * the wheel, whose asio timer is only armed while entries are pending.
+	 *
+	 * Callbacks run on the wheel thread and must stay short; use post_after() to have work
+	 * resume on a connection's own io_context.
+	 */
+	class TimerWheel
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+		using Callback = std::function<void()>;
+
+		explicit TimerWheel(Clock::duration tick = std::chrono::milliseconds(5));
+		~TimerWheel();
+		TimerWheel(const TimerWheel&) = delete;
+		TimerWheel& operator=(const TimerWheel&) = delete;
+
+		/**
+		 * @brief Runs @p callback on the wheel thread once @p delay has elapsed (rounded up to a tick).
+		 * Thread-safe.
+		 */
+		void schedule(Clock::duration delay, Callback callback);
+
+		/**
+		 * @brief Posts @p callback to @p io_context once @p delay has elapsed. Thread-safe.
+		 */
+		void post_after(asio::io_context& io_context, Clock::duration delay, Callback callback);
+
+		/**
+		 * @brief Asio-style asynchronous wait backed by a wheel entry instead of a kernel timer.
+		 * Completes on the handler's associated executor, so `co_await wheel.async_wait(d,
+		 * asio::use_awaitable)` resumes a coroutine on its own io_context.
+		 */
+		template <typename CompletionToken>
+		auto async_wait(Clock::duration delay, CompletionToken&& token)
+		{
+			return asio::async_initiate<CompletionToken, void()>(
+				[this, delay](auto handler) {
+					// The work guard keeps the handler's io_context running while only the wheel knows about it.
+					auto work = std::make_shared<decltype(asio::make_work_guard(handler, io_context_))>(
+						asio::make_work_guard(handler, io_context_));
+					auto shared = std::make_shared<decltype(handler)>(std::move(handler));
+					schedule(delay, [work, shared] {
+						asio::post(work->get_executor(), [work, shared] { std::move(*shared)(); });
+					});
+				},
+				token);
+		}
+
+		size_t pending() const;
+
+	private:
+		struct Entry
+		{
+			uint64_t expiry_tick = 0;
+			Callback callback;
+			Entry* next = nullptr;
+		};
+
+		static constexpr unsigned slot_bits = 8;
+		static constexpr size_t slot_count = size_t{1} << slot_bits;
+		static constexpr size_t level_count = 4;
+
+		uint64_t now_tick() const;
+		void insert(Entry* entry);
+		void advance(std::vector<Callback>& due);
+		void arm();
+		void on_tick(const asio::error_code& ec);
+
+		const Clock::duration tick_;
+		const Clock::time_point epoch_;
+
+		mutable std::mutex mutex_; // protects everything below except the asio members
+		std::array<std::array<Entry*, slot_count>, level_count> slots_{};
+		uint64_t current_tick_ = 0;
+		size_t pending_ = 0;
+		bool armed_ = false;
+		std::deque<Entry> storage_;
+		Entry* free_list_ = nullptr;
+
+		std::vector<Callback> due_; // only touched on the wheel thread
+		asio::io_context io_context_;
+		asio::steady_timer ticker_;
+		asio::executor_work_guard<asio::io_context::executor_type> work_;
+		std::thread thread_;
+	};
+
+	/**
+	 * @brief Process-wide wheel, started on first use.
+	 */
+	TimerWheel& get_timer_wheel();
+} // namespace honeypot::utils
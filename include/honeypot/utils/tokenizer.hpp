@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <nlohmann/json_fwd.hpp>
+#include <tsl/robin_map.h>
+
+#include "utils/hash.hpp"
+
+namespace honeypot::utils
+{
+	/**
+	 * @brief Byte-level BPE tokenizer rebuilt from a GGUF "model_info" block.
+	 *
+	 * Uses tokenizer.ggml.tokens and tokenizer.ggml.merges exactly as /api/show exposes them,
+	 * so token counts line up with what the advertised model would report. Merges are keyed by
+	 * the packed (left id, right id) pair in an open-addressing table, and the common case of a
+	 * whole pre-token already being in the vocabulary is answered with a single probe. Other
+	 * pre-tokens are merged lowest rank first from a heap over a linked list of symbols, so a
+	 * word of n bytes costs O(n log n).
+	 */
+	class BpeTokenizer
+	{
+	public:
+		/**
+		 * @brief Builds a tokenizer if @p model_info describes a byte-level BPE ("gpt2") vocabulary.
+		 * @return nullptr for other tokenizer types or when the arrays are absent.
+		 */
+		static std::shared_ptr<const BpeTokenizer> from_model_info(const nlohmann::ordered_json& model_info);
+
+		/**
+		 * @brief Appends the token ids for @p text to @p ids.
+		 */
+		void encode(std::string_view text, std::vector<uint32_t>& ids) const;
+
+		/**
+		 * @brief Number of tokens @p text encodes to, without materializing ids.
+		 */
+		size_t count_tokens(std::string_view text) const;
+
+		size_t vocab_size() const { return vocab_size_; }
+
+		/**
+		 * @brief Approximate heap footprint of the vocabulary and merge tables.
+		 */
+		size_t memory_bytes() const;
+
+	private:
+		BpeTokenizer() = default;
+
+		struct Scratch; // per-thread buffers reused across words
+		static Scratch& scratch();
+
+		template <typename Sink>
+		void encode_word(std::string_view word, Scratch& scratch, Sink&& sink) const;
+
+		struct MergeEntry
+		{
+			uint32_t rank;
+			uint32_t merged_id;
+		};
+
+		tsl::robin_map<std::string, uint32_t, TransparentStringHash, TransparentStringEqual> vocab_;
+		tsl::robin_map<uint64_t, MergeEntry> merges_;
+		std::array<uint32_t, 256> byte_tokens_{};
+		size_t vocab_size_ = 0;
+	};
+
+	/**
+	 * @brief Rough token estimate for models without a usable tokenizer (about 4 bytes per token).
+	 */
+	size_t estimate_tokens(std::string_view text);
+} // namespace honeypot::utils
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include "utils/config.hpp"
+
+namespace honeypot::utils
+{
+	/**
+	 * @brief Samples requests and records timed spans of their phases for Chrome's trace viewer.
+	 *
+	 * Whether a request is traced is decided once, in begin_request(), and kept in a thread-local
+	 * flag; spans on an untraced request cost one thread-local load. Each thread writes spans into
+	 * its own fixed ring without locks, overwriting the oldest ones. dump() copies every ring and
+	 * writes them as trace-event JSON (chrome://tracing, ui.perfetto.dev).
+	 */
+	class Tracer
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		/**
+		 * @brief Sampling decision and start time of one request, kept in its middleware context.
+		 */
+		struct RequestTrace
+		{
+			bool sampled = false;
+			uint64_t start_ns = 0;
+		};
+
+		explicit Tracer(const config::TracingConfig& config);
+
+		/**
+		 * @brief Decides whether the request now starting on the calling thread is traced.
+		 */
+		RequestTrace begin_request();
+
+		/**
+		 * @brief Re-marks the calling thread for @p trace, for work finishing on another thread.
+		 */
+		static void resume_request(const RequestTrace& trace) { request_sampled_ = trace.sampled; }
+
+		/**
+		 * @brief Records the whole request as span @p name and clears the calling thread's mark.
+		 */
+		void end_request(const RequestTrace& trace, const char* name);
+
+		static bool sampling() { return request_sampled_; }
+
+		/**
+		 * @brief Records one span on the calling thread's ring. @p name must outlive the tracer.
+		 */
+		void record(const char* name, uint64_t start_ns, uint64_t end_ns);
+
+		uint64_t now_ns() const;
+
+		/**
+		 * @brief Writes every buffered span to @p path as Chrome trace-event JSON.
+		 * @return The number of spans written.
+		 * @throws std::runtime_error if the file cannot be written.
+		 */
+		size_t dump(const std::string& path) const;
+
+		bool enabled() const { return config_.enabled; }
+		const std::string& dump_path() const { return config_.dump_path; }
+
+	private:
+		struct Slot
+		{
+			std::atomic<const char*> name{nullptr};
+			std::atomic<uint64_t> start_ns{0};
+			std::atomic<uint64_t> end_ns{0};
+		};
+
+		// Single writer (the owning thread), any number of readers in dump().
+		struct Ring
+		{
+			explicit Ring(size_t capacity, uint32_t thread_id);
+
+			std::unique_ptr<Slot[]> slots;
+			const size_t mask;
+			const uint32_t thread_id;
+			std::atomic<uint64_t> head{0}; // spans ever written; slot head & mask is written next
+		};
+
+		Ring& local_ring();
+
+		static inline thread_local bool request_sampled_ = false;
+
+		config::TracingConfig config_;
+		uint64_t sample_threshold_; // a request is traced if a uniform 64-bit draw is at most this
+		size_t ring_capacity_;
+		Clock::time_point epoch_;
+
+		mutable std::mutex rings_mutex_;
+		std::vector<std::unique_ptr<Ring>> rings_; // one per thread that ever traced, never shrinks
+	};
+
+	void init_tracing(const config::HoneypotConfig& config);
+	Tracer& get_tracer();
+
+	/**
+	 * @brief Times the enclosing scope as span @p name if the current request is traced.
+	 */
+	class TraceSpan
+	{
+	public:
+		explicit TraceSpan(const char* name)
+			: name_(Tracer::sampling() ? name : nullptr),
+			  start_ns_(name_ != nullptr ? get_tracer().now_ns() : 0)
+		{
+		}
+
+		~TraceSpan()
+		{
+			if (name_ != nullptr)
+			{
+				auto& tracer = get_tracer();
+				tracer.record(name_, start_ns_, tracer.now_ns());
+			}
+		}
+
+		TraceSpan(const TraceSpan&) = delete;
+		TraceSpan& operator=(const TraceSpan&) = delete;
+
+	private:
+		const char* name_;
+		uint64_t start_ns_;
+	};
+
+	/**
+	 * @brief Locks @p mutex, recording the wait as span @p name on traced requests.
+	 */
+	template <typename Mutex>
+	std::unique_lock<Mutex> lock_traced(Mutex& mutex, const char* name)
+	{
+		TraceSpan wait(name);
+		return std::unique_lock<Mutex>(mutex);
+	}
+
+	template <typename Mutex>
+	std::shared_lock<Mutex> lock_shared_traced(Mutex& mutex, const char* name)
+	{
+		TraceSpan wait(name);
+		return std::shared_lock<Mutex>(mutex);
+	}
+} // namespace honeypot::utils
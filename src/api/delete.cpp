@@ -6,6 +6,7 @@
 #include "state/honeypot_state.hpp"
 #include "utils/fake_data.hpp"
 #include "utils/logging.hpp"
+#include "utils/request_arena.hpp"
 #include "api/delete.hpp"
 
 namespace honeypot::api
@@ -15,7 +16,8 @@ namespace honeypot::api
         auto logger = utils::get_operational_logger();
         logger->debug("Handling DELETE /api/delete request.");
 
-        nlohmann::ordered_json request_body;
+        utils::ArenaScope arena; // the parsed body and error messages live until the handler returns
+        utils::ArenaJson request_body;
         try
         {
             if (req.body.empty())
@@ -23,20 +25,19 @@ namespace honeypot::api
                 logger->warn("/api/delete request received with empty body.");
                 return {
                     crow::status::BAD_REQUEST,
-                    utils::fake_data::generate_error("missing request body").dump()
+                    utils::fake_data::generate_error_body("missing request body")
                 };
             }
-            request_body = nlohmann::ordered_json::parse(req.body);
+            request_body = utils::ArenaJson::parse(req.body);
         }
         catch (const nlohmann::json::parse_error& e)
         {
             logger->warn("/api/delete request body failed JSON parsing: {}", e.what());
             // Return an error message closer to Ollama's *style*, but generic content
             // TODO: what can we do here?
-            auto error_json = utils::fake_data::generate_error("invalid json request format");
             crow::response res(crow::status::BAD_REQUEST);
             res.set_header("Content-Type", "application/json; charset=utf-8");
-            res.body = error_json.dump();
+            res.body = utils::fake_data::generate_error_body("invalid json request format");
             return res;
         } catch (const nlohmann::json::exception& e)
         {
@@ -47,28 +48,27 @@ namespace honeypot::api
         if (!request_body.contains("model") || !request_body["model"].is_string())
         {
             logger->warn("/api/delete request JSON missing 'model' key or it's not a string.");
-            auto error_json = utils::fake_data::generate_error("missing 'model' field in request");
             crow::response res(crow::status::BAD_REQUEST);
             res.set_header("Content-Type", "application/json; charset=utf-8");
-            res.body = error_json.dump();
+            res.body = utils::fake_data::generate_error_body("missing 'model' field in request");
             return res;
         }
 
-        std::string model_to_delete = request_body["model"];
+        const std::string_view model_to_delete = request_body["model"].get_ref<const utils::ArenaString&>();
         logger->info("Attempting to delete model: '{}'", model_to_delete);
 
         try
         {
-            if (state->delete_model(model_to_delete))
+            if (state->delete_model(req.remote_ip_address, model_to_delete))
             {
                 logger->info("Successfully deleted model '{}' from state.", model_to_delete);
                 return crow::response(crow::status::OK); // 200 OK, No body
             }
             logger->info("Model '{}' not found for deletion.", model_to_delete);
-            auto error_json = utils::fake_data::generate_error(fmt::format("model '{}' not found", model_to_delete));
             crow::response res(crow::status::NOT_FOUND); // 404 Not Found
             res.set_header("Content-Type", "application/json; charset=utf-8");
-            res.body = error_json.dump();
+            res.body = utils::fake_data::generate_error_body(
+                utils::arena_format("model '{}' not found", model_to_delete));
             return res;
         }
         catch (const std::exception& e)
@@ -0,0 +1,287 @@
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <fmt/core.h>
+#include <nlohmann/json.hpp>
+
+#include "api/generate_handlers.hpp"
+#include "api/generation.hpp"
+#include "state/honeypot_state.hpp"
+#include "utils/fake_data.hpp"
+#include "utils/latency_model.hpp"
+#include "utils/logging.hpp"
+#include "utils/tokenizer.hpp"
+
+namespace honeypot::api
+{
+    namespace
+    {
+        using utils::fake_data::TemplateKind;
+        using namespace generation;
+
+        struct GenerationRequest
+        {
+            TemplateKind kind = TemplateKind::generate;
+            std::string model;
+            std::string prompt_text; // text the reply is about (prompt or last user message)
+            uint64_t prompt_tokens = 0;
+            bool stream = true;
+            uint32_t max_pieces = default_max_pieces;
+            bool cold_load = false;
+            std::shared_ptr<const state::ModelPayload> payload; // the model as the source sees it, for latency
+        };
+
+        uint32_t parse_max_pieces(const nlohmann::ordered_json& body)
+        {
+            const auto options = body.find("options");
+            if (options == body.end() || !options->is_object())
+            {
+                return default_max_pieces;
+            }
+            const auto num_predict = options->find("num_predict");
+            if (num_predict == options->end() || !num_predict->is_number_integer() || num_predict->get<int64_t>() <= 0)
+            {
+                return default_max_pieces;
+            }
+            return static_cast<uint32_t>(std::min<int64_t>(num_predict->get<int64_t>(), default_max_pieces));
+        }
+
+        void begin_object(std::string& out, const GenerationRequest& request, const std::string_view created_at)
+        {
+            out.append(R"({"model":")");
+            utils::fake_data::append_json_escaped(out, request.model);
+            out.append(R"(","created_at":")");
+            out.append(created_at);
+            out.append("\",");
+        }
+
+        void append_content_field(std::string& out, const GenerationRequest& request, const std::string_view content)
+        {
+            if (request.kind == TemplateKind::chat)
+            {
+                out.append(R"("message":{"role":"assistant","content":")");
+                utils::fake_data::append_json_escaped(out, content);
+                out.append("\"},");
+            }
+            else
+            {
+                out.append(R"("response":")");
+                utils::fake_data::append_json_escaped(out, content);
+                out.append("\",");
+            }
+        }
+
+        Completion make_load_response(const GenerationRequest& request)
+        {
+            std::string body;
+            begin_object(body, request, utils::fake_data::generate_timestamp_iso8601());
+            append_content_field(body, request, "");
+            body.append(R"("done_reason":"load","done":true})");
+
+            Completion completion{crow::response(crow::status::OK)};
+            completion.response.set_header("Content-Type", "application/json; charset=utf-8");
+            completion.response.body = std::move(body);
+            completion.delay_ns = utils::get_latency_model()
+                .simulate(model_info(request.payload), request.cold_load, 0, 0)
+                .load_duration;
+            return completion;
+        }
+
+        /**
+         * Generates the reply text and writes either the NDJSON stream or the single final object.
+         */
+        Completion run_generation(const GenerationRequest& request,
+                                  const std::shared_ptr<const utils::BpeTokenizer>& tokenizer)
+        {
+            const std::string created_at = utils::fake_data::generate_timestamp_iso8601();
+            const uint64_t seed = random_seed();
+            utils::fake_data::TextPieceSource source(request.kind, request.model, request.prompt_text, seed,
+                                                     target_pieces(seed), request.max_pieces);
+
+            std::string body;
+            std::string full_text;
+            for (std::string_view piece = source.next(); !piece.empty(); piece = source.next())
+            {
+                full_text.append(piece);
+                if (!request.stream)
+                {
+                    continue;
+                }
+                if (request.kind == TemplateKind::chat)
+                {
+                    utils::fake_data::generate_chat_chunk(body, request.model, created_at, piece);
+                }
+                else
+                {
+                    utils::fake_data::generate_completion_chunk(body, request.model, created_at, piece);
+                }
+            }
+
+            utils::fake_data::GenerationStats stats;
+            stats.prompt_eval_count = request.prompt_tokens;
+            stats.eval_count = count_tokens(tokenizer, full_text);
+            const utils::SimulatedTiming timing = utils::get_latency_model().simulate(
+                model_info(request.payload), request.cold_load, stats.prompt_eval_count, stats.eval_count);
+            stats.load_duration = timing.load_duration;
+            stats.prompt_eval_duration = timing.prompt_eval_duration;
+            stats.eval_duration = timing.eval_duration;
+            stats.total_duration = timing.total();
+
+            begin_object(body, request, created_at);
+            append_content_field(body, request, request.stream ? std::string_view{} : std::string_view(full_text));
+            body.append(R"("done_reason":"stop","done":true)");
+            utils::fake_data::generate_final_stats(body, stats);
+            body.append("}\n");
+
+            Completion completion{crow::response(crow::status::OK), stats.total_duration};
+            completion.response.set_header("Content-Type",
+                                           request.stream ? "application/x-ndjson" : "application/json; charset=utf-8");
+            completion.response.body = std::move(body);
+            return completion;
+        }
+
+        /**
+         * Parses the fields shared by /api/generate and /api/chat and simulates the model load.
+         * Returns an error response if the request cannot be served.
+         */
+        std::optional<crow::response> parse_common(const std::shared_ptr<state::HoneypotState>& state,
+                                                   const crow::request& req, const std::string_view endpoint,
+                                                   nlohmann::ordered_json& request_body, GenerationRequest& request)
+        {
+            const auto logger = utils::get_operational_logger();
+
+            if (req.body.empty())
+            {
+                logger->warn("{} request received with empty body.", endpoint);
+                return json_error(crow::status::BAD_REQUEST, "missing request body");
+            }
+            try
+            {
+                request_body = nlohmann::ordered_json::parse(req.body);
+            }
+            catch (const nlohmann::json::parse_error& e)
+            {
+                logger->warn("{} request body failed JSON parsing: {}", endpoint, e.what());
+                return json_error(crow::status::BAD_REQUEST, "invalid json request format");
+            }
+
+            if (!request_body.is_object() || !request_body.contains("model") || !request_body["model"].is_string()
+                || request_body["model"].get_ref<const std::string&>().empty())
+            {
+                logger->warn("{} request missing 'model' field.", endpoint);
+                return json_error(crow::status::BAD_REQUEST, "model is required");
+            }
+            request.model = request_body["model"].get<std::string>();
+            if (const auto stream = request_body.find("stream"); stream != request_body.end() && stream->is_boolean())
+            {
+                request.stream = stream->get<bool>();
+            }
+            request.max_pieces = parse_max_pieces(request_body);
+
+            const auto load_result = state->load_or_update_model(req.remote_ip_address, request.model,
+                                                                  parse_keep_alive(request_body));
+            if (load_result == state::ModelLoadResult::not_found)
+            {
+                logger->info("{} requested unknown model '{}'.", endpoint, request.model);
+                return json_error(crow::status::NOT_FOUND, fmt::format("model '{}' not found", request.model));
+            }
+            request.cold_load = load_result == state::ModelLoadResult::cold;
+            request.payload = state->find_model(req.remote_ip_address, request.model);
+            return std::nullopt;
+        }
+    }
+
+    void handle_generate(const std::shared_ptr<state::HoneypotState>& state, const crow::request& req,
+                         crow::response& res, const std::chrono::milliseconds tarpit_hold)
+    {
+        const auto logger = utils::get_operational_logger();
+        logger->debug("Handling POST /api/generate request.");
+
+        try
+        {
+            nlohmann::ordered_json request_body;
+            GenerationRequest request;
+            request.kind = TemplateKind::generate;
+            if (auto error = parse_common(state, req, "/api/generate", request_body, request))
+            {
+                return fail(req, res, std::move(*error), tarpit_hold);
+            }
+
+            const auto prompt = request_body.find("prompt");
+            if (prompt == request_body.end() || !prompt->is_string() || prompt->get_ref<const std::string&>().empty())
+            {
+                return complete_after(req, res, make_load_response(request), tarpit_hold);
+            }
+            request.prompt_text = prompt->get<std::string>();
+
+            const auto tokenizer = state->get_tokenizer(req.remote_ip_address, request.model);
+            size_t tokenize_budget = max_tokenized_bytes;
+            request.prompt_tokens = generate_template_tokens
+                + count_tokens(tokenizer, request.prompt_text, tokenize_budget);
+            if (const auto system = request_body.find("system"); system != request_body.end() && system->is_string())
+            {
+                request.prompt_tokens += chat_message_tokens
+                    + count_tokens(tokenizer, system->get_ref<const std::string&>(), tokenize_budget);
+            }
+
+            complete_after(req, res, run_generation(request, tokenizer), tarpit_hold);
+        }
+        catch (const std::exception& e)
+        {
+            logger->error("Error handling /api/generate: {}", e.what());
+            fail(req, res, crow::response(crow::status::INTERNAL_SERVER_ERROR, "Internal Server Error"), tarpit_hold);
+        }
+    }
+
+    void handle_chat(const std::shared_ptr<state::HoneypotState>& state, const crow::request& req,
+                     crow::response& res, const std::chrono::milliseconds tarpit_hold)
+    {
+        const auto logger = utils::get_operational_logger();
+        logger->debug("Handling POST /api/chat request.");
+
+        try
+        {
+            nlohmann::ordered_json request_body;
+            GenerationRequest request;
+            request.kind = TemplateKind::chat;
+            if (auto error = parse_common(state, req, "/api/chat", request_body, request))
+            {
+                return fail(req, res, std::move(*error), tarpit_hold);
+            }
+
+            const auto messages = request_body.find("messages");
+            if (messages == request_body.end() || !messages->is_array() || messages->empty())
+            {
+                return complete_after(req, res, make_load_response(request), tarpit_hold);
+            }
+
+            const auto tokenizer = state->get_tokenizer(req.remote_ip_address, request.model);
+            request.prompt_tokens = chat_base_tokens;
+            size_t tokenize_budget = max_tokenized_bytes;
+            for (const auto& message : *messages)
+            {
+                if (!message.is_object())
+                {
+                    return fail(req, res, json_error(crow::status::BAD_REQUEST, "invalid message format"), tarpit_hold);
+                }
+                const std::string content = string_field(message, "content");
+                request.prompt_tokens += chat_message_tokens + count_tokens(tokenizer, content, tokenize_budget);
+                if (string_field(message, "role") == "user")
+                {
+                    request.prompt_text = content;
+                }
+            }
+
+            complete_after(req, res, run_generation(request, tokenizer), tarpit_hold);
+        }
+        catch (const std::exception& e)
+        {
+            logger->error("Error handling /api/chat: {}", e.what());
+            fail(req, res, crow::response(crow::status::INTERNAL_SERVER_ERROR, "Internal Server Error"), tarpit_hold);
+        }
+    }
+} // namespace honeypot::api
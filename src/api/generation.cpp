@@ -0,0 +1,164 @@
+#include <cmath>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include <nlohmann/json.hpp>
+
+#include "api/generation.hpp"
+#include "state/honeypot_state.hpp"
+#include "utils/fake_data.hpp"
+#include "utils/latency_model.hpp"
+#include "utils/tarpit.hpp"
+#include "utils/timer_wheel.hpp"
+#include "utils/tokenizer.hpp"
+
+namespace honeypot::api::generation
+{
+    namespace
+    {
+        constexpr std::chrono::seconds forever_keep_alive{std::chrono::hours(24 * 365)};
+        constexpr uint32_t min_target_pieces = 30;
+        constexpr uint32_t max_target_pieces = 180;
+    }
+
+    std::chrono::seconds parse_keep_alive(const nlohmann::ordered_json& body)
+    {
+        const auto it = body.find("keep_alive");
+        if (it == body.end() || it->is_null())
+        {
+            return default_keep_alive;
+        }
+
+        double amount = 0.0;
+        double unit_seconds = 1.0;
+        if (it->is_number())
+        {
+            amount = it->get<double>();
+        }
+        else if (it->is_string())
+        {
+            const auto& text = it->get_ref<const std::string&>();
+            size_t consumed = 0;
+            try
+            {
+                amount = std::stod(text, &consumed);
+            }
+            catch (const std::exception&)
+            {
+                return default_keep_alive;
+            }
+            const std::string_view unit = std::string_view(text).substr(consumed);
+            if (unit == "ms") unit_seconds = 0.001;
+            else if (unit == "m") unit_seconds = 60.0;
+            else if (unit == "h") unit_seconds = 3600.0;
+            else if (!unit.empty() && unit != "s") return default_keep_alive;
+        }
+        else
+        {
+            return default_keep_alive;
+        }
+
+        const double seconds = amount * unit_seconds;
+        if (!std::isfinite(seconds))
+        {
+            return default_keep_alive; // "inf", "nan", or a number too large for a double
+        }
+        // Clamped before the cast, which is undefined for values an int64_t cannot hold.
+        if (seconds < 0 || seconds >= static_cast<double>(forever_keep_alive.count()))
+        {
+            return forever_keep_alive;
+        }
+        return std::chrono::seconds(static_cast<int64_t>(seconds));
+    }
+
+    std::string string_field(const nlohmann::ordered_json& object, const std::string_view field)
+    {
+        const auto it = object.find(field);
+        return it != object.end() && it->is_string() ? it->get<std::string>() : std::string{};
+    }
+
+    crow::response json_error(const int code, const std::string_view message)
+    {
+        crow::response res(code);
+        res.set_header("Content-Type", "application/json; charset=utf-8");
+        res.body = utils::fake_data::generate_error_body(message);
+        return res;
+    }
+
+    uint64_t count_tokens(const std::shared_ptr<const utils::BpeTokenizer>& tokenizer, const std::string_view text,
+                          size_t& byte_budget)
+    {
+        if (!tokenizer)
+        {
+            return utils::estimate_tokens(text);
+        }
+        const std::string_view counted = text.substr(0, byte_budget);
+        byte_budget -= counted.size();
+        return tokenizer->count_tokens(counted) + utils::estimate_tokens(text.substr(counted.size()));
+    }
+
+    uint64_t count_tokens(const std::shared_ptr<const utils::BpeTokenizer>& tokenizer, const std::string_view text)
+    {
+        size_t byte_budget = max_tokenized_bytes;
+        return count_tokens(tokenizer, text, byte_budget);
+    }
+
+    const config::TagModelInfo* model_info(const std::shared_ptr<const state::ModelPayload>& payload)
+    {
+        return payload ? &payload->info : nullptr;
+    }
+
+    uint64_t random_seed()
+    {
+        thread_local std::mt19937_64 rng{std::random_device{}()};
+        return rng();
+    }
+
+    uint32_t target_pieces(const uint64_t seed)
+    {
+        return static_cast<uint32_t>(min_target_pieces + seed % (max_target_pieces - min_target_pieces));
+    }
+
+    void complete_after(const crow::request& req, crow::response& res, Completion completion,
+                        const std::chrono::milliseconds hold)
+    {
+        const bool simulated = utils::get_latency_model().enabled() && completion.delay_ns != 0;
+        if (hold > std::chrono::milliseconds::zero())
+        {
+            // One wait covering both, so a held source never sees a reply faster than the model.
+            const auto delay = simulated
+                ? std::chrono::ceil<std::chrono::milliseconds>(std::chrono::nanoseconds(completion.delay_ns))
+                : std::chrono::milliseconds::zero();
+            utils::get_tarpit().complete(req, res, std::move(completion.response), hold + delay);
+            return;
+        }
+        if (!simulated || req.io_context == nullptr)
+        {
+            res = std::move(completion.response);
+            res.end();
+            return;
+        }
+
+        auto ready = std::make_shared<crow::response>(std::move(completion.response));
+        utils::get_timer_wheel().post_after(*req.io_context, std::chrono::nanoseconds(completion.delay_ns),
+                                            [&res, ready = std::move(ready)] {
+                                                res = std::move(*ready);
+                                                res.end();
+                                            });
+    }
+
+    void fail(const crow::request& req, crow::response& res, crow::response error,
+              const std::chrono::milliseconds hold)
+    {
+        if (hold > std::chrono::milliseconds::zero())
+        {
+            utils::get_tarpit().complete(req, res, std::move(error), hold);
+            return;
+        }
+        res = std::move(error);
+        res.end();
+    }
+} // namespace honeypot::api::generation
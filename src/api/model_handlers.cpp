@@ -0,0 +1,270 @@
+#include <algorithm>
+#include <cctype>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <fmt/core.h>
+#include <nlohmann/json.hpp>
+
+#include "api/generation.hpp"
+#include "api/model_handlers.hpp"
+#include "state/honeypot_state.hpp"
+#include "utils/fake_data.hpp"
+#include "utils/logging.hpp"
+
+namespace honeypot::api
+{
+    namespace
+    {
+        using generation::json_error;
+        using generation::string_field;
+
+        constexpr size_t max_model_name_length = 350;
+
+        // Fields of a create request that each become a layer of their own.
+        constexpr const char* layer_fields[] = {"template", "system", "parameters", "license", "messages", "adapters"};
+
+        /**
+         * Accepts names of the form [host/][namespace/]model[:tag] and adds ":latest" when the tag is
+         * missing, as Ollama does. Returns an empty string for names it would reject.
+         */
+        std::string normalize_model_name(const std::string_view name)
+        {
+            if (name.empty() || name.size() > max_model_name_length
+                || !std::isalnum(static_cast<unsigned char>(name.front())))
+            {
+                return {};
+            }
+            const bool valid_chars = std::ranges::all_of(name, [](const char c) {
+                return std::isalnum(static_cast<unsigned char>(c)) || c == '.' || c == '_' || c == '-' || c == ':'
+                    || c == '/';
+            });
+            if (!valid_chars || name.ends_with(':') || name.ends_with('/'))
+            {
+                return {};
+            }
+
+            const size_t model_start = name.rfind('/') == std::string_view::npos ? 0 : name.rfind('/') + 1;
+            if (name.find(':', model_start) == std::string_view::npos)
+            {
+                return std::string(name) + ":latest";
+            }
+            return std::string(name);
+        }
+
+        // Legacy clients send a Modelfile instead of "from"; only its FROM line matters here.
+        std::string modelfile_from(const std::string_view modelfile)
+        {
+            size_t line_start = 0;
+            while (line_start < modelfile.size())
+            {
+                const size_t line_end = std::min(modelfile.find('\n', line_start), modelfile.size());
+                std::string_view line = modelfile.substr(line_start, line_end - line_start);
+                line.remove_prefix(std::min(line.find_first_not_of(" \t"), line.size()));
+                if (line.size() > 5 && (line.starts_with("FROM ") || line.starts_with("from ")))
+                {
+                    line.remove_prefix(5);
+                    line.remove_prefix(std::min(line.find_first_not_of(" \t"), line.size()));
+                    return std::string(line.substr(0, line.find_last_not_of(" \t\r") + 1));
+                }
+                line_start = line_end + 1;
+            }
+            return {};
+        }
+
+        nlohmann::ordered_json parse_body(const crow::request& req, const std::string_view endpoint)
+        {
+            try
+            {
+                nlohmann::ordered_json body = nlohmann::ordered_json::parse(req.body);
+                if (body.is_object())
+                {
+                    return body;
+                }
+            }
+            catch (const nlohmann::json::parse_error& e)
+            {
+                utils::get_operational_logger()->warn("{} request body failed JSON parsing: {}", endpoint, e.what());
+            }
+            return nullptr;
+        }
+
+        /**
+         * Finishes a create: the status lines as NDJSON when streaming, otherwise only the last one,
+         * with errors mapped to 500 the way Ollama reports a failed non-streamed create.
+         */
+        crow::response create_response(const bool stream, const std::string& statuses,
+                                       const std::string_view last_status, const std::string_view error)
+        {
+            if (!stream)
+            {
+                if (!error.empty())
+                {
+                    return json_error(crow::status::INTERNAL_SERVER_ERROR, error);
+                }
+                std::string body;
+                utils::fake_data::generate_create_status_chunk(body, last_status);
+                body.pop_back(); // no trailing newline outside of a stream
+                crow::response res(crow::status::OK);
+                res.set_header("Content-Type", "application/json; charset=utf-8");
+                res.body = std::move(body);
+                return res;
+            }
+
+            crow::response res(crow::status::OK);
+            res.set_header("Content-Type", "application/x-ndjson");
+            res.body = statuses;
+            if (!error.empty())
+            {
+                res.body.append(utils::fake_data::generate_error_body(error));
+                res.body.push_back('\n');
+            }
+            return res;
+        }
+    }
+
+    crow::response handle_copy(const std::shared_ptr<state::HoneypotState>& state, const crow::request& req)
+    {
+        const auto logger = utils::get_operational_logger();
+        logger->debug("Handling POST /api/copy request.");
+
+        try
+        {
+            const nlohmann::ordered_json request_body = parse_body(req, "/api/copy");
+            if (request_body.is_null())
+            {
+                return json_error(crow::status::BAD_REQUEST, "invalid request body");
+            }
+
+            const std::string source = string_field(request_body, "source");
+            const std::string destination = string_field(request_body, "destination");
+            if (source.empty() || destination.empty())
+            {
+                return json_error(crow::status::BAD_REQUEST, "source and destination are required");
+            }
+
+            const std::string destination_name = normalize_model_name(destination);
+            if (destination_name.empty())
+            {
+                return json_error(crow::status::BAD_REQUEST, fmt::format("destination \"{}\" is invalid", destination));
+            }
+
+            auto payload = state->find_model(req.remote_ip_address, normalize_model_name(source));
+            if (!payload)
+            {
+                logger->info("/api/copy requested unknown model '{}'.", source);
+                return json_error(crow::status::NOT_FOUND, fmt::format("model \"{}\" not found", source));
+            }
+
+            if (!state->add_model(req.remote_ip_address, destination_name, std::move(payload)))
+            {
+                logger->info("/api/copy to '{}' refused: overlay for {} is full.", destination_name,
+                             req.remote_ip_address);
+                return json_error(crow::status::INTERNAL_SERVER_ERROR, "write manifest: no space left on device");
+            }
+            return crow::response(crow::status::OK); // 200 OK, No body
+        }
+        catch (const std::exception& e)
+        {
+            logger->error("Error handling /api/copy: {}", e.what());
+            return {crow::status::INTERNAL_SERVER_ERROR, "Internal Server Error"};
+        }
+    }
+
+    crow::response handle_create(const std::shared_ptr<state::HoneypotState>& state, const crow::request& req)
+    {
+        const auto logger = utils::get_operational_logger();
+        logger->debug("Handling POST /api/create request.");
+
+        try
+        {
+            const nlohmann::ordered_json request_body = parse_body(req, "/api/create");
+            if (request_body.is_null())
+            {
+                return json_error(crow::status::BAD_REQUEST, "invalid request body");
+            }
+
+            std::string name = string_field(request_body, "model");
+            if (name.empty())
+            {
+                name = string_field(request_body, "name"); // deprecated spelling
+            }
+            const std::string model_name = normalize_model_name(name);
+            if (model_name.empty())
+            {
+                return json_error(crow::status::BAD_REQUEST, "invalid model name");
+            }
+
+            std::string from = string_field(request_body, "from");
+            if (from.empty())
+            {
+                from = modelfile_from(string_field(request_body, "modelfile"));
+            }
+            const bool has_files = request_body.contains("files") && request_body["files"].is_object();
+            if (from.empty() && !has_files)
+            {
+                return json_error(crow::status::BAD_REQUEST, "neither 'from' or 'files' was specified");
+            }
+
+            const auto stream_field = request_body.find("stream");
+            const bool stream = stream_field == request_body.end() || !stream_field->is_boolean()
+                || stream_field->get<bool>();
+            std::string statuses;
+
+            // There is no blob store behind this instance, so uploaded files are never found.
+            auto base = from.empty() ? nullptr : state->find_model(req.remote_ip_address, normalize_model_name(from));
+            if (!base)
+            {
+                logger->info("/api/create of '{}' from unknown model '{}'.", model_name, from);
+                utils::fake_data::generate_create_status_chunk(statuses, "pulling manifest");
+                return create_response(stream, statuses, {}, "pull model manifest: file does not exist");
+            }
+
+            fmt::format_to(std::back_inserter(statuses), "{{\"status\":\"using existing layer sha256:{}\"}}\n",
+                           utils::fake_data::generate_digest(base->info.digest));
+
+            // Each new layer changes the manifest, and with it the model's digest.
+            std::string manifest = base->info.digest;
+            uint64_t layer_bytes = 0;
+            for (const char* field : layer_fields)
+            {
+                const auto it = request_body.find(field);
+                if (it == request_body.end() || it->is_null())
+                {
+                    continue;
+                }
+                const std::string layer = it->dump();
+                const std::string layer_digest = utils::fake_data::generate_digest(layer);
+                fmt::format_to(std::back_inserter(statuses), "{{\"status\":\"creating new layer sha256:{}\"}}\n",
+                               layer_digest);
+                manifest.append(layer_digest);
+                layer_bytes += layer.size();
+            }
+
+            std::shared_ptr<const state::ModelPayload> payload = std::move(base);
+            if (layer_bytes > 0)
+            {
+                state::ModelPayload created = *payload; // still shares the base model's /api/show details
+                created.info.digest = utils::fake_data::generate_digest(manifest);
+                created.info.size += layer_bytes;
+                payload = std::make_shared<const state::ModelPayload>(std::move(created));
+            }
+
+            utils::fake_data::generate_create_status_chunk(statuses, "writing manifest");
+            if (!state->add_model(req.remote_ip_address, model_name, std::move(payload)))
+            {
+                logger->info("/api/create of '{}' refused: overlay for {} is full.", model_name,
+                             req.remote_ip_address);
+                return create_response(stream, statuses, {}, "write manifest: no space left on device");
+            }
+            utils::fake_data::generate_create_status_chunk(statuses, "success");
+            return create_response(stream, statuses, "success", {});
+        }
+        catch (const std::exception& e)
+        {
+            logger->error("Error handling /api/create: {}", e.what());
+            return {crow::status::INTERNAL_SERVER_ERROR, "Internal Server Error"};
+        }
+    }
+} // namespace honeypot::api
@@ -0,0 +1,21 @@
+#include <string_view>
+
+#include "api/not_found.hpp"
+
+namespace honeypot::api
+{
+	namespace
+	{
+		// Byte-for-byte what gin's default NoRoute handler writes.
+		constexpr std::string_view not_found_body = "404 page not found";
+		constexpr std::string_view not_found_content_type = "text/plain";
+	}
+
+	crow::response handle_not_found()
+	{
+		crow::response res(crow::status::NOT_FOUND);
+		res.set_header("Content-Type", std::string(not_found_content_type));
+		res.body.assign(not_found_body);
+		return res;
+	}
+} // namespace honeypot::api
@@ -0,0 +1,446 @@
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <fmt/core.h>
+#include <nlohmann/json.hpp>
+
+#include "api/generation.hpp"
+#include "api/openai.hpp"
+#include "state/honeypot_state.hpp"
+#include "utils/etag.hpp"
+#include "utils/fake_data.hpp"
+#include "utils/latency_model.hpp"
+#include "utils/logging.hpp"
+#include "utils/tokenizer.hpp"
+
+namespace honeypot::api
+{
+    namespace
+    {
+        using utils::fake_data::TemplateKind;
+        using utils::fake_data::append_json_escaped;
+        using namespace generation;
+
+        constexpr size_t default_embedding_dimensions = 768;
+        constexpr size_t max_embedding_dimensions = 4096;
+        constexpr size_t max_embedding_inputs = 256;
+
+        struct OpenAiRequest
+        {
+            TemplateKind kind = TemplateKind::chat;
+            std::string model;
+            std::string prompt_text; // text the reply is about (prompt or last user message)
+            uint64_t prompt_tokens = 0;
+            bool stream = false;        // OpenAI clients stream only when asked to
+            bool include_usage = false; // stream_options.include_usage
+            uint32_t max_pieces = default_max_pieces;
+            bool cold_load = false;
+            std::shared_ptr<const state::ModelPayload> payload; // the model as the source sees it, for latency
+        };
+
+        crow::response openai_error(const int code, const std::string_view message, const std::string_view type)
+        {
+            std::string body = R"({"error":{"message":")";
+            append_json_escaped(body, message);
+            body.append(R"(","type":")");
+            body.append(type);
+            body.append(R"(","param":null,"code":null}})");
+
+            crow::response res(code);
+            res.set_header("Content-Type", "application/json");
+            res.body = std::move(body);
+            return res;
+        }
+
+        uint32_t parse_max_tokens(const nlohmann::ordered_json& body)
+        {
+            for (const char* field : {"max_completion_tokens", "max_tokens"})
+            {
+                const auto it = body.find(field);
+                if (it != body.end() && it->is_number_integer() && it->get<int64_t>() > 0)
+                {
+                    return static_cast<uint32_t>(std::min<int64_t>(it->get<int64_t>(), default_max_pieces));
+                }
+            }
+            return default_max_pieces;
+        }
+
+        // Message content is either a string or an array of parts, of which only text parts count.
+        std::string message_text(const nlohmann::ordered_json& content)
+        {
+            if (content.is_string())
+            {
+                return content.get<std::string>();
+            }
+            std::string text;
+            if (content.is_array())
+            {
+                for (const auto& part : content)
+                {
+                    if (part.is_object() && string_field(part, "type") == "text")
+                    {
+                        text.append(string_field(part, "text"));
+                    }
+                }
+            }
+            return text;
+        }
+
+        /**
+         * Parses the body, checks the model and simulates its load, as parse_common does for the
+         * native routes. Returns an error response if the request cannot be served.
+         */
+        std::optional<crow::response> parse_request(const std::shared_ptr<state::HoneypotState>& state,
+                                                    const crow::request& req, const std::string_view endpoint,
+                                                    nlohmann::ordered_json& request_body, OpenAiRequest& request)
+        {
+            const auto logger = utils::get_operational_logger();
+
+            try
+            {
+                request_body = nlohmann::ordered_json::parse(req.body);
+            }
+            catch (const nlohmann::json::parse_error& e)
+            {
+                logger->warn("{} request body failed JSON parsing: {}", endpoint, e.what());
+                return openai_error(crow::status::BAD_REQUEST, "invalid request body", "invalid_request_error");
+            }
+
+            if (!request_body.is_object() || !request_body.contains("model") || !request_body["model"].is_string()
+                || request_body["model"].get_ref<const std::string&>().empty())
+            {
+                logger->warn("{} request missing 'model' field.", endpoint);
+                return openai_error(crow::status::BAD_REQUEST, "model is required", "invalid_request_error");
+            }
+            request.model = request_body["model"].get<std::string>();
+            if (const auto stream = request_body.find("stream"); stream != request_body.end() && stream->is_boolean())
+            {
+                request.stream = stream->get<bool>();
+            }
+            if (const auto options = request_body.find("stream_options"); options != request_body.end()
+                && options->is_object())
+            {
+                const auto include_usage = options->find("include_usage");
+                request.include_usage = include_usage != options->end() && include_usage->is_boolean()
+                    && include_usage->get<bool>();
+            }
+            request.max_pieces = parse_max_tokens(request_body);
+
+            const auto load_result = state->load_or_update_model(req.remote_ip_address, request.model,
+                                                                  default_keep_alive);
+            if (load_result == state::ModelLoadResult::not_found)
+            {
+                logger->info("{} requested unknown model '{}'.", endpoint, request.model);
+                return openai_error(crow::status::NOT_FOUND,
+                                    fmt::format("model \"{}\" not found, try pulling it first", request.model),
+                                    "api_error");
+            }
+            request.cold_load = load_result == state::ModelLoadResult::cold;
+            request.payload = state->find_model(req.remote_ip_address, request.model);
+            return std::nullopt;
+        }
+
+        /**
+         * Writes the envelope every chunk and the final object share, up to the opening of
+         * "choices": id, object, created, model and system_fingerprint.
+         */
+        std::string make_envelope(const OpenAiRequest& request, const std::string_view object)
+        {
+            const bool chat = request.kind == TemplateKind::chat;
+            const int64_t created = std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+
+            std::string envelope = fmt::format(R"({{"id":"{}-{}","object":"{}","created":{},"model":")",
+                                               chat ? "chatcmpl" : "cmpl", random_seed() % 1000, object, created);
+            append_json_escaped(envelope, request.model);
+            envelope.append(R"(","system_fingerprint":"fp_ollama","choices":[)");
+            return envelope;
+        }
+
+        void append_usage(std::string& out, const uint64_t prompt_tokens, const uint64_t completion_tokens)
+        {
+            fmt::format_to(std::back_inserter(out),
+                           R"("usage":{{"prompt_tokens":{},"completion_tokens":{},"total_tokens":{}}})",
+                           prompt_tokens, completion_tokens, prompt_tokens + completion_tokens);
+        }
+
+        /**
+         * Generates the reply and writes either the SSE stream or the single completion object.
+         * Stream chunks differ only in their content, so each is the pre-rendered frame head,
+         * the escaped piece and a constant tail.
+         */
+        Completion run_openai_generation(const OpenAiRequest& request,
+                                         const std::shared_ptr<const utils::BpeTokenizer>& tokenizer)
+        {
+            const bool chat = request.kind == TemplateKind::chat;
+            const uint64_t seed = random_seed();
+            utils::fake_data::TextPieceSource source(request.kind, request.model, request.prompt_text, seed,
+                                                     target_pieces(seed), request.max_pieces);
+
+            const std::string envelope = make_envelope(request, request.stream
+                ? (chat ? "chat.completion.chunk" : "text_completion")
+                : (chat ? "chat.completion" : "text_completion"));
+            const std::string frame_head = "data: " + envelope
+                + (chat ? R"({"index":0,"delta":{"role":"assistant","content":")" : R"({"text":")");
+            const std::string_view content_tail = chat ? R"("})" : R"(","index":0,"logprobs":null)";
+
+            std::string body;
+            std::string full_text;
+            for (std::string_view piece = source.next(); !piece.empty(); piece = source.next())
+            {
+                full_text.append(piece);
+                if (request.stream)
+                {
+                    body.append(frame_head);
+                    append_json_escaped(body, piece);
+                    body.append(content_tail);
+                    body.append(",\"finish_reason\":null}]}\n\n");
+                }
+            }
+
+            const uint64_t completion_tokens = count_tokens(tokenizer, full_text);
+            const std::string_view finish_reason = source.pieces_emitted() >= request.max_pieces ? "length" : "stop";
+            if (request.stream)
+            {
+                body.append(frame_head);
+                body.append(content_tail);
+                fmt::format_to(std::back_inserter(body), ",\"finish_reason\":\"{}\"}}]}}\n\n", finish_reason);
+                if (request.include_usage)
+                {
+                    body.append("data: ");
+                    body.append(envelope);
+                    body.append("],");
+                    append_usage(body, request.prompt_tokens, completion_tokens);
+                    body.append("}\n\n");
+                }
+                body.append("data: [DONE]\n\n");
+            }
+            else
+            {
+                body = envelope;
+                body.append(chat ? R"({"index":0,"message":{"role":"assistant","content":")" : R"({"text":")");
+                append_json_escaped(body, full_text);
+                body.append(content_tail);
+                fmt::format_to(std::back_inserter(body), ",\"finish_reason\":\"{}\"}}],", finish_reason);
+                append_usage(body, request.prompt_tokens, completion_tokens);
+                body.append("}");
+            }
+
+            const utils::SimulatedTiming timing = utils::get_latency_model().simulate(
+                model_info(request.payload), request.cold_load, request.prompt_tokens, completion_tokens);
+            Completion completion{crow::response(crow::status::OK), timing.total()};
+            completion.response.set_header("Content-Type", request.stream ? "text/event-stream" : "application/json");
+            completion.response.body = std::move(body);
+            return completion;
+        }
+    }
+
+    void handle_openai_chat(const std::shared_ptr<state::HoneypotState>& state, const crow::request& req,
+                            crow::response& res, const std::chrono::milliseconds tarpit_hold)
+    {
+        const auto logger = utils::get_operational_logger();
+        logger->debug("Handling POST /v1/chat/completions request.");
+
+        try
+        {
+            nlohmann::ordered_json request_body;
+            OpenAiRequest request;
+            request.kind = TemplateKind::chat;
+            if (auto error = parse_request(state, req, "/v1/chat/completions", request_body, request))
+            {
+                return fail(req, res, std::move(*error), tarpit_hold);
+            }
+
+            const auto messages = request_body.find("messages");
+            if (messages == request_body.end() || !messages->is_array() || messages->empty())
+            {
+                return fail(req, res, openai_error(crow::status::BAD_REQUEST, "[] is too short - 'messages'",
+                                                   "invalid_request_error"), tarpit_hold);
+            }
+
+            const auto tokenizer = state->get_tokenizer(req.remote_ip_address, request.model);
+            request.prompt_tokens = chat_base_tokens;
+            size_t tokenize_budget = max_tokenized_bytes;
+            for (const auto& message : *messages)
+            {
+                if (!message.is_object())
+                {
+                    return fail(req, res, openai_error(crow::status::BAD_REQUEST, "invalid message format",
+                                                       "invalid_request_error"), tarpit_hold);
+                }
+                const std::string content = message_text(message.value("content", nlohmann::ordered_json{}));
+                request.prompt_tokens += chat_message_tokens + count_tokens(tokenizer, content, tokenize_budget);
+                if (string_field(message, "role") == "user")
+                {
+                    request.prompt_text = content;
+                }
+            }
+
+            complete_after(req, res, run_openai_generation(request, tokenizer), tarpit_hold);
+        }
+        catch (const std::exception& e)
+        {
+            logger->error("Error handling /v1/chat/completions: {}", e.what());
+            fail(req, res, openai_error(crow::status::INTERNAL_SERVER_ERROR, "internal server error", "api_error"),
+                 tarpit_hold);
+        }
+    }
+
+    void handle_openai_completion(const std::shared_ptr<state::HoneypotState>& state, const crow::request& req,
+                                  crow::response& res, const std::chrono::milliseconds tarpit_hold)
+    {
+        const auto logger = utils::get_operational_logger();
+        logger->debug("Handling POST /v1/completions request.");
+
+        try
+        {
+            nlohmann::ordered_json request_body;
+            OpenAiRequest request;
+            request.kind = TemplateKind::generate;
+            if (auto error = parse_request(state, req, "/v1/completions", request_body, request))
+            {
+                return fail(req, res, std::move(*error), tarpit_hold);
+            }
+
+            // The prompt may be a string or a list of them; like Ollama, only the first is answered.
+            const auto prompt = request_body.find("prompt");
+            if (prompt != request_body.end() && prompt->is_string())
+            {
+                request.prompt_text = prompt->get<std::string>();
+            }
+            else if (prompt != request_body.end() && prompt->is_array() && !prompt->empty()
+                && prompt->front().is_string())
+            {
+                request.prompt_text = prompt->front().get<std::string>();
+            }
+            else
+            {
+                return fail(req, res, openai_error(crow::status::BAD_REQUEST, "prompt is required",
+                                                   "invalid_request_error"), tarpit_hold);
+            }
+
+            const auto tokenizer = state->get_tokenizer(req.remote_ip_address, request.model);
+            size_t tokenize_budget = max_tokenized_bytes;
+            request.prompt_tokens = generate_template_tokens
+                + count_tokens(tokenizer, request.prompt_text, tokenize_budget);
+
+            complete_after(req, res, run_openai_generation(request, tokenizer), tarpit_hold);
+        }
+        catch (const std::exception& e)
+        {
+            logger->error("Error handling /v1/completions: {}", e.what());
+            fail(req, res, openai_error(crow::status::INTERNAL_SERVER_ERROR, "internal server error", "api_error"),
+                 tarpit_hold);
+        }
+    }
+
+    void handle_openai_embeddings(const std::shared_ptr<state::HoneypotState>& state, const crow::request& req,
+                                  crow::response& res, const std::chrono::milliseconds tarpit_hold)
+    {
+        const auto logger = utils::get_operational_logger();
+        logger->debug("Handling POST /v1/embeddings request.");
+
+        try
+        {
+            nlohmann::ordered_json request_body;
+            OpenAiRequest request;
+            if (auto error = parse_request(state, req, "/v1/embeddings", request_body, request))
+            {
+                return fail(req, res, std::move(*error), tarpit_hold);
+            }
+
+            std::vector<std::string> inputs;
+            const auto input = request_body.find("input");
+            if (input != request_body.end() && input->is_string())
+            {
+                inputs.push_back(input->get<std::string>());
+            }
+            else if (input != request_body.end() && input->is_array())
+            {
+                for (const auto& item : *input)
+                {
+                    if (!item.is_string() || inputs.size() == max_embedding_inputs)
+                    {
+                        return fail(req, res, openai_error(crow::status::BAD_REQUEST, "invalid input type",
+                                                           "invalid_request_error"), tarpit_hold);
+                    }
+                    inputs.push_back(item.get<std::string>());
+                }
+            }
+            if (inputs.empty())
+            {
+                return fail(req, res, openai_error(crow::status::BAD_REQUEST, "invalid input", "invalid_request_error"),
+                            tarpit_hold);
+            }
+
+            size_t dimensions = default_embedding_dimensions;
+            if (const auto requested = request_body.find("dimensions"); requested != request_body.end()
+                && requested->is_number_integer() && requested->get<int64_t>() > 0)
+            {
+                dimensions = static_cast<size_t>(std::min<int64_t>(requested->get<int64_t>(), max_embedding_dimensions));
+            }
+
+            const auto tokenizer = state->get_tokenizer(req.remote_ip_address, request.model);
+            std::string body = R"({"object":"list","data":[)";
+            uint64_t prompt_tokens = 0;
+            size_t tokenize_budget = max_tokenized_bytes;
+            for (size_t i = 0; i < inputs.size(); ++i)
+            {
+                prompt_tokens += count_tokens(tokenizer, inputs[i], tokenize_budget);
+                body.append(i == 0 ? R"({"object":"embedding","embedding":)" : R"(,{"object":"embedding","embedding":)");
+                utils::fake_data::generate_embedding(body, inputs[i], dimensions);
+                fmt::format_to(std::back_inserter(body), R"(,"index":{}}})", i);
+            }
+            body.append(R"(],"model":")");
+            append_json_escaped(body, request.model);
+            fmt::format_to(std::back_inserter(body), R"(","usage":{{"prompt_tokens":{},"total_tokens":{}}}}})",
+                           prompt_tokens, prompt_tokens);
+
+            const utils::SimulatedTiming timing = utils::get_latency_model().simulate(
+                model_info(request.payload), request.cold_load, prompt_tokens, 0);
+            Completion completion{crow::response(crow::status::OK), timing.total()};
+            completion.response.set_header("Content-Type", "application/json");
+            completion.response.body = std::move(body);
+            complete_after(req, res, std::move(completion), tarpit_hold);
+        }
+        catch (const std::exception& e)
+        {
+            logger->error("Error handling /v1/embeddings: {}", e.what());
+            fail(req, res, openai_error(crow::status::INTERNAL_SERVER_ERROR, "internal server error", "api_error"),
+                 tarpit_hold);
+        }
+    }
+
+    crow::response handle_openai_models(const std::shared_ptr<state::HoneypotState>& state,
+                                        const crow::request& req)
+    {
+        const auto logger = utils::get_operational_logger();
+        logger->debug("Handling GET /v1/models request.");
+
+        try
+        {
+            const std::shared_ptr<const state::CachedBody> models_body =
+                state->get_catalog_body(req.remote_ip_address, state::CatalogView::openai_models);
+
+            if (utils::request_matches_etag(req, models_body->etag))
+            {
+                return utils::make_not_modified(models_body->etag);
+            }
+
+            crow::response res(crow::status::OK);
+            res.set_header("Content-Type", "application/json");
+            res.set_header("ETag", models_body->etag);
+            res.body = models_body->body;
+            return res;
+        }
+        catch (const std::exception& e)
+        {
+            logger->error("Error handling /v1/models: {}", e.what());
+            return openai_error(crow::status::INTERNAL_SERVER_ERROR, "internal server error", "api_error");
+        }
+    }
+} // namespace honeypot::api
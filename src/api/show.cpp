@@ -11,8 +11,11 @@
 #include "api/show.hpp"
 #include "state/honeypot_state.hpp"
 #include "utils/config.hpp"
+#include "utils/etag.hpp"
 #include "utils/fake_data.hpp"
 #include "utils/logging.hpp"
+#include "utils/request_arena.hpp"
+#include "utils/trace.hpp"
 
 namespace fs = std::filesystem;
 
@@ -26,22 +29,24 @@ namespace honeypot::api
         auto logger = utils::get_operational_logger();
         logger->debug("Handling POST /api/show request.");
 
-        nlohmann::ordered_json request_body;
+        utils::ArenaScope arena; // the parsed body and error messages live until the handler returns
+        utils::ArenaJson request_body;
         try
         {
             if (req.body.empty())
             {
                 logger->warn("/api/show request received with empty body.");
-                return {crow::status::BAD_REQUEST, utils::fake_data::generate_error("missing request body").dump()};
+                return {crow::status::BAD_REQUEST, utils::fake_data::generate_error_body("missing request body")};
             }
-            request_body = nlohmann::ordered_json::parse(req.body);
+            utils::TraceSpan span("show request parse");
+            request_body = utils::ArenaJson::parse(req.body);
         }
-        catch (const nlohmann::ordered_json::parse_error& e)
+        catch (const utils::ArenaJson::parse_error& e)
         {
             logger->warn("/api/show failed to parse request body: {}", e.what());
             return {
                 crow::status::BAD_REQUEST,
-                utils::fake_data::generate_error("invalid json request format").dump()
+                utils::fake_data::generate_error_body("invalid json request format")
             };
         }
 
@@ -50,11 +55,11 @@ namespace honeypot::api
             logger->warn("/api/show request body missing 'model' key or it's not a string.");
             return {
                 crow::status::BAD_REQUEST,
-                utils::fake_data::generate_error("missing 'model' field in request body").dump()
+                utils::fake_data::generate_error_body("missing 'model' field in request body")
             };
         }
 
-        const std::string& model_name = request_body["model"];
+        const std::string_view model_name = request_body["model"].get_ref<const utils::ArenaString&>();
 
         bool verbose = false;
         if (request_body.contains("verbose") && request_body["verbose"].is_boolean())
@@ -63,87 +68,64 @@ namespace honeypot::api
         }
         logger->debug("/api/show request for model: '{}', verbose: {}", model_name, verbose);
 
-        std::optional<std::string> relative_detail_path_opt = state_ptr->get_detail_file_path(model_name);
+        std::optional<std::string> relative_detail_path_opt =
+            state_ptr->get_detail_file_path(req.remote_ip_address, model_name);
 
         if (!relative_detail_path_opt)
         {
             logger->info("Model '{}' not found in show_file_map for /api/show request.", model_name);
-            auto error_json = utils::fake_data::generate_error(fmt::format("model '{}' not found", model_name));
-            return {crow::status::NOT_FOUND, error_json.dump()};
+            return {
+                crow::status::NOT_FOUND,
+                utils::fake_data::generate_error_body(utils::arena_format("model '{}' not found", model_name))
+            };
         }
         const std::string& relative_detail_path = *relative_detail_path_opt;
 
-        fs::path full_detail_path = "config" / fs::path(relative_detail_path);
-
-        std::optional<nlohmann::ordered_json> cached_json_opt = state_ptr->get_cached_detail(full_detail_path.string());
-        nlohmann::ordered_json model_details_json;
+        const std::string full_detail_path = state::HoneypotState::resolve_detail_path(relative_detail_path);
 
-        if (cached_json_opt)
+        std::shared_ptr<const state::CachedDetail> cached_detail;
+        try
         {
-            logger->debug("Cache hit for /api/show detail file: {}", full_detail_path.string());
-            model_details_json = *cached_json_opt;
+            cached_detail = state_ptr->load_detail(full_detail_path);
         }
-        else
+        catch (const nlohmann::ordered_json::parse_error& e)
         {
-            logger->debug("Cache miss for /api/show detail file: {}. Loading from disk.", full_detail_path.string());
-            std::ifstream detail_file(full_detail_path);
-            if (!detail_file.is_open())
-            {
-                logger->error("Failed to open detail file '{}' for model '{}'", full_detail_path.string(), model_name);
-                return {
-                    crow::status::INTERNAL_SERVER_ERROR,
-                    utils::fake_data::generate_error(
-                        fmt::format("internal error: detail file for model '{}' missing or unreadable",
-                                    model_name)).dump()
-                };
-            }
-
-            try
-            {
-                model_details_json = nlohmann::ordered_json::parse(detail_file);
-                state_ptr->cache_detail(full_detail_path.string(), model_details_json);
-                logger->debug("Successfully loaded and cached detail file: {}", full_detail_path.string());
-            }
-            catch (const nlohmann::ordered_json::parse_error& e)
-            {
-                logger->error("Failed to parse JSON detail file '{}' for model '{}': {}", full_detail_path.string(),
-                              model_name, e.what());
-                return {
-                    crow::status::INTERNAL_SERVER_ERROR,
-                    utils::fake_data::generate_error(
-                        fmt::format("internal error: detail file for model '{}' is invalid JSON", model_name)).dump()
-                };
-            } catch (const std::exception& e)
-            {
-                logger->error("Error reading detail file '{}' for model '{}': {}", full_detail_path.string(),
-                              model_name, e.what());
-                return {crow::status::INTERNAL_SERVER_ERROR, "Internal Server Error reading details"};
-            }
+            logger->error("Failed to parse JSON detail file '{}' for model '{}': {}", full_detail_path,
+                          model_name, e.what());
+            return {
+                crow::status::INTERNAL_SERVER_ERROR,
+                utils::fake_data::generate_error_body(
+                    utils::arena_format("internal error: detail file for model '{}' is invalid JSON", model_name))
+            };
+        } catch (const std::ios_base::failure& e)
+        {
+            logger->error("Failed to open detail file '{}' for model '{}'", full_detail_path, model_name);
+            return {
+                crow::status::INTERNAL_SERVER_ERROR,
+                utils::fake_data::generate_error_body(
+                    utils::arena_format("internal error: detail file for model '{}' missing or unreadable",
+                                        model_name))
+            };
+        } catch (const std::exception& e)
+        {
+            logger->error("Error reading detail file '{}' for model '{}': {}", full_detail_path,
+                          model_name, e.what());
+            return {crow::status::INTERNAL_SERVER_ERROR, "Internal Server Error reading details"};
         }
 
-
         // handle 'verbose' Flag
-        if (!verbose)
-        {
-            logger->debug("Verbose flag is false, removing verbose fields from response.");
-            if (model_details_json.contains("model_info") && model_details_json["model_info"].is_object())
-            {
-                auto& model_info = model_details_json["model_info"];
+        const state::CachedBody& detail_body = verbose ? cached_detail->verbose : cached_detail->brief;
 
-                model_info["tokenizer.ggml.merges"] = nullptr;
-                model_info["tokenizer.ggml.token_type"] = nullptr;
-                model_info["tokenizer.ggml.tokens"] = nullptr;
-            }
-            else
-            {
-                logger->warn("'/api/show' response JSON for '{}' unexpectedly missing 'model_info' object.",
-                             model_name);
-            }
+        if (utils::request_matches_etag(req, detail_body.etag))
+        {
+            logger->debug("/api/show If-None-Match hit for '{}', returning 304.", model_name);
+            return utils::make_not_modified(detail_body.etag);
         }
 
         crow::response res(crow::status::OK);
         res.set_header("Content-Type", "application/json");
-        res.body = model_details_json.dump();
+        res.set_header("ETag", detail_body.etag);
+        res.body = detail_body.body;
         return res;
     }
 } // namespace honeypot::api
@@ -5,26 +5,31 @@
 
 #include "api/tags.hpp"
 #include "state/honeypot_state.hpp"
-#include "utils/fake_data.hpp"
+#include "utils/etag.hpp"
 #include "utils/logging.hpp"
 
 
 namespace honeypot::api
 {
-	crow::response handle_tags(const std::shared_ptr<state::HoneypotState>& state)
+	crow::response handle_tags(const std::shared_ptr<state::HoneypotState>& state, const crow::request& req)
 	{
 		const auto logger = utils::get_operational_logger();
 		logger->debug("Handling GET /api/tags request.");
 
 		try
 		{
-			const std::vector<config::TagModelInfo>& current_models = state->get_available_models();
+			const std::shared_ptr<const state::CachedBody> tags_body = state->get_tags_body(req.remote_ip_address);
 
-			const nlohmann::ordered_json response_json = utils::fake_data::generate_model_list_json(current_models);
+			if (utils::request_matches_etag(req, tags_body->etag))
+			{
+				logger->debug("/api/tags If-None-Match hit, returning 304.");
+				return utils::make_not_modified(tags_body->etag);
+			}
 
 			crow::response res(crow::status::OK); // 200 OK
 			res.set_header("Content-Type", "application/json");
-			res.body = response_json.dump();
+			res.set_header("ETag", tags_body->etag);
+			res.body = tags_body->body;
 			return res;
 		}
 		catch (const std::exception& e)
@@ -1,17 +1,16 @@
 #include "api/version.hpp"
-#include "utils/config.hpp"
 #include "utils/logging.hpp"
 
 #include <nlohmann/json.hpp>
 
 namespace honeypot::api
 {
-	crow::response handle_version(const config::HoneypotConfig& config)
+	crow::response handle_version(const std::string_view version)
 	{
 		try
 		{
 			nlohmann::json response_json;
-			response_json["version"] = config.api_behavior.ollama_version;
+			response_json["version"] = version;
 
 			crow::response res(crow::status::OK);
 			res.set_header("Content-Type", "application/json");
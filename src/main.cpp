@@ -3,17 +3,43 @@
 #include <memory>
 #include <vector>
 #include <string_view>
+#include <csignal>
+#include <chrono>
+#include <algorithm>
+#include <charconv>
+#include <map>
+#include <ranges>
+#include <stdexcept>
 
 #include <crow.h>
 
 
+#include "utils/admin.hpp"
+#include "utils/admission.hpp"
+#include "utils/client_fingerprint.hpp"
 #include "utils/config.hpp"
+#include "utils/fast_path.hpp"
+#include "utils/fake_data.hpp"
+#include "utils/ip_index.hpp"
+#include "utils/latency_model.hpp"
 #include "utils/logging.hpp"
+#include "utils/probe_classifier.hpp"
+#include "utils/prompt_classifier.hpp"
+#include "utils/request_arena.hpp"
+#include "utils/response_templates.hpp"
+#include "utils/signals.hpp"
+#include "utils/tarpit.hpp"
+#include "utils/trace.hpp"
 #include "state/honeypot_state.hpp"
+#include "state/snapshot.hpp"
 #include "api/version.hpp"
 #include "api/delete.hpp"
 #include "api/tags.hpp"
 #include "api/show.hpp"
+#include "api/model_handlers.hpp"
+#include "api/generate_handlers.hpp"
+#include "api/openai.hpp"
+#include "api/not_found.hpp"
 
 namespace
 {
@@ -22,21 +48,232 @@ namespace
     {
         struct context
         {
+            std::chrono::milliseconds tarpit_hold{0};
+            std::string_view probe_class{}; // set by the catch-all route, points at static storage
+            honeypot::utils::Tracer::RequestTrace trace{};
+            honeypot::utils::AdmissionController::Decision admission{};
+            honeypot::utils::ClientFingerprint client_fingerprint{};
+            const honeypot::utils::ListenerIdentity* listener = nullptr; // set when the front listener forwarded it
         };
 
-        void before_handle(crow::request&, crow::response&, context&)
+        void before_handle(crow::request& req, crow::response& res, context& ctx)
         {
+            const auto forwarded = honeypot::utils::adopt_forwarded_peer(req);
+            ctx.listener = forwarded.listener;
+            ctx.client_fingerprint = forwarded.fingerprint.empty()
+                                         ? honeypot::utils::ClientFingerprint::of_request(req)
+                                         : forwarded.fingerprint;
+            ctx.trace = honeypot::utils::get_tracer().begin_request();
+            ctx.tarpit_hold = honeypot::utils::get_tarpit().observe(req.remote_ip_address);
+            // Completing res here skips the route; Crow still runs after_handle, so sheds are logged.
+            ctx.admission = honeypot::utils::get_admission().admit(req, res, ctx.tarpit_hold.count() > 0);
         }
 
-        void after_handle(crow::request& req, crow::response& res, context&)
+        void after_handle(crow::request& req, crow::response& res, context& ctx)
         {
-            honeypot::utils::log_request(req, res);
+            // Held and streamed responses finish on whichever thread completed them.
+            honeypot::utils::Tracer::resume_request(ctx.trace);
+            // Whatever the record needs comes from this thread's arena, released in one reset on return.
+            honeypot::utils::ArenaScope arena;
+            honeypot::utils::get_admission().release(req, res, ctx.admission);
+            honeypot::utils::log_request(req, res, {
+                                             .probe_class = ctx.probe_class,
+                                             .client_fingerprint = ctx.client_fingerprint.view(),
+                                             .listener = ctx.listener ? ctx.listener->name : std::string_view{},
+                                         });
+            honeypot::utils::get_tracer().end_request(ctx.trace, "request");
         }
     };
+
+    using HoneypotApp = crow::App<RequestLoggingMiddleware>;
+
+    // How long the middleware decided to hold this request's response; zero for most sources.
+    std::chrono::milliseconds tarpit_hold(HoneypotApp& app, const crow::request& req)
+    {
+        return app.get_context<RequestLoggingMiddleware>(req).tarpit_hold;
+    }
+
+    // Completes a route's response, held first if the middleware tarpitted its source.
+    void respond(HoneypotApp& app, const crow::request& req, crow::response& res, crow::response ready)
+    {
+        honeypot::utils::get_tarpit().complete(req, res, std::move(ready), tarpit_hold(app, req));
+    }
+
+    // Re-reads the data files that can change without a restart (SIGHUP or the admin "reload").
+    void reload_data_files()
+    {
+        honeypot::utils::fake_data::reload_response_templates();
+        honeypot::utils::reload_ip_index();
+        honeypot::utils::reload_prompt_classifier();
+    }
+
+    nlohmann::json detail_cache_json(const honeypot::state::DetailCacheStats& stats)
+    {
+        return {{"entries", stats.entries}, {"bytes", stats.bytes}, {"budget", stats.budget}};
+    }
+
+    void register_admin_commands(honeypot::utils::AdminServer& admin,
+                                 std::shared_ptr<const honeypot::config::HoneypotConfig> config,
+                                 std::shared_ptr<honeypot::state::HoneypotState> state,
+                                 honeypot::state::StateSnapshotter& snapshotter)
+    {
+        using nlohmann::json;
+        const auto started = std::chrono::steady_clock::now();
+
+        admin.on_command("status", "status", [state, started](std::string_view) {
+            const auto admission = honeypot::utils::get_admission().stats();
+            const auto level = spdlog::level::to_string_view(honeypot::utils::get_operational_logger()->level());
+            return json{
+                {"uptime_seconds", std::chrono::duration_cast<std::chrono::seconds>(
+                    std::chrono::steady_clock::now() - started).count()},
+                {"revision", state->revision()},
+                {"generation", state->generation()},
+                {"sessions", state->live_sessions().size()},
+                {"detail_cache", detail_cache_json(state->detail_cache_stats())},
+                {"admission", {
+                    {"enabled", honeypot::utils::get_admission().enabled()},
+                    {"admitted", admission.admitted},
+                    {"shed_flagged", admission.shed_flagged},
+                    {"shed_repeated", admission.shed_repeated},
+                    {"overload_episodes", admission.overload_episodes},
+                    {"queue_delay_us", admission.queue_delay_us},
+                    {"in_flight", admission.in_flight},
+                }},
+                {"tracing", honeypot::utils::get_tracer().enabled()},
+                {"log_level", std::string(level.data(), level.size())},
+            };
+        });
+
+        // Most recently seen first.
+        admin.on_command("sessions", "sessions [limit=100]", [state](const std::string_view argument) {
+            size_t limit = 100;
+            if (!argument.empty()
+                && std::from_chars(argument.data(), argument.data() + argument.size(), limit).ec != std::errc{})
+            {
+                throw std::invalid_argument("limit must be a number");
+            }
+            auto sessions = state->live_sessions();
+            std::ranges::sort(sessions, std::ranges::greater{}, [](const auto& session) {
+                return session.second.last_seen;
+            });
+
+            const auto now = std::chrono::steady_clock::now();
+            json listed = json::array();
+            for (const auto& [source, overlay] : sessions | std::views::take(limit))
+            {
+                json added = json::array();
+                for (const auto& model : overlay.added)
+                {
+                    added.push_back(model.name);
+                }
+                json loaded = json::array();
+                for (const auto& model : overlay.loaded)
+                {
+                    if (model.expires_at > now)
+                    {
+                        loaded.push_back({
+                            {"name", model.base_info.name},
+                            {"expires_in_seconds",
+                             std::chrono::duration_cast<std::chrono::seconds>(model.expires_at - now).count()},
+                            {"size_vram", model.size_vram},
+                        });
+                    }
+                }
+                listed.push_back({
+                    {"source", source},
+                    {"idle_seconds", std::chrono::duration_cast<std::chrono::seconds>(now - overlay.last_seen).count()},
+                    {"deleted", overlay.deleted},
+                    {"added", std::move(added)},
+                    {"loaded", std::move(loaded)},
+                });
+            }
+            return json{{"total", sessions.size()}, {"sessions", std::move(listed)}};
+        });
+
+        // The base catalog, with how many sources currently have each model loaded.
+        admin.on_command("models", "models", [state](std::string_view) {
+            const auto now = std::chrono::steady_clock::now();
+            std::map<std::string, size_t, std::less<>> loaded_by;
+            for (const auto& overlay : state->live_sessions() | std::views::values)
+            {
+                for (const auto& model : overlay.loaded)
+                {
+                    if (model.expires_at > now)
+                    {
+                        ++loaded_by[model.base_info.name];
+                    }
+                }
+            }
+
+            json models = json::array();
+            for (const auto& model : state->get_available_models({}))
+            {
+                const auto it = loaded_by.find(model.name);
+                models.push_back({
+                    {"name", model.name},
+                    {"size", model.size},
+                    {"parameter_size", model.details.parameter_size},
+                    {"loaded_by", it == loaded_by.end() ? 0 : it->second},
+                });
+            }
+            return json{{"models", std::move(models)}, {"detail_cache", detail_cache_json(state->detail_cache_stats())}};
+        });
+
+        admin.on_command("flush-caches", "flush-caches", [state](std::string_view) {
+            const auto flushed = state->flush_caches();
+            honeypot::utils::get_operational_logger()->info(
+                "Admin flushed the caches ({} details, {} bytes).", flushed.entries, flushed.bytes);
+            return json{{"flushed_detail_cache", detail_cache_json(flushed)}};
+        });
+
+        admin.on_command("snapshot", "snapshot", [config, state, &snapshotter](std::string_view) {
+            if (!snapshotter.write_now())
+            {
+                throw std::runtime_error("no snapshot written: snapshots are disabled or the write failed");
+            }
+            return json{{"path", config->snapshot.path}, {"revision", state->revision()}};
+        });
+
+        admin.on_command("log-level", "log-level [trace|debug|info|warn|error|critical|off]",
+                         [](const std::string_view argument) {
+                             const auto logger = honeypot::utils::get_operational_logger();
+                             if (!argument.empty())
+                             {
+                                 const auto level = spdlog::level::from_str(std::string(argument));
+                                 if (level == spdlog::level::off && argument != "off")
+                                 {
+                                     throw std::invalid_argument(fmt::format("unknown log level '{}'", argument));
+                                 }
+                                 logger->warn("Admin set the operational log level to '{}'.", argument);
+                                 logger->set_level(level);
+                             }
+                             const auto level = spdlog::level::to_string_view(logger->level());
+                             return json{{"log_level", std::string(level.data(), level.size())}};
+                         });
+
+        admin.on_command("reload", "reload", [](std::string_view) {
+            reload_data_files();
+            return json{{"reloaded", true}};
+        });
+
+        admin.on_command("trace-dump", "trace-dump [path]", [](const std::string_view argument) {
+            auto& tracer = honeypot::utils::get_tracer();
+            if (!tracer.enabled())
+            {
+                throw std::runtime_error("tracing is disabled");
+            }
+            const std::string path = argument.empty() ? tracer.dump_path() : std::string(argument);
+            return json{{"path", path}, {"spans", tracer.dump(path)}};
+        });
+    }
 } // end anonymous namespace
 
 int main(int argc, char* argv[])
 {
+    // Before logging, the snapshotter or any listener starts a thread, so all of them inherit the mask and
+    // SIGHUP or SIGUSR2 only ever reach the signal listener instead of terminating the process.
+    honeypot::utils::block_listener_signals();
+
     std::string config_path = "config/honeypot.json";
 
     std::vector<std::string_view> args(argv, argv + argc);
@@ -94,7 +331,31 @@ int main(int argc, char* argv[])
     }
     logger->info("Honeypot state initialized.");
 
-    crow::App<RequestLoggingMiddleware> app;
+    auto snapshotter = std::make_unique<honeypot::state::StateSnapshotter>(state_ptr, config_ptr->snapshot);
+
+    honeypot::utils::fake_data::init_response_templates(*config_ptr);
+    honeypot::utils::fake_data::init_text_model(*config_ptr);
+    honeypot::utils::init_latency_model(*config_ptr, state_ptr->get_available_models({}));
+    honeypot::utils::init_tarpit(*config_ptr);
+    honeypot::utils::init_admission(*config_ptr);
+    honeypot::utils::init_ip_index(*config_ptr);
+    honeypot::utils::init_prompt_classifier(*config_ptr);
+    honeypot::utils::init_tracing(*config_ptr);
+
+#ifndef _WIN32
+    honeypot::utils::on_signal(SIGHUP, reload_data_files);
+    if (honeypot::utils::get_tracer().enabled())
+    {
+        honeypot::utils::on_signal(SIGUSR2, [] {
+            auto& tracer = honeypot::utils::get_tracer();
+            const size_t spans = tracer.dump(tracer.dump_path());
+            honeypot::utils::get_operational_logger()->info("Wrote {} trace spans to '{}'.", spans,
+                                                             tracer.dump_path());
+        });
+    }
+#endif
+
+    HoneypotApp app;
     logger->info("Request logging middleware registered globally.");
     app.server_name("");
 
@@ -102,44 +363,161 @@ int main(int argc, char* argv[])
     // GET /api/version
     CROW_ROUTE(app, "/api/version")
             .methods(crow::HTTPMethod::Get)
-            ([config_ptr] {
-                // Only capture config needed
-                return honeypot::api::handle_version(*config_ptr);
+            ([&app, config_ptr](const crow::request& req, crow::response& res) {
+                // Each front-listener endpoint may present its own version.
+                const auto* listener = app.get_context<RequestLoggingMiddleware>(req).listener;
+                respond(app, req, res, honeypot::api::handle_version(
+                            listener ? listener->ollama_version : config_ptr->api_behavior.ollama_version));
             });
 
     // GET /api/tags
     CROW_ROUTE(app, "/api/tags")
             .methods(crow::HTTPMethod::Get)
-            ([state_ptr] {
+            ([&app, state_ptr] (const crow::request& req, crow::response& res) {
                 // Capture state
-                return honeypot::api::handle_tags(state_ptr);
+                respond(app, req, res, honeypot::api::handle_tags(state_ptr, req));
             });
 
     // DELETE /api/delete
     CROW_ROUTE(app, "/api/delete")
             .methods(crow::HTTPMethod::Delete)
-            ([state_ptr] (const crow::request& req) {
-                return honeypot::api::handle_delete(state_ptr, req);
+            ([&app, state_ptr] (const crow::request& req, crow::response& res) {
+                respond(app, req, res, honeypot::api::handle_delete(state_ptr, req));
             });
 
     // POST /api/show
     CROW_ROUTE(app, "/api/show")
     .methods(crow::HTTPMethod::Post)
-    ([config_ptr, state_ptr](const crow::request& req) {
-         return honeypot::api::handle_show(config_ptr, state_ptr, req);
+    ([&app, config_ptr, state_ptr](const crow::request& req, crow::response& res) {
+         respond(app, req, res, honeypot::api::handle_show(config_ptr, state_ptr, req));
      });
 
+    // POST /api/copy
+    CROW_ROUTE(app, "/api/copy")
+            .methods(crow::HTTPMethod::Post)
+            ([&app, state_ptr](const crow::request& req, crow::response& res) {
+                respond(app, req, res, honeypot::api::handle_copy(state_ptr, req));
+            });
+
+    // POST /api/create
+    CROW_ROUTE(app, "/api/create")
+            .methods(crow::HTTPMethod::Post)
+            ([&app, state_ptr](const crow::request& req, crow::response& res) {
+                respond(app, req, res, honeypot::api::handle_create(state_ptr, req));
+            });
+
+    // POST /api/generate
+    CROW_ROUTE(app, "/api/generate")
+            .methods(crow::HTTPMethod::Post)
+            ([&app, state_ptr](const crow::request& req, crow::response& res) {
+                honeypot::api::handle_generate(state_ptr, req, res, tarpit_hold(app, req));
+            });
+
+    // POST /api/chat
+    CROW_ROUTE(app, "/api/chat")
+            .methods(crow::HTTPMethod::Post)
+            ([&app, state_ptr](const crow::request& req, crow::response& res) {
+                honeypot::api::handle_chat(state_ptr, req, res, tarpit_hold(app, req));
+            });
+
+    // OpenAI-compatible routes, as served by Ollama under /v1.
+    CROW_ROUTE(app, "/v1/chat/completions")
+            .methods(crow::HTTPMethod::Post)
+            ([&app, state_ptr](const crow::request& req, crow::response& res) {
+                honeypot::api::handle_openai_chat(state_ptr, req, res, tarpit_hold(app, req));
+            });
+
+    CROW_ROUTE(app, "/v1/completions")
+            .methods(crow::HTTPMethod::Post)
+            ([&app, state_ptr](const crow::request& req, crow::response& res) {
+                honeypot::api::handle_openai_completion(state_ptr, req, res, tarpit_hold(app, req));
+            });
+
+    CROW_ROUTE(app, "/v1/embeddings")
+            .methods(crow::HTTPMethod::Post)
+            ([&app, state_ptr](const crow::request& req, crow::response& res) {
+                honeypot::api::handle_openai_embeddings(state_ptr, req, res, tarpit_hold(app, req));
+            });
+
+    CROW_ROUTE(app, "/v1/models")
+            .methods(crow::HTTPMethod::Get)
+            ([&app, state_ptr](const crow::request& req, crow::response& res) {
+                respond(app, req, res, honeypot::api::handle_openai_models(state_ptr, req));
+            });
+
+    // Everything else: Ollama's plain 404, with the probed path classified for the request log.
+    CROW_CATCHALL_ROUTE(app)
+    ([&app](const crow::request& req, crow::response& res) {
+        const std::string_view probe_class = honeypot::utils::get_probe_classifier().classify(req.url);
+        app.get_context<RequestLoggingMiddleware>(req).probe_class = probe_class;
+        // Exploit and leak probes are hostile however slowly they come; hold this source from now on.
+        if (honeypot::utils::is_exploit_probe(probe_class))
+        {
+            honeypot::utils::get_tarpit().flag(req.remote_ip_address, probe_class);
+        }
+        respond(app, req, res, honeypot::api::handle_not_found());
+    });
 
     logger->info("API routes registered.");
 
-    const auto& [listen_address, listen_port] = config_ptr->server;
-    logger->warn("Starting Honeypot server on {}:{}", listen_address, listen_port);
+    const auto& [listen_address, listen_port, listeners] = config_ptr->server;
+    if (listeners.empty())
+    {
+        logger->warn("Starting Honeypot server on {}:{}", listen_address, listen_port);
+    }
+    else
+    {
+        logger->warn("Starting Honeypot server on {} listeners", listeners.size());
+    }
+
+    honeypot::utils::start_signal_listener();
+
+    std::unique_ptr<honeypot::utils::AdminServer> admin;
+    if (const auto& admin_socket_path = config_ptr->admin.socket_path; !admin_socket_path.empty())
+    {
+        try
+        {
+            admin = std::make_unique<honeypot::utils::AdminServer>(admin_socket_path);
+            register_admin_commands(*admin, config_ptr, state_ptr, *snapshotter);
+            admin->start();
+            logger->info("Admin socket listening on '{}'.", admin_socket_path);
+        }
+        catch (const std::exception& e)
+        {
+            admin.reset();
+            logger->warn("Admin socket disabled: {}", e.what());
+        }
+    }
+
+    // With the front listener in place, Crow only serves what it forwards over loopback.
+    std::unique_ptr<honeypot::utils::FastPathListener> fast_path;
+    std::string crow_address = listen_address;
+    uint16_t crow_port = listen_port;
+    if (honeypot::utils::FastPathListener::required(*config_ptr))
+    {
+        try
+        {
+            fast_path = std::make_unique<honeypot::utils::FastPathListener>(*config_ptr, state_ptr);
+            fast_path->start();
+            crow_address = "127.0.0.1";
+            crow_port = config_ptr->fast_path.backend_port;
+        }
+        catch (const std::exception& e)
+        {
+            logger->critical("FATAL: Failed to start the front listener: {}", e.what());
+            return 1;
+        }
+    }
 
-    app.bindaddr(listen_address)
-            .port(listen_port)
+    app.bindaddr(crow_address)
+            .port(crow_port)
             .multithreaded()
             .run();
 
     logger->warn("Honeypot server shutting down.");
+    admin.reset(); // its commands use the snapshotter
+    fast_path.reset();
+    snapshotter.reset(); // writes the final snapshot
+    honeypot::utils::shutdown_request_log();
     spdlog::shutdown();
 }
@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fmt/core.h>
+#include <nlohmann/json.hpp>
+
+#include "state/catalog.hpp"
+#include "utils/logging.hpp"
+
+namespace fs = std::filesystem;
+
+namespace honeypot::state
+{
+    namespace
+    {
+        bool is_manifest_path(const std::string_view path)
+        {
+            return path.ends_with(manifest_extension);
+        }
+
+        /**
+         * Reads the header line of one manifest. The file is left unread past the first line;
+         * @p has_detail tells whether anything follows it.
+         */
+        config::TagModelInfo read_manifest_header(const fs::path& path, bool& has_detail)
+        {
+            std::ifstream in(path, std::ios::binary);
+            if (!in.is_open())
+            {
+                throw std::ios_base::failure(fmt::format("cannot open manifest '{}'", path.string()));
+            }
+            std::string header;
+            std::getline(in, header);
+            has_detail = in.peek() != std::ifstream::traits_type::eof();
+
+            auto model = nlohmann::ordered_json::parse(header).get<config::TagModelInfo>();
+            if (model.model.empty() || model.model == "default:latest")
+            {
+                model.model = model.name;
+            }
+            return model;
+        }
+    }
+
+    ModelCatalog load_model_catalog(const config::ApiBehaviorConfig& api_behavior)
+    {
+        ModelCatalog catalog;
+        catalog.models = api_behavior.tag_models;
+        catalog.detail_paths = api_behavior.show_file_map;
+        if (api_behavior.catalog_dir.empty())
+        {
+            return catalog;
+        }
+
+        const auto logger = utils::get_operational_logger();
+        const fs::path dir = fs::path("config") / api_behavior.catalog_dir;
+        std::error_code ec;
+        std::vector<fs::path> manifests;
+        for (const auto& entry : fs::directory_iterator(dir, ec))
+        {
+            if (entry.is_regular_file() && entry.path().extension() == fs::path(manifest_extension))
+            {
+                manifests.push_back(entry.path());
+            }
+        }
+        if (ec)
+        {
+            logger->warn("Cannot read catalog directory '{}': {}", dir.string(), ec.message());
+            return catalog;
+        }
+        // Directory order is unspecified; sort so the advertised catalog is stable across restarts.
+        std::ranges::sort(manifests);
+
+        tsl::robin_map<std::string, size_t> known;
+        known.reserve(catalog.models.size() + manifests.size());
+        for (size_t i = 0; i < catalog.models.size(); ++i)
+        {
+            known.emplace(catalog.models[i].name, i);
+        }
+
+        catalog.models.reserve(catalog.models.size() + manifests.size());
+        size_t indexed = 0;
+        for (const auto& path : manifests)
+        {
+            try
+            {
+                bool has_detail = false;
+                config::TagModelInfo model = read_manifest_header(path, has_detail);
+                if (!known.emplace(model.name, catalog.models.size()).second)
+                {
+                    logger->warn("Manifest '{}' redefines model '{}', keeping the first definition.",
+                                 path.string(), model.name);
+                    continue;
+                }
+                if (has_detail)
+                {
+                    catalog.detail_paths.emplace(model.name,
+                                                 (fs::path(api_behavior.catalog_dir) / path.filename()).string());
+                }
+                catalog.models.push_back(std::move(model));
+                ++indexed;
+            }
+            catch (const std::exception& e)
+            {
+                logger->warn("Skipping manifest '{}': {}", path.string(), e.what());
+            }
+        }
+        logger->info("Indexed {} model manifests from '{}'.", indexed, dir.string());
+        return catalog;
+    }
+
+    std::string read_detail_file(const std::string& path)
+    {
+        std::ifstream detail_file(path, std::ios::binary);
+        if (!detail_file.is_open())
+        {
+            throw std::ios_base::failure(fmt::format("cannot open detail file '{}'", path));
+        }
+        if (is_manifest_path(path))
+        {
+            detail_file.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        }
+        return {std::istreambuf_iterator<char>(detail_file), std::istreambuf_iterator<char>()};
+    }
+} // namespace honeypot::state
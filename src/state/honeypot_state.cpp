@@ -7,50 +7,231 @@
 #include <optional>
 #include <algorithm>
 #include <ranges>
+#include <filesystem>
+#include <iterator>
 
 #include <nlohmann/json.hpp>
 
+#include "state/catalog.hpp"
 #include "state/honeypot_state.hpp"
+#include "utils/etag.hpp"
+#include "utils/fake_data.hpp"
+#include "utils/hash.hpp"
 #include "utils/logging.hpp"
+#include "utils/trace.hpp"
 
 namespace honeypot::state
 {
+    namespace
+    {
+        /**
+         * Parses a detail file once and pre-renders both /api/show variants.
+         * ETags come from the raw file content so they survive restarts unchanged.
+         */
+        std::shared_ptr<const CachedDetail> build_cached_detail(const std::string& raw_detail,
+                                                                const std::string_view file_path)
+        {
+            utils::TraceSpan span("detail parse");
+            nlohmann::ordered_json model_details_json = nlohmann::ordered_json::parse(raw_detail);
+            const uint64_t content_hash = utils::fnv1a_64(raw_detail);
+
+            auto detail = std::make_shared<CachedDetail>();
+            detail->verbose.body = model_details_json.dump();
+            detail->verbose.etag = utils::make_strong_etag("show-v", content_hash);
+
+            if (model_details_json.contains("model_info") && model_details_json["model_info"].is_object())
+            {
+                auto& model_info = model_details_json["model_info"];
+
+                detail->tokenizer = utils::BpeTokenizer::from_model_info(model_info);
+
+                model_info["tokenizer.ggml.merges"] = nullptr;
+                model_info["tokenizer.ggml.token_type"] = nullptr;
+                model_info["tokenizer.ggml.tokens"] = nullptr;
+            }
+            else
+            {
+                utils::get_operational_logger()->warn(
+                    "Detail file '{}' unexpectedly missing 'model_info' object.", file_path);
+            }
+            detail->brief.body = model_details_json.dump();
+            detail->brief.etag = utils::make_strong_etag("show", content_hash);
+
+            detail->memory_bytes = sizeof(CachedDetail) + detail->verbose.body.size() + detail->brief.body.size()
+                + (detail->tokenizer ? detail->tokenizer->memory_bytes() : 0);
+            return detail;
+        }
 
-    HoneypotState::HoneypotState(const config::HoneypotConfig& config) : available_models_(config.api_behavior.tag_models),
-                                                                         show_file_map_(config.api_behavior.show_file_map)
+        // Identifies the catalog the config file ships, so a snapshot taken under a different
+        // catalog is not allowed to override an operator's edits.
+        uint64_t catalog_fingerprint(const std::vector<config::TagModelInfo>& tag_models,
+                                     const tsl::robin_map<std::string, std::string>& show_file_map)
+        {
+            const nlohmann::ordered_json models = tag_models;
+            std::vector<std::pair<std::string, std::string>> show_entries(show_file_map.begin(), show_file_map.end());
+            std::ranges::sort(show_entries);
+            const nlohmann::ordered_json show = show_entries;
+            return utils::fnv1a_64(show.dump(), utils::fnv1a_64(models.dump()));
+        }
+    }
+
+
+    HoneypotState::HoneypotState(const config::HoneypotConfig& config) : detail_cache_budget_(config.api_behavior.detail_cache_bytes),
+                                                                         overlay_body_budget_(config.api_behavior.catalog_cache_bytes),
+                                                                         overlays_(config.sessions),
+                                                                         instance_id_(static_cast<uint64_t>(
+                                                                             std::chrono::system_clock::now().time_since_epoch().count()))
     {
+        ModelCatalog catalog = load_model_catalog(config.api_behavior);
+        available_models_ = std::move(catalog.models);
+        show_file_map_ = std::move(catalog.detail_paths);
+        config_fingerprint_ = catalog_fingerprint(available_models_, show_file_map_);
+        index_base_catalog();
+
         const auto logger = utils::get_operational_logger();
         logger->debug("HoneypotState initialized with {} available models and {} detail file mappings.",
                       available_models_.size(), show_file_map_.size());
+
+        // Details listed in the config are warmed up front; manifest details are parsed on first use.
+        preload_details(config.api_behavior.show_file_map);
+        // Render the shared catalog bodies now so even a large catalog is served from a ready buffer.
+        get_catalog_body({}, CatalogView::tags);
+        get_catalog_body({}, CatalogView::openai_models);
     }
 
+    void HoneypotState::preload_details(const tsl::robin_map<std::string, std::string>& show_file_map)
+    {
+        const auto logger = utils::get_operational_logger();
+        for (const auto& [model_name, relative_path] : show_file_map)
+        {
+            try
+            {
+                const auto detail = load_detail(resolve_detail_path(relative_path));
+                if (detail->tokenizer)
+                {
+                    logger->info("Preloaded details for '{}' with a {}-token BPE vocabulary.", model_name,
+                                 detail->tokenizer->vocab_size());
+                }
+                else
+                {
+                    logger->info("Preloaded details for '{}' (no BPE vocabulary, token counts are estimated).",
+                                 model_name);
+                }
+            }
+            catch (const std::exception& e)
+            {
+                logger->warn("Could not preload details for '{}' from '{}': {}", model_name, relative_path,
+                             e.what());
+            }
+        }
+    }
 
-    std::vector<config::TagModelInfo> HoneypotState::get_available_models()
+    std::string HoneypotState::resolve_detail_path(const std::string_view relative_path)
     {
-        std::shared_lock lock(state_mutex_);
-        return available_models_;
+        return (std::filesystem::path("config") / std::filesystem::path(relative_path)).string();
     }
 
-    std::vector<LoadedModelInfo> HoneypotState::get_loaded_models()
+
+    std::vector<config::TagModelInfo> HoneypotState::merged_models(const SessionOverlay* overlay) const
     {
-        std::shared_lock lock(state_mutex_);
+        if (overlay == nullptr || !overlay->changes_catalog())
+        {
+            return available_models_;
+        }
 
-        std::vector<LoadedModelInfo> loaded_vector;
-        const auto now = std::chrono::steady_clock::now();
+        // Added models shadow base ones; this keeps the merge linear however many base models there are.
+        tsl::robin_set<std::string_view> shadowed;
+        shadowed.reserve(overlay->added.size());
+        for (const auto& added : overlay->added)
+        {
+            shadowed.insert(added.name);
+        }
 
-        loaded_vector.reserve(loaded_models_.size());
+        std::vector<config::TagModelInfo> models;
+        models.reserve(available_models_.size() + overlay->added.size());
+        for (const auto& model : available_models_)
+        {
+            if (!overlay->is_deleted(model.name) && !shadowed.contains(std::string_view(model.name)))
+            {
+                models.push_back(model);
+            }
+        }
+        for (const auto& added : overlay->added)
+        {
+            models.push_back(added.tag_info());
+        }
+        return models;
+    }
+
+    const config::TagModelInfo* HoneypotState::find_base_model(const std::string_view model_name) const
+    {
+        const auto it = base_index_.find(model_name);
+        return it != base_index_.end() ? &available_models_[it->second] : nullptr;
+    }
+
+    void HoneypotState::index_base_catalog()
+    {
+        base_index_.clear();
+        base_index_.reserve(available_models_.size());
+        for (size_t i = 0; i < available_models_.size(); ++i)
+        {
+            base_index_.emplace(available_models_[i].name, i); // first entry wins, as with a linear search
+        }
+    }
 
-        auto non_expired_view = loaded_models_ | std::views::filter([&now](const auto& lm){ return lm.expires_at > now; });
-        std::ranges::copy(non_expired_view, std::back_inserter(loaded_vector));
+    std::vector<config::TagModelInfo> HoneypotState::get_available_models(const std::string_view source)
+    {
+        const auto lock = utils::lock_shared_traced(state_mutex_, "state_mutex_ wait");
+        return overlays_.with_existing(source, [this](const SessionOverlay* overlay) {
+            return merged_models(overlay);
+        });
+    }
 
-        return loaded_vector;
+    std::vector<LoadedModelInfo> HoneypotState::get_loaded_models(const std::string_view source)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        return overlays_.with_existing(source, [&now](const SessionOverlay* overlay) {
+            std::vector<LoadedModelInfo> loaded_vector;
+            if (overlay == nullptr)
+            {
+                return loaded_vector;
+            }
+
+            loaded_vector.reserve(overlay->loaded.size());
+            auto non_expired_view = overlay->loaded | std::views::filter([&now](const auto& lm){ return lm.expires_at > now; });
+            std::ranges::copy(non_expired_view, std::back_inserter(loaded_vector));
+            return loaded_vector;
+        });
     }
 
-    std::optional<std::string> HoneypotState::get_detail_file_path(const std::string_view model_name)
+    std::optional<std::string> HoneypotState::get_detail_file_path(const std::string_view source,
+                                                                   const std::string_view model_name)
     {
-        std::shared_lock lock(state_mutex_);
+        const auto lock = utils::lock_shared_traced(state_mutex_, "state_mutex_ wait");
+
+        const auto overlay_path = overlays_.with_existing(source, [&](const SessionOverlay* overlay)
+            -> std::optional<std::optional<std::string>> {
+            if (overlay == nullptr)
+            {
+                return std::nullopt; // defer to the base catalog
+            }
+            if (const OverlayModel* added = overlay->find_added(model_name))
+            {
+                const std::string& detail_path = added->payload->detail_path;
+                return detail_path.empty() ? std::optional<std::string>{} : detail_path;
+            }
+            if (overlay->is_deleted(model_name))
+            {
+                return std::optional<std::string>{};
+            }
+            return std::nullopt;
+        });
+        if (overlay_path)
+        {
+            return *overlay_path;
+        }
 
-        const auto it = show_file_map_.find(model_name.data());
+        const auto it = show_file_map_.find(std::string(model_name));
 
         if (it != show_file_map_.end())
         {
@@ -62,110 +243,450 @@ namespace honeypot::state
         }
     }
 
-    std::optional<nlohmann::ordered_json> HoneypotState::get_cached_detail(const std::string_view file_path)
+    std::shared_ptr<const CachedDetail> HoneypotState::get_cached_detail(const std::string_view file_path)
     {
-        std::scoped_lock lock(cache_mutex_);
+        const auto lock = utils::lock_traced(cache_mutex_, "cache_mutex_ wait");
 
-        const auto it = show_cache_.find(file_path.data());
-        if (it != show_cache_.end())
+        const auto it = detail_index_.find(file_path);
+        if (it != detail_index_.end())
         {
-            return it->second;
+            detail_lru_.splice(detail_lru_.begin(), detail_lru_, it->second);
+            return it->second->second;
         }
         else
         {
-            return std::nullopt;
+            return nullptr;
         }
     }
 
-    void HoneypotState::cache_detail(const std::string_view file_path, nlohmann::ordered_json detail)
+    void HoneypotState::insert_detail(const std::string& file_path, std::shared_ptr<const CachedDetail> detail)
     {
-        std::scoped_lock lock(cache_mutex_);
-        show_cache_[file_path.data()] = std::move(detail);
+        if (detail->memory_bytes > detail_cache_budget_ || detail_index_.contains(file_path))
+        {
+            return;
+        }
+
+        while (!detail_lru_.empty() && detail_cache_bytes_ + detail->memory_bytes > detail_cache_budget_)
+        {
+            const auto& [evicted_path, evicted] = detail_lru_.back();
+            detail_cache_bytes_ -= evicted->memory_bytes;
+            detail_index_.erase(evicted_path);
+            detail_lru_.pop_back();
+        }
+
+        detail_cache_bytes_ += detail->memory_bytes;
+        detail_lru_.emplace_front(file_path, std::move(detail));
+        detail_index_.emplace(file_path, detail_lru_.begin());
     }
 
-    bool HoneypotState::delete_model(const std::string_view model_name)
+    std::shared_ptr<const CachedBody> HoneypotState::find_overlay_body(const uint64_t key,
+                                                                       const uint64_t base_generation)
     {
-        std::scoped_lock lock(state_mutex_);
+        const auto it = overlay_body_index_.find(key);
+        if (it == overlay_body_index_.end() || it->second->second.base_generation != base_generation)
+        {
+            return nullptr;
+        }
+        overlay_body_lru_.splice(overlay_body_lru_.begin(), overlay_body_lru_, it->second);
+        return it->second->second.body;
+    }
 
-        bool deleted_from_available = false;
-        bool deleted_from_loaded = false;
+    void HoneypotState::insert_overlay_body(const uint64_t key, CachedCatalogBody body)
+    {
+        if (body.memory_bytes > overlay_body_budget_)
+        {
+            return;
+        }
+        if (const auto it = overlay_body_index_.find(key); it != overlay_body_index_.end())
+        {
+            overlay_body_bytes_ -= it->second->second.memory_bytes;
+            overlay_body_lru_.erase(it->second);
+            overlay_body_index_.erase(it);
+        }
 
-        const auto new_end_available = std::ranges::remove_if(available_models_,
-                                                              [&] (const config::TagModelInfo& m) {
-                                                                  return m.name == model_name;
-                                                              }).begin();
-        if (new_end_available != available_models_.end())
+        while (!overlay_body_lru_.empty() && overlay_body_bytes_ + body.memory_bytes > overlay_body_budget_)
         {
-            available_models_.erase(new_end_available, available_models_.end());
-            deleted_from_available = true;
+            const auto& [evicted_key, evicted] = overlay_body_lru_.back();
+            overlay_body_bytes_ -= evicted.memory_bytes;
+            overlay_body_index_.erase(evicted_key);
+            overlay_body_lru_.pop_back();
         }
 
-        const auto new_end_loaded = std::ranges::remove_if(loaded_models_,
-                                                           [&] (const LoadedModelInfo& lm) {
-                                                               return lm.base_info.name == model_name;
-                                                           }).begin();
-        if (new_end_loaded != loaded_models_.end())
+        overlay_body_bytes_ += body.memory_bytes;
+        overlay_body_lru_.emplace_front(key, std::move(body));
+        overlay_body_index_.emplace(key, overlay_body_lru_.begin());
+    }
+
+    std::shared_ptr<const CachedDetail> HoneypotState::load_detail(const std::string& file_path)
+    {
+        if (auto cached = get_cached_detail(file_path))
         {
-            loaded_models_.erase(new_end_loaded, loaded_models_.end());
-            deleted_from_loaded = true;
+            return cached;
         }
 
-        show_file_map_.erase(model_name.data());
+        // Parse outside the lock; a concurrent miss on the same file just parses it twice.
+        std::string raw_detail;
+        {
+            utils::TraceSpan span("detail read");
+            raw_detail = read_detail_file(file_path);
+        }
+        auto detail = build_cached_detail(raw_detail, file_path);
 
+        const auto lock = utils::lock_traced(cache_mutex_, "cache_mutex_ wait");
+        insert_detail(file_path, detail);
+        return detail;
+    }
 
-        const bool actually_deleted = deleted_from_available || deleted_from_loaded;
-        if (actually_deleted)
+    std::shared_ptr<const utils::BpeTokenizer> HoneypotState::get_tokenizer(const std::string_view source,
+                                                                            const std::string_view model_name)
+    {
+        const std::optional<std::string> relative_path = get_detail_file_path(source, model_name);
+        if (!relative_path)
         {
-            const auto logger = utils::get_operational_logger();
-            logger->info("Simulated delete for model '{}'", model_name);
+            return nullptr;
+        }
+        try
+        {
+            return load_detail(resolve_detail_path(*relative_path))->tokenizer;
         }
+        catch (const std::exception&)
+        {
+            return nullptr;
+        }
+    }
 
-        return actually_deleted;
+    std::shared_ptr<const CachedBody> HoneypotState::get_catalog_body(const std::string_view source,
+                                                                      const CatalogView view)
+    {
+        const auto slot = static_cast<size_t>(view);
+        std::vector<config::TagModelInfo> models_copy;
+        uint64_t build_generation = 0;
+        uint64_t overlay_generation = 0; // 0 while the source sees the base catalog
+        {
+            const auto lock = utils::lock_shared_traced(state_mutex_, "state_mutex_ wait");
+            overlay_generation = overlays_.with_existing(source, [](const SessionOverlay* overlay) -> uint64_t {
+                return overlay != nullptr && overlay->changes_catalog() ? overlay->catalog_generation : 0;
+            });
+            if (overlay_generation != 0)
+            {
+                {
+                    const auto cache_lock = utils::lock_traced(cache_mutex_, "cache_mutex_ wait");
+                    if (auto cached = find_overlay_body(overlay_generation * catalog_view_count + slot, generation_))
+                    {
+                        return cached;
+                    }
+                }
+                // The overlay may have changed or expired since; render whatever it holds now.
+                overlay_generation = overlays_.with_existing(source, [&](const SessionOverlay* overlay) -> uint64_t {
+                    if (overlay == nullptr || !overlay->changes_catalog())
+                    {
+                        return 0;
+                    }
+                    models_copy = merged_models(overlay);
+                    return overlay->catalog_generation;
+                });
+            }
+            if (overlay_generation == 0)
+            {
+                const CachedCatalogBody& cached = catalog_bodies_[slot];
+                if (cached.body && cached.base_generation == generation_)
+                {
+                    return cached.body;
+                }
+                models_copy = available_models_;
+            }
+            build_generation = generation_;
+        }
+
+        // Serialize outside the lock; concurrent rebuilders produce identical bodies.
+        uint64_t etag_hash = utils::fnv1a_64(std::string_view(reinterpret_cast<const char*>(&build_generation),
+                                                              sizeof(build_generation)),
+                                             instance_id_);
+        if (overlay_generation != 0)
+        {
+            etag_hash = utils::fnv1a_64(std::string_view(reinterpret_cast<const char*>(&overlay_generation),
+                                                         sizeof(overlay_generation)),
+                                        etag_hash);
+        }
+        auto built = std::make_shared<CachedBody>();
+        if (view == CatalogView::tags)
+        {
+            built->body = utils::fake_data::generate_model_list_json(models_copy).dump();
+            built->etag = utils::make_strong_etag("tags", etag_hash);
+        }
+        else
+        {
+            built->body = utils::fake_data::generate_openai_model_list(models_copy);
+            built->etag = utils::make_strong_etag("models", etag_hash);
+        }
+
+        if (overlay_generation != 0)
+        {
+            // Keyed by the overlay generation, so bodies of overlays that changed since just age out.
+            const size_t memory_bytes = sizeof(CachedBody) + built->body.size() + built->etag.size();
+            const auto lock = utils::lock_traced(cache_mutex_, "cache_mutex_ wait");
+            insert_overlay_body(overlay_generation * catalog_view_count + slot, {built, build_generation, memory_bytes});
+            return built;
+        }
+
+        const auto lock = utils::lock_traced(state_mutex_, "state_mutex_ wait");
+        if (generation_ == build_generation)
+        {
+            catalog_bodies_[slot] = {built, build_generation};
+        }
+        return built;
     }
 
-    bool HoneypotState::load_or_update_model(const std::string_view model_name,
-                                             const std::chrono::seconds keep_alive)
+    uint64_t HoneypotState::generation() const
     {
-        std::scoped_lock lock(state_mutex_);
+        const auto lock = utils::lock_shared_traced(state_mutex_, "state_mutex_ wait");
+        return generation_;
+    }
 
-        const auto available_it = std::ranges::find_if(available_models_,
-                                                 [&] (const config::TagModelInfo& m) {
-                                                     return m.name == model_name;
-                                                 });
+    uint64_t HoneypotState::revision() const
+    {
+        return revision_.load(std::memory_order_acquire);
+    }
 
-        if (available_it == available_models_.end())
+    std::vector<std::pair<std::string, SessionOverlay>> HoneypotState::live_sessions() const
+    {
+        return overlays_.live_overlays();
+    }
+
+    DetailCacheStats HoneypotState::detail_cache_stats()
+    {
+        const auto lock = utils::lock_traced(cache_mutex_, "cache_mutex_ wait");
+        return {detail_lru_.size(), detail_cache_bytes_, detail_cache_budget_};
+    }
+
+    DetailCacheStats HoneypotState::flush_caches()
+    {
+        // Destroyed after the locks are released, in case this drops the last reference.
+        decltype(detail_lru_) flushed_details;
+        decltype(overlay_body_lru_) flushed_overlay_bodies;
+        std::array<CachedCatalogBody, catalog_view_count> flushed_bodies;
+        DetailCacheStats flushed;
+        {
+            const auto lock = utils::lock_traced(cache_mutex_, "cache_mutex_ wait");
+            flushed = {detail_lru_.size(), detail_cache_bytes_, detail_cache_budget_};
+            flushed_details.swap(detail_lru_);
+            detail_index_.clear();
+            detail_cache_bytes_ = 0;
+            flushed_overlay_bodies.swap(overlay_body_lru_);
+            overlay_body_index_.clear();
+            overlay_body_bytes_ = 0;
+        }
         {
+            const auto lock = utils::lock_traced(state_mutex_, "state_mutex_ wait");
+            flushed_bodies.swap(catalog_bodies_);
+        }
+        return flushed;
+    }
+
+    bool HoneypotState::delete_model(const std::string_view source, const std::string_view model_name)
+    {
+        const auto lock = utils::lock_shared_traced(state_mutex_, "state_mutex_ wait");
+        const bool in_base = find_base_model(model_name) != nullptr;
+
+        const bool actually_deleted = overlays_.with_overlay(source, [&](SessionOverlay& overlay) {
+            bool deleted_from_catalog = false;
+            const auto added_it = std::ranges::find(overlay.added, model_name, &OverlayModel::name);
+            if (added_it != overlay.added.end())
+            {
+                overlay.added.erase(added_it);
+                deleted_from_catalog = true;
+            }
+            if (in_base && !overlay.is_deleted(model_name))
+            {
+                overlay.deleted.emplace(model_name);
+                deleted_from_catalog = true;
+            }
+            if (deleted_from_catalog)
+            {
+                overlay.catalog_generation = overlays_.next_catalog_generation();
+            }
+
+            const auto new_end_loaded = std::ranges::remove_if(overlay.loaded,
+                                                               [&] (const LoadedModelInfo& lm) {
+                                                                   return lm.base_info.name == model_name;
+                                                               }).begin();
+            const bool deleted_from_loaded = new_end_loaded != overlay.loaded.end();
+            overlay.loaded.erase(new_end_loaded, overlay.loaded.end());
+
+            return deleted_from_catalog || deleted_from_loaded;
+        });
+
+        if (actually_deleted)
+        {
+            revision_.fetch_add(1, std::memory_order_release);
             const auto logger = utils::get_operational_logger();
-            logger->warn("Attempted to load unknown model '{}' (not in available models)", model_name);
-            return false; // Model not configured
+            logger->info("Simulated delete for model '{}' (source {})", model_name, source);
         }
 
-        const auto expires_at = std::chrono::steady_clock::now() + keep_alive;
+        return actually_deleted;
+    }
 
-        const auto loaded_it = std::ranges::find_if(loaded_models_,
-                                              [&] (const LoadedModelInfo& lm) {
-                                                  return lm.base_info.name == model_name;
-                                              });
+    std::shared_ptr<const ModelPayload> HoneypotState::base_payload(const config::TagModelInfo& model)
+    {
+        std::scoped_lock lock(payload_mutex_);
+        auto& payload = base_payloads_[model.name];
+        if (!payload)
+        {
+            const auto detail_it = show_file_map_.find(model.name);
+            payload = std::make_shared<const ModelPayload>(
+                ModelPayload{model, detail_it != show_file_map_.end() ? detail_it->second : std::string{}});
+        }
+        return payload;
+    }
 
-        if (loaded_it != loaded_models_.end())
+    std::shared_ptr<const ModelPayload> HoneypotState::find_model(const std::string_view source,
+                                                                  const std::string_view model_name)
+    {
+        const auto lock = utils::lock_shared_traced(state_mutex_, "state_mutex_ wait");
+        const auto overlay_payload = overlays_.with_existing(source, [&](const SessionOverlay* overlay)
+            -> std::optional<std::shared_ptr<const ModelPayload>> {
+            if (overlay == nullptr)
+            {
+                return std::nullopt; // defer to the base catalog
+            }
+            if (const OverlayModel* added = overlay->find_added(model_name))
+            {
+                return added->payload;
+            }
+            if (overlay->is_deleted(model_name))
+            {
+                return nullptr;
+            }
+            return std::nullopt;
+        });
+        if (overlay_payload)
         {
-            loaded_it->expires_at = expires_at;
-            const auto logger = utils::get_operational_logger();
-            logger->debug("Updated keep_alive for loaded model '{}'", model_name);
+            return *overlay_payload;
         }
-        else
+
+        const config::TagModelInfo* base_model = find_base_model(model_name);
+        return base_model != nullptr ? base_payload(*base_model) : nullptr;
+    }
+
+    bool HoneypotState::add_model(const std::string_view source, const config::TagModelInfo& info,
+                                  const std::string_view detail_path)
+    {
+        return add_overlay_model(source, OverlayModel{
+                                     info.name, {},
+                                     std::make_shared<const ModelPayload>(ModelPayload{info, std::string(detail_path)})
+                                 });
+    }
+
+    bool HoneypotState::add_model(const std::string_view source, const std::string_view model_name,
+                                  std::shared_ptr<const ModelPayload> payload)
+    {
+        return add_overlay_model(source, OverlayModel{
+                                     std::string(model_name), utils::fake_data::generate_timestamp_iso8601(),
+                                     std::move(payload)
+                                 });
+    }
+
+    bool HoneypotState::add_overlay_model(const std::string_view source, OverlayModel model)
+    {
+        const auto lock = utils::lock_shared_traced(state_mutex_, "state_mutex_ wait");
+        const config::TagModelInfo* base_model = find_base_model(model.name);
+        const bool same_as_base = base_model != nullptr && base_model->digest == model.payload->info.digest;
+        const std::string model_name = model.name;
+
+        const bool added = overlays_.with_overlay(source, [&](SessionOverlay& overlay) {
+            const auto added_it = std::ranges::find(overlay.added, model.name, &OverlayModel::name);
+            if (!same_as_base && added_it == overlay.added.end()
+                && overlay.added.size() >= SessionOverlays::max_models_per_overlay)
+            {
+                return false;
+            }
+
+            overlay.deleted.erase(model.name);
+            if (same_as_base)
+            {
+                // Pulling a base model just brings it back.
+                if (added_it != overlay.added.end())
+                {
+                    overlay.added.erase(added_it);
+                }
+            }
+            else if (added_it != overlay.added.end())
+            {
+                *added_it = std::move(model);
+            }
+            else
+            {
+                overlay.added.push_back(std::move(model));
+            }
+            overlay.catalog_generation = overlays_.next_catalog_generation();
+            return true;
+        });
+
+        if (added)
         {
-            const config::TagModelInfo& base_info = *available_it;
+            revision_.fetch_add(1, std::memory_order_release);
+            utils::get_operational_logger()->info("Simulated add of model '{}' (source {})", model_name, source);
+        }
+        return added;
+    }
+
+    ModelLoadResult HoneypotState::load_or_update_model(const std::string_view source,
+                                                        const std::string_view model_name,
+                                                        const std::chrono::seconds keep_alive)
+    {
+        const auto lock = utils::lock_shared_traced(state_mutex_, "state_mutex_ wait");
+
+        const config::TagModelInfo* base_model = find_base_model(model_name);
+
+        return overlays_.with_overlay(source, [&](SessionOverlay& overlay) {
+            const OverlayModel* added = overlay.find_added(model_name);
+            const config::TagModelInfo* base_info = nullptr;
+            if (added != nullptr)
+            {
+                base_info = &added->payload->info;
+            }
+            else if (base_model != nullptr && !overlay.is_deleted(model_name))
+            {
+                base_info = base_model;
+            }
+
+            if (base_info == nullptr)
+            {
+                const auto logger = utils::get_operational_logger();
+                logger->warn("Attempted to load unknown model '{}' (not in available models)", model_name);
+                return ModelLoadResult::not_found; // Model not configured
+            }
+
+            const auto now = std::chrono::steady_clock::now();
+            const auto expires_at = now + keep_alive;
+            revision_.fetch_add(1, std::memory_order_release);
+
+            // Models whose keep-alive ran out count as unloaded; dropping them keeps the list bounded.
+            std::erase_if(overlay.loaded, [&now](const LoadedModelInfo& lm) { return lm.expires_at <= now; });
+
+            const auto loaded_it = std::ranges::find_if(overlay.loaded,
+                                                  [&] (const LoadedModelInfo& lm) {
+                                                      return lm.base_info.name == model_name;
+                                                  });
+
+            if (loaded_it != overlay.loaded.end())
+            {
+                loaded_it->expires_at = expires_at;
+                const auto logger = utils::get_operational_logger();
+                logger->debug("Updated keep_alive for loaded model '{}'", model_name);
+                return ModelLoadResult::warm;
+            }
+
             LoadedModelInfo new_loaded_info;
-            new_loaded_info.base_info = base_info;
+            new_loaded_info.base_info = added != nullptr ? added->tag_info() : *base_info;
             new_loaded_info.expires_at = expires_at;
-            new_loaded_info.size_vram = base_info.size;
+            new_loaded_info.size_vram = base_info->size;
 
-            loaded_models_.push_back(std::move(new_loaded_info));
+            overlay.loaded.push_back(std::move(new_loaded_info));
             const auto logger = utils::get_operational_logger();
-            logger->info("Simulated load for model '{}', expires in {}s", model_name, keep_alive.count());
-        }
-
-        return true;
+            logger->info("Simulated load for model '{}' (source {}), expires in {}s", model_name, source,
+                         keep_alive.count());
+            return ModelLoadResult::cold;
+        });
     }
 } // namespace honeypot::state
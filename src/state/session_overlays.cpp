@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "state/honeypot_state.hpp"
+
+namespace honeypot::state
+{
+    bool SessionOverlay::is_deleted(const std::string_view model_name) const
+    {
+        return deleted.contains(model_name);
+    }
+
+    const OverlayModel* SessionOverlay::find_added(const std::string_view model_name) const
+    {
+        const auto it = std::ranges::find(added, model_name, &OverlayModel::name);
+        return it != added.end() ? &*it : nullptr;
+    }
+
+    config::TagModelInfo OverlayModel::tag_info() const
+    {
+        config::TagModelInfo info = payload->info;
+        if (info.name != name)
+        {
+            info.name = name;
+            info.model = name;
+        }
+        if (!modified_at.empty())
+        {
+            info.modified_at = modified_at;
+        }
+        return info;
+    }
+
+    SessionOverlays::SessionOverlays(const config::SessionConfig& config)
+        : config_(config),
+          max_per_shard_(std::max<size_t>(config.max_sessions / shard_count, 1))
+    {
+    }
+
+    SessionOverlays::Shard& SessionOverlays::shard_for(const std::string_view source)
+    {
+        return shards_[utils::TransparentStringHash{}(source) % shard_count];
+    }
+
+    SessionOverlay* SessionOverlays::find_live(Shard& shard, const std::string_view source, const Clock::time_point now)
+    {
+        const auto it = shard.overlays.find(source);
+        if (it == shard.overlays.end() || now - it->second.last_seen >= ttl())
+        {
+            return nullptr;
+        }
+        SessionOverlay& overlay = it.value();
+        overlay.last_seen = now;
+        return &overlay;
+    }
+
+    SessionOverlay& SessionOverlays::overlay_for(Shard& shard, const std::string_view source,
+                                                 const Clock::time_point now)
+    {
+        auto it = shard.overlays.find(source);
+        if (it == shard.overlays.end())
+        {
+            make_room(shard, now);
+            it = shard.overlays.emplace(std::string(source), SessionOverlay{}).first;
+        }
+        else if (now - it->second.last_seen >= ttl())
+        {
+            it.value() = SessionOverlay{};
+        }
+        SessionOverlay& overlay = it.value();
+        overlay.last_seen = now;
+        return overlay;
+    }
+
+    void SessionOverlays::make_room(Shard& shard, const Clock::time_point now)
+    {
+        if (shard.overlays.size() < max_per_shard_)
+        {
+            return;
+        }
+
+        for (auto it = shard.overlays.begin(); it != shard.overlays.end();)
+        {
+            if (now - it->second.last_seen >= ttl())
+            {
+                it = shard.overlays.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        if (shard.overlays.size() < max_per_shard_)
+        {
+            return;
+        }
+
+        const auto oldest = std::ranges::min_element(shard.overlays, {}, [](const auto& entry) {
+            return entry.second.last_seen;
+        });
+        shard.overlays.erase(oldest);
+    }
+
+    std::vector<std::pair<std::string, SessionOverlay>> SessionOverlays::live_overlays() const
+    {
+        std::vector<std::pair<std::string, SessionOverlay>> live;
+        const auto now = Clock::now();
+        for (const Shard& shard : shards_)
+        {
+            std::scoped_lock lock(shard.mutex);
+            for (const auto& [source, overlay] : shard.overlays)
+            {
+                if (now - overlay.last_seen < ttl())
+                {
+                    live.emplace_back(source, overlay);
+                }
+            }
+        }
+        return live;
+    }
+
+    void SessionOverlays::restore(std::string source, SessionOverlay overlay)
+    {
+        Shard& shard = shard_for(source);
+        std::scoped_lock lock(shard.mutex);
+        overlay.catalog_generation = next_catalog_generation();
+        if (const auto it = shard.overlays.find(source); it != shard.overlays.end())
+        {
+            it.value() = std::move(overlay);
+            return;
+        }
+        make_room(shard, Clock::now());
+        shard.overlays.emplace(std::move(source), std::move(overlay));
+    }
+} // namespace honeypot::state
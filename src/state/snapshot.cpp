@@ -0,0 +1,610 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fmt/core.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "state/honeypot_state.hpp"
+#include "state/snapshot.hpp"
+#include "utils/hash.hpp"
+#include "utils/logging.hpp"
+
+namespace fs = std::filesystem;
+
+namespace honeypot::state
+{
+    namespace
+    {
+        constexpr uint32_t no_families = UINT32_MAX;
+
+        int64_t unix_ms(const std::chrono::system_clock::time_point time)
+        {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+        }
+
+        class StringTable
+        {
+        public:
+            SnapshotString add(const std::string_view text)
+            {
+                const SnapshotString ref{static_cast<uint32_t>(blob_.size()), static_cast<uint32_t>(text.size())};
+                blob_.append(text);
+                return ref;
+            }
+
+            const std::string& blob() const { return blob_; }
+
+        private:
+            std::string blob_;
+        };
+
+        /**
+         * Read-only view of a snapshot file, unmapped on destruction.
+         */
+        class SnapshotFile
+        {
+        public:
+            explicit SnapshotFile(const std::string& path)
+            {
+#ifndef _WIN32
+                const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                if (fd < 0)
+                {
+                    return;
+                }
+                struct stat st{};
+                if (::fstat(fd, &st) == 0 && st.st_size >= static_cast<off_t>(sizeof(SnapshotHeader)))
+                {
+                    void* mapping = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (mapping != MAP_FAILED)
+                    {
+                        data_ = static_cast<const std::byte*>(mapping);
+                        size_ = static_cast<size_t>(st.st_size);
+                    }
+                }
+                ::close(fd);
+#else
+                std::ifstream in(path, std::ios::binary | std::ios::ate);
+                if (!in.is_open())
+                {
+                    return;
+                }
+                size_ = static_cast<size_t>(in.tellg());
+                heap_copy_ = std::make_unique<std::byte[]>(size_);
+                in.seekg(0);
+                in.read(reinterpret_cast<char*>(heap_copy_.get()), static_cast<std::streamsize>(size_));
+                data_ = heap_copy_.get();
+#endif
+            }
+
+            ~SnapshotFile()
+            {
+#ifndef _WIN32
+                if (data_ != nullptr)
+                {
+                    ::munmap(const_cast<std::byte*>(data_), size_);
+                }
+#endif
+            }
+
+            SnapshotFile(const SnapshotFile&) = delete;
+            SnapshotFile& operator=(const SnapshotFile&) = delete;
+
+            const std::byte* data() const { return data_; }
+            size_t size() const { return size_; }
+
+        private:
+            const std::byte* data_ = nullptr;
+            size_t size_ = 0;
+            std::unique_ptr<std::byte[]> heap_copy_; // used where mmap is unavailable
+        };
+
+        bool section_fits(const uint64_t offset, const uint64_t count, const uint64_t element_size,
+                          const uint64_t file_size)
+        {
+            if (offset % 8 != 0 || offset > file_size)
+            {
+                return false;
+            }
+            return count <= (file_size - offset) / element_size;
+        }
+
+        SnapshotModel encode_model(const config::TagModelInfo& model, const std::string_view detail_path,
+                                   StringTable& strings, std::vector<SnapshotString>& families)
+        {
+            SnapshotModel entry{};
+            entry.name = strings.add(model.name);
+            entry.model = strings.add(model.model);
+            entry.modified_at = strings.add(model.modified_at);
+            entry.digest = strings.add(model.digest);
+            entry.format = strings.add(model.details.format);
+            entry.family = strings.add(model.details.family);
+            entry.parent_model = strings.add(model.details.parent_model);
+            entry.parameter_size = strings.add(model.details.parameter_size);
+            entry.quantization_level = strings.add(model.details.quantization_level);
+            entry.detail_path = strings.add(detail_path);
+            entry.size = model.size;
+            entry.families_begin = static_cast<uint32_t>(families.size());
+            entry.families_count = no_families;
+            if (model.details.families)
+            {
+                entry.families_count = static_cast<uint32_t>(model.details.families->size());
+                for (const auto& family : *model.details.families)
+                {
+                    families.push_back(strings.add(family));
+                }
+            }
+            return entry;
+        }
+    }
+
+    std::string HoneypotState::encode_snapshot(uint64_t& revision) const
+    {
+        std::vector<config::TagModelInfo> models;
+        std::vector<std::pair<std::string, std::string>> show_entries;
+        std::vector<std::pair<std::string, SessionOverlay>> overlays;
+        uint64_t generation = 0;
+        {
+            // Read the revision first: anything that changes afterwards bumps it past this value
+            // and gets written by the next snapshot.
+            revision = revision_.load(std::memory_order_acquire);
+            std::shared_lock lock(state_mutex_);
+            models = available_models_;
+            show_entries.assign(show_file_map_.begin(), show_file_map_.end());
+            generation = generation_;
+            overlays = overlays_.live_overlays();
+        }
+
+        const auto steady_now = std::chrono::steady_clock::now();
+        const auto system_now = std::chrono::system_clock::now();
+        const auto to_unix_ms = [&](const std::chrono::steady_clock::time_point time) {
+            return unix_ms(system_now) + std::chrono::duration_cast<std::chrono::milliseconds>(
+                       time - steady_now).count();
+        };
+
+        StringTable strings;
+        std::vector<SnapshotModel> snapshot_models;
+        std::vector<SnapshotString> families;
+        snapshot_models.reserve(models.size());
+        for (const auto& model : models)
+        {
+            snapshot_models.push_back(encode_model(model, {}, strings, families));
+        }
+
+        std::ranges::sort(overlays, {}, &std::pair<std::string, SessionOverlay>::first);
+        std::vector<SnapshotOverlay> snapshot_overlays;
+        std::vector<SnapshotString> deleted;
+        std::vector<SnapshotLoadedModel> snapshot_loaded;
+        snapshot_overlays.reserve(overlays.size());
+        for (const auto& [source, overlay] : overlays)
+        {
+            SnapshotOverlay entry{};
+            entry.source = strings.add(source);
+            entry.last_seen_unix_ms = to_unix_ms(overlay.last_seen);
+
+            entry.deleted_begin = static_cast<uint32_t>(deleted.size());
+            for (const auto& model_name : overlay.deleted)
+            {
+                deleted.push_back(strings.add(model_name));
+            }
+            entry.deleted_count = static_cast<uint32_t>(deleted.size()) - entry.deleted_begin;
+
+            entry.added_begin = static_cast<uint32_t>(snapshot_models.size());
+            for (const auto& added : overlay.added)
+            {
+                snapshot_models.push_back(encode_model(added.tag_info(), added.payload->detail_path, strings,
+                                                       families));
+            }
+            entry.added_count = static_cast<uint32_t>(snapshot_models.size()) - entry.added_begin;
+
+            entry.loaded_begin = static_cast<uint32_t>(snapshot_loaded.size());
+            for (const auto& model : overlay.loaded)
+            {
+                if (model.expires_at <= steady_now)
+                {
+                    continue;
+                }
+                snapshot_loaded.push_back({strings.add(model.base_info.name), to_unix_ms(model.expires_at),
+                                           model.size_vram});
+            }
+            entry.loaded_count = static_cast<uint32_t>(snapshot_loaded.size()) - entry.loaded_begin;
+
+            snapshot_overlays.push_back(entry);
+        }
+
+        std::ranges::sort(show_entries);
+        std::vector<SnapshotShowEntry> snapshot_show;
+        snapshot_show.reserve(show_entries.size());
+        for (const auto& [model_name, path] : show_entries)
+        {
+            snapshot_show.push_back({strings.add(model_name), strings.add(path)});
+        }
+
+        SnapshotHeader header{};
+        std::memcpy(header.magic, snapshot_magic, sizeof(snapshot_magic));
+        header.version = snapshot_format_version;
+        header.endian_tag = snapshot_endian_tag;
+        header.saved_at_unix_ms = unix_ms(system_now);
+        header.config_fingerprint = config_fingerprint_;
+        header.generation = generation;
+        header.base_model_count = static_cast<uint32_t>(models.size());
+        header.model_count = static_cast<uint32_t>(snapshot_models.size());
+        header.family_count = static_cast<uint32_t>(families.size());
+        header.show_entry_count = static_cast<uint32_t>(snapshot_show.size());
+        header.overlay_count = static_cast<uint32_t>(snapshot_overlays.size());
+        header.deleted_count = static_cast<uint32_t>(deleted.size());
+        header.loaded_count = static_cast<uint32_t>(snapshot_loaded.size());
+
+        std::string out(sizeof(SnapshotHeader), '\0');
+        const auto append_section = [&out](const void* data, const size_t bytes) {
+            out.resize((out.size() + 7) & ~size_t{7}, '\0');
+            const uint64_t offset = out.size();
+            out.append(static_cast<const char*>(data), bytes);
+            return offset;
+        };
+        header.models_offset = append_section(snapshot_models.data(), snapshot_models.size() * sizeof(SnapshotModel));
+        header.families_offset = append_section(families.data(), families.size() * sizeof(SnapshotString));
+        header.show_entries_offset = append_section(snapshot_show.data(),
+                                                    snapshot_show.size() * sizeof(SnapshotShowEntry));
+        header.overlays_offset = append_section(snapshot_overlays.data(),
+                                                snapshot_overlays.size() * sizeof(SnapshotOverlay));
+        header.deleted_offset = append_section(deleted.data(), deleted.size() * sizeof(SnapshotString));
+        header.loaded_offset = append_section(snapshot_loaded.data(),
+                                              snapshot_loaded.size() * sizeof(SnapshotLoadedModel));
+        header.strings_offset = append_section(strings.blob().data(), strings.blob().size());
+        header.strings_size = strings.blob().size();
+        out.resize((out.size() + 7) & ~size_t{7}, '\0');
+        header.file_size = out.size();
+        header.checksum = utils::fnv1a_64(std::string_view(out).substr(sizeof(SnapshotHeader)));
+        std::memcpy(out.data(), &header, sizeof(header));
+        return out;
+    }
+
+    bool HoneypotState::restore_snapshot(const std::string& path)
+    {
+        const auto logger = utils::get_operational_logger();
+        const SnapshotFile file(path);
+        if (file.data() == nullptr || file.size() < sizeof(SnapshotHeader))
+        {
+            logger->info("No state snapshot at '{}', starting from the configured catalog.", path);
+            return false;
+        }
+
+        const auto* header = reinterpret_cast<const SnapshotHeader*>(file.data());
+        const uint64_t file_size = file.size();
+        const std::string_view payload(reinterpret_cast<const char*>(file.data()) + sizeof(SnapshotHeader),
+                                       file_size - sizeof(SnapshotHeader));
+        if (std::memcmp(header->magic, snapshot_magic, sizeof(snapshot_magic)) != 0
+            || header->version != snapshot_format_version
+            || header->endian_tag != snapshot_endian_tag
+            || header->file_size != file_size
+            || header->checksum != utils::fnv1a_64(payload)
+            || header->base_model_count > header->model_count
+            || !section_fits(header->models_offset, header->model_count, sizeof(SnapshotModel), file_size)
+            || !section_fits(header->families_offset, header->family_count, sizeof(SnapshotString), file_size)
+            || !section_fits(header->show_entries_offset, header->show_entry_count, sizeof(SnapshotShowEntry),
+                             file_size)
+            || !section_fits(header->overlays_offset, header->overlay_count, sizeof(SnapshotOverlay), file_size)
+            || !section_fits(header->deleted_offset, header->deleted_count, sizeof(SnapshotString), file_size)
+            || !section_fits(header->loaded_offset, header->loaded_count, sizeof(SnapshotLoadedModel), file_size)
+            || header->strings_offset > file_size || header->strings_size > file_size - header->strings_offset)
+        {
+            logger->warn("Ignoring state snapshot '{}': not a valid version {} snapshot.", path,
+                         snapshot_format_version);
+            return false;
+        }
+
+        const auto* models = reinterpret_cast<const SnapshotModel*>(file.data() + header->models_offset);
+        const auto* families = reinterpret_cast<const SnapshotString*>(file.data() + header->families_offset);
+        const auto* show = reinterpret_cast<const SnapshotShowEntry*>(file.data() + header->show_entries_offset);
+        const auto* overlays = reinterpret_cast<const SnapshotOverlay*>(file.data() + header->overlays_offset);
+        const auto* deleted = reinterpret_cast<const SnapshotString*>(file.data() + header->deleted_offset);
+        const auto* loaded = reinterpret_cast<const SnapshotLoadedModel*>(file.data() + header->loaded_offset);
+        const char* strings = reinterpret_cast<const char*>(file.data() + header->strings_offset);
+
+        bool valid = true;
+        const auto text = [&](const SnapshotString ref) {
+            if (uint64_t{ref.offset} + ref.length > header->strings_size)
+            {
+                valid = false;
+                return std::string{};
+            }
+            return std::string(strings + ref.offset, ref.length);
+        };
+        const auto decode_model = [&](const SnapshotModel& entry) {
+            config::TagModelInfo model;
+            model.name = text(entry.name);
+            model.model = text(entry.model);
+            model.modified_at = text(entry.modified_at);
+            model.digest = text(entry.digest);
+            model.size = entry.size;
+            model.details.format = text(entry.format);
+            model.details.family = text(entry.family);
+            model.details.parent_model = text(entry.parent_model);
+            model.details.parameter_size = text(entry.parameter_size);
+            model.details.quantization_level = text(entry.quantization_level);
+            if (entry.families_count != no_families)
+            {
+                if (uint64_t{entry.families_begin} + entry.families_count > header->family_count)
+                {
+                    valid = false;
+                    return model;
+                }
+                std::vector<std::string> model_families;
+                for (uint32_t f = 0; f < entry.families_count; ++f)
+                {
+                    model_families.push_back(text(families[entry.families_begin + f]));
+                }
+                model.details.families = std::move(model_families);
+            }
+            return model;
+        };
+
+        std::vector<config::TagModelInfo> restored_models;
+        restored_models.reserve(header->base_model_count);
+        for (uint32_t i = 0; i < header->base_model_count && valid; ++i)
+        {
+            restored_models.push_back(decode_model(models[i]));
+        }
+
+        tsl::robin_map<std::string, std::string> restored_show;
+        for (uint32_t i = 0; i < header->show_entry_count && valid; ++i)
+        {
+            restored_show.emplace(text(show[i].model_name), text(show[i].path));
+        }
+
+        const auto steady_now = std::chrono::steady_clock::now();
+        const int64_t now_ms = unix_ms(std::chrono::system_clock::now());
+        const auto from_unix_ms = [&](const int64_t time_ms) {
+            return steady_now + std::chrono::milliseconds(time_ms - now_ms);
+        };
+        const int64_t ttl_ms = std::chrono::duration_cast<std::chrono::milliseconds>(overlays_.ttl()).count();
+
+        // Loaded entries are resolved once the catalog is settled, below.
+        struct PendingOverlay
+        {
+            std::string source;
+            SessionOverlay overlay;
+            const SnapshotOverlay* entry;
+        };
+        std::vector<PendingOverlay> restored_overlays;
+        // Copies were written out one entry per name; entries with the same digest and detail path
+        // share a payload again.
+        tsl::robin_map<std::string, std::shared_ptr<const ModelPayload>> restored_payloads;
+        for (uint32_t i = 0; i < header->overlay_count && valid; ++i)
+        {
+            const SnapshotOverlay& entry = overlays[i];
+            if (uint64_t{entry.deleted_begin} + entry.deleted_count > header->deleted_count
+                || entry.added_begin < header->base_model_count
+                || uint64_t{entry.added_begin} + entry.added_count > header->model_count
+                || uint64_t{entry.loaded_begin} + entry.loaded_count > header->loaded_count)
+            {
+                valid = false;
+                break;
+            }
+            if (now_ms - entry.last_seen_unix_ms >= ttl_ms)
+            {
+                continue;
+            }
+
+            PendingOverlay pending{text(entry.source), {}, &entry};
+            pending.overlay.last_seen = from_unix_ms(entry.last_seen_unix_ms);
+            for (uint32_t d = 0; d < entry.deleted_count; ++d)
+            {
+                pending.overlay.deleted.emplace(text(deleted[entry.deleted_begin + d]));
+            }
+            for (uint32_t a = 0; a < entry.added_count; ++a)
+            {
+                const SnapshotModel& model = models[entry.added_begin + a];
+                config::TagModelInfo info = decode_model(model);
+                std::string detail_path = text(model.detail_path);
+                auto& payload = restored_payloads[info.digest + '\0' + detail_path];
+                if (!payload)
+                {
+                    payload = std::make_shared<const ModelPayload>(ModelPayload{info, std::move(detail_path)});
+                }
+                OverlayModel added{std::move(info.name), {}, payload};
+                if (info.modified_at != payload->info.modified_at)
+                {
+                    added.modified_at = std::move(info.modified_at);
+                }
+                pending.overlay.added.push_back(std::move(added));
+            }
+            restored_overlays.push_back(std::move(pending));
+        }
+        if (!valid)
+        {
+            logger->warn("Ignoring state snapshot '{}': references out of range.", path);
+            return false;
+        }
+
+        const bool same_catalog = header->config_fingerprint == config_fingerprint_;
+
+        std::scoped_lock lock(state_mutex_);
+        if (same_catalog)
+        {
+            available_models_ = std::move(restored_models);
+            show_file_map_ = std::move(restored_show);
+            generation_ = header->generation + 1;
+            index_base_catalog();
+            std::scoped_lock payload_lock(payload_mutex_);
+            base_payloads_.clear();
+        }
+
+        size_t restored_loaded = 0;
+        for (auto& [source, overlay, entry] : restored_overlays)
+        {
+            for (uint32_t l = 0; l < entry->loaded_count; ++l)
+            {
+                const SnapshotLoadedModel& loaded_entry = loaded[entry->loaded_begin + l];
+                if (loaded_entry.expires_at_unix_ms <= now_ms)
+                {
+                    continue;
+                }
+                const std::string name = text(loaded_entry.name);
+                const config::TagModelInfo* base_info = nullptr;
+                config::TagModelInfo added_info;
+                if (const OverlayModel* added = overlay.find_added(name))
+                {
+                    added_info = added->tag_info();
+                    base_info = &added_info;
+                }
+                else if (const config::TagModelInfo* base_model = find_base_model(name);
+                    base_model != nullptr && !overlay.is_deleted(name))
+                {
+                    base_info = base_model;
+                }
+                if (base_info == nullptr
+                    || std::ranges::any_of(overlay.loaded, [&](const auto& lm) { return lm.base_info.name == name; }))
+                {
+                    continue;
+                }
+                LoadedModelInfo model;
+                model.base_info = *base_info;
+                model.expires_at = from_unix_ms(loaded_entry.expires_at_unix_ms);
+                model.size_vram = loaded_entry.size_vram;
+                overlay.loaded.push_back(std::move(model));
+                ++restored_loaded;
+            }
+            overlays_.restore(std::move(source), std::move(overlay));
+        }
+        revision_.fetch_add(1, std::memory_order_release);
+
+        const auto age = std::chrono::milliseconds(now_ms - header->saved_at_unix_ms);
+        if (same_catalog)
+        {
+            logger->info("Restored state snapshot '{}' from {}s ago: {} models, {} sessions, {} models still "
+                         "loaded.", path, age.count() / 1000, available_models_.size(), restored_overlays.size(),
+                         restored_loaded);
+        }
+        else
+        {
+            logger->info("State snapshot '{}' predates a catalog change in the config; restored {} sessions "
+                         "({} models still loaded) over the new catalog.", path, restored_overlays.size(),
+                         restored_loaded);
+        }
+        return true;
+    }
+
+    StateSnapshotter::StateSnapshotter(std::shared_ptr<HoneypotState> state, const config::SnapshotConfig& config)
+        : state_(std::move(state)),
+          config_(config)
+    {
+        if (!config_.enabled || config_.path.empty())
+        {
+            return;
+        }
+
+        const auto started = std::chrono::steady_clock::now();
+        if (state_->restore_snapshot(config_.path))
+        {
+            utils::get_operational_logger()->debug(
+                "State snapshot restored in {} us.",
+                std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started)
+                .count());
+        }
+        // Whatever was restored is already on disk.
+        written_revision_ = state_->revision();
+
+        thread_ = std::thread([this] { run(); });
+    }
+
+    StateSnapshotter::~StateSnapshotter()
+    {
+        if (!thread_.joinable())
+        {
+            return;
+        }
+        {
+            std::scoped_lock lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        thread_.join();
+        write_if_changed();
+    }
+
+    void StateSnapshotter::run()
+    {
+        const auto interval = std::chrono::seconds(std::max<uint32_t>(config_.interval_seconds, 1));
+        std::unique_lock lock(mutex_);
+        while (!wake_.wait_for(lock, interval, [this] { return stopping_; }))
+        {
+            lock.unlock();
+            write_if_changed();
+            lock.lock();
+        }
+    }
+
+    bool StateSnapshotter::write_if_changed()
+    {
+        return write(false);
+    }
+
+    bool StateSnapshotter::write_now()
+    {
+        if (!config_.enabled || config_.path.empty())
+        {
+            return false;
+        }
+        return write(true);
+    }
+
+    bool StateSnapshotter::write(const bool force)
+    {
+        std::scoped_lock write_lock(write_mutex_);
+        if (!force && state_->revision() == written_revision_)
+        {
+            return false;
+        }
+
+        const auto logger = utils::get_operational_logger();
+        try
+        {
+            uint64_t revision = 0;
+            const std::string bytes = state_->encode_snapshot(revision);
+
+            const std::string temp_path = config_.path + ".tmp";
+            {
+                std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+                out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+                if (!out)
+                {
+                    logger->error("Failed to write state snapshot '{}'.", temp_path);
+                    return false;
+                }
+            }
+            std::error_code ec;
+            fs::rename(temp_path, config_.path, ec);
+            if (ec)
+            {
+                logger->error("Failed to move state snapshot into place at '{}': {}", config_.path, ec.message());
+                return false;
+            }
+
+            written_revision_ = revision;
+            logger->debug("Wrote state snapshot '{}' ({} bytes, revision {}).", config_.path, bytes.size(), revision);
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            logger->error("Failed to write state snapshot '{}': {}", config_.path, e.what());
+            return false;
+        }
+    }
+} // namespace honeypot::state
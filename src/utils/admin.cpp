@@ -0,0 +1,277 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <fmt/core.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "utils/admin.hpp"
+#include "utils/logging.hpp"
+
+namespace honeypot::utils
+{
+    namespace
+    {
+        // Admin clients are operators and scripts; anything beyond this is refused on connect.
+        constexpr size_t max_clients = 8;
+    }
+
+    void AdminServer::on_command(std::string name, std::string usage, Handler handler)
+    {
+        commands_.push_back({std::move(name), std::move(usage), std::move(handler)});
+    }
+
+    std::string AdminServer::execute(std::string_view line) const
+    {
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.remove_suffix(1);
+        }
+        const size_t space = line.find(' ');
+        const std::string_view name = line.substr(0, space);
+        const std::string_view argument = space == std::string_view::npos ? std::string_view{} : line.substr(space + 1);
+
+        nlohmann::json reply;
+        try
+        {
+            if (name == "help")
+            {
+                nlohmann::json usages = nlohmann::json::object();
+                usages["help"] = "help";
+                for (const Command& command : commands_)
+                {
+                    usages[command.name] = command.usage;
+                }
+                reply = {{"ok", true}, {"result", std::move(usages)}};
+            }
+            else if (const auto it = std::ranges::find(commands_, name, &Command::name); it != commands_.end())
+            {
+                reply = {{"ok", true}, {"result", it->handler(argument)}};
+            }
+            else
+            {
+                reply = {{"ok", false}, {"error", fmt::format("unknown command '{}', try 'help'", name)}};
+            }
+        }
+        catch (const std::exception& e)
+        {
+            reply = {{"ok", false}, {"error", e.what()}};
+        }
+        std::string out = reply.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+        out += '\n';
+        return out;
+    }
+
+#ifndef _WIN32
+    AdminServer::AdminServer(std::string socket_path)
+        : socket_path_(std::move(socket_path))
+    {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (socket_path_.size() >= sizeof(address.sun_path))
+        {
+            throw std::runtime_error(fmt::format("admin socket path '{}' is too long", socket_path_));
+        }
+        std::memcpy(address.sun_path, socket_path_.c_str(), socket_path_.size() + 1);
+
+        // A socket left by a previous run is replaced; anything else at the path is not ours to delete.
+        struct stat existing{};
+        if (::lstat(socket_path_.c_str(), &existing) == 0)
+        {
+            if (!S_ISSOCK(existing.st_mode))
+            {
+                throw std::runtime_error(fmt::format("admin socket path '{}' exists and is not a socket", socket_path_));
+            }
+            ::unlink(socket_path_.c_str());
+        }
+
+        listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listen_fd_ < 0 || ::pipe2(wake_fds_, O_NONBLOCK | O_CLOEXEC) != 0)
+        {
+            throw std::runtime_error(fmt::format("cannot create admin socket: {}", std::strerror(errno)));
+        }
+        // Created owner-only from the start, so there is no window in which others can connect.
+        const mode_t previous_umask = ::umask(0077);
+        const bool bound = ::bind(listen_fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+        ::umask(previous_umask);
+        if (!bound || ::listen(listen_fd_, 4) != 0)
+        {
+            const std::string error = std::strerror(errno);
+            ::close(listen_fd_);
+            ::close(wake_fds_[0]);
+            ::close(wake_fds_[1]);
+            throw std::runtime_error(fmt::format("cannot listen on admin socket '{}': {}", socket_path_, error));
+        }
+    }
+
+    AdminServer::~AdminServer()
+    {
+        stopping_.store(true, std::memory_order_relaxed);
+        constexpr char byte = 0;
+        [[maybe_unused]] const auto written = ::write(wake_fds_[1], &byte, 1);
+        if (io_thread_.joinable())
+        {
+            io_thread_.join();
+        }
+
+        for (const auto& client : clients_)
+        {
+            ::close(client->fd);
+        }
+        ::close(listen_fd_);
+        ::close(wake_fds_[0]);
+        ::close(wake_fds_[1]);
+        ::unlink(socket_path_.c_str());
+    }
+
+    void AdminServer::start()
+    {
+        io_thread_ = std::thread([this] { run(); });
+    }
+
+    void AdminServer::accept_clients()
+    {
+        while (true)
+        {
+            const int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0)
+            {
+                return;
+            }
+            if (clients_.size() >= max_clients)
+            {
+                ::close(fd);
+                get_operational_logger()->warn("Refused admin client: {} already connected.", clients_.size());
+                continue;
+            }
+            auto client = std::make_unique<Client>();
+            client->fd = fd;
+            clients_.push_back(std::move(client));
+        }
+    }
+
+    bool AdminServer::serve(Client& client)
+    {
+        char buffer[4096];
+        while (true)
+        {
+            const ssize_t received = ::recv(client.fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+            if (received > 0)
+            {
+                client.input.append(buffer, static_cast<size_t>(received));
+                continue;
+            }
+            if (received == 0)
+            {
+                // Still gets the replies to what it sent before shutting down.
+                client.reading = false;
+            }
+            else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            {
+                return false;
+            }
+            break;
+        }
+
+        size_t line_start = 0;
+        for (size_t newline; (newline = client.input.find('\n', line_start)) != std::string::npos;
+             line_start = newline + 1)
+        {
+            const std::string_view line(client.input.data() + line_start, newline - line_start);
+            if (!line.empty())
+            {
+                client.output += execute(line);
+            }
+        }
+        client.input.erase(0, line_start);
+        if (client.input.size() > admin_max_line_bytes)
+        {
+            return false;
+        }
+
+        return flush(client);
+    }
+
+    bool AdminServer::flush(Client& client)
+    {
+        while (!client.output.empty())
+        {
+            const ssize_t sent = ::send(client.fd, client.output.data(), client.output.size(),
+                                        MSG_DONTWAIT | MSG_NOSIGNAL);
+            if (sent < 0)
+            {
+                return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+            }
+            client.output.erase(0, static_cast<size_t>(sent));
+        }
+        return client.reading;
+    }
+
+    void AdminServer::run()
+    {
+        std::vector<pollfd> fds;
+        while (!stopping_.load(std::memory_order_relaxed))
+        {
+            fds.assign({{wake_fds_[0], POLLIN, 0}, {listen_fd_, POLLIN, 0}});
+            for (const auto& client : clients_)
+            {
+                const short events = (client->reading ? POLLIN : 0) | (client->output.empty() ? 0 : POLLOUT);
+                fds.push_back({client->fd, events, 0});
+            }
+
+            if (::poll(fds.data(), fds.size(), -1) < 0)
+            {
+                continue;
+            }
+
+            // Clients accepted below are polled from the next round on.
+            const size_t polled = clients_.size();
+            if (fds[1].revents & POLLIN)
+            {
+                accept_clients();
+            }
+
+            for (size_t i = polled; i-- > 0;)
+            {
+                const short revents = fds[i + 2].revents;
+                bool alive = (revents & (POLLERR | POLLNVAL)) == 0;
+                if (alive && clients_[i]->reading && (revents & (POLLIN | POLLHUP)))
+                {
+                    alive = serve(*clients_[i]);
+                }
+                else if (alive && (revents & POLLOUT))
+                {
+                    alive = flush(*clients_[i]);
+                }
+                if (!alive)
+                {
+                    ::close(clients_[i]->fd);
+                    clients_.erase(clients_.begin() + static_cast<std::ptrdiff_t>(i));
+                }
+            }
+        }
+    }
+#else
+    AdminServer::AdminServer(std::string socket_path)
+        : socket_path_(std::move(socket_path))
+    {
+        throw std::runtime_error("the admin socket needs Unix domain sockets");
+    }
+
+    AdminServer::~AdminServer() = default;
+
+    void AdminServer::start()
+    {
+    }
+#endif
+} // namespace honeypot::utils
@@ -0,0 +1,231 @@
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <memory>
+#include <string_view>
+
+#include <asio.hpp>
+
+#include "utils/admission.hpp"
+#include "utils/logging.hpp"
+
+namespace honeypot::utils
+{
+    namespace
+    {
+        std::unique_ptr<AdmissionController> admission;
+
+        // What Ollama answers when its request queue is full.
+        constexpr std::string_view busy_body =
+            R"({"error":"server busy, please try again.  maximum pending requests exceeded"})";
+
+        // Repeat slots keep the fingerprint above these bits and the second it was seen below them.
+        constexpr uint64_t seen_mask = (uint64_t{1} << 24) - 1;
+
+        bool is_generation_route(const std::string_view url)
+        {
+            return url == "/api/generate" || url == "/api/chat" || url == "/v1/chat/completions"
+                || url == "/v1/completions";
+        }
+    }
+
+    AdmissionController::AdmissionController(const config::AdmissionConfig& config)
+        : config_(config),
+          epoch_(Clock::now()),
+          repeat_slots_(config.enabled ? std::make_unique<std::atomic<uint64_t>[]>(repeat_slots) : nullptr)
+    {
+    }
+
+    void AdmissionController::sample_queue_delay(const crow::request& req, const Clock::time_point now)
+    {
+        if (req.io_context == nullptr)
+        {
+            return;
+        }
+        const int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - epoch_).count();
+        int64_t next_probe = next_probe_ns_.load(std::memory_order_relaxed);
+        if (now_ns < next_probe
+            || !next_probe_ns_.compare_exchange_strong(
+                next_probe, now_ns + std::chrono::nanoseconds(probe_interval).count(), std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        // The probe runs once the handlers queued ahead of it on this worker have run.
+        asio::post(*req.io_context, [this, posted = now] {
+            const auto delay = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - posted).count());
+            const uint64_t smoothed = queue_delay_ns_.load(std::memory_order_relaxed);
+            queue_delay_ns_.store(smoothed - smoothed / 8 + delay / 8, std::memory_order_relaxed);
+        });
+    }
+
+    bool AdmissionController::overloaded(const Clock::time_point now)
+    {
+        const uint64_t delay = queue_delay_ns_.load(std::memory_order_relaxed);
+        const uint64_t in_flight = in_flight_.load(std::memory_order_relaxed);
+        const uint64_t delay_limit = uint64_t{config_.max_queue_delay_ms} * 1'000'000;
+        const uint64_t in_flight_limit = config_.max_in_flight;
+
+        // Overload ends only once both measures are a quarter below their limits, so it does not flap.
+        const bool was_overloaded = overloaded_.load(std::memory_order_relaxed);
+        const bool is_overloaded = was_overloaded
+                                       ? delay * 4 > delay_limit * 3 || in_flight * 4 > in_flight_limit * 3
+                                       : delay > delay_limit || in_flight > in_flight_limit;
+        if (is_overloaded == was_overloaded)
+        {
+            return is_overloaded;
+        }
+
+        std::scoped_lock lock(transition_mutex_);
+        if (overloaded_.load(std::memory_order_relaxed) == is_overloaded)
+        {
+            return is_overloaded;
+        }
+        overloaded_.store(is_overloaded, std::memory_order_relaxed);
+
+        const uint64_t shed = shed_flagged_.load(std::memory_order_relaxed)
+            + shed_repeated_.load(std::memory_order_relaxed);
+        if (is_overloaded)
+        {
+            overload_episodes_.fetch_add(1, std::memory_order_relaxed);
+            shed_at_overload_start_ = shed;
+            overload_started_ = now;
+            get_operational_logger()->warn(
+                "Overloaded (queue delay {} ms, {} requests in flight): shedding flagged and repeated requests.",
+                delay / 1'000'000, in_flight);
+        }
+        else
+        {
+            get_operational_logger()->info("Overload ended after {} ms; {} requests shed.",
+                                           std::chrono::duration_cast<std::chrono::milliseconds>(
+                                               now - overload_started_).count(),
+                                           shed - shed_at_overload_start_);
+        }
+        return is_overloaded;
+    }
+
+    bool AdmissionController::is_repeat(const crow::request& req, const Clock::time_point now)
+    {
+        const auto method = static_cast<char>(req.method);
+        const uint64_t fingerprint = fnv1a_64(req.url, fnv1a_64(std::string_view(&method, 1),
+                                                                  fnv1a_64(req.remote_ip_address)));
+        const auto seen = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::seconds>(now - epoch_).count()) & seen_mask;
+        const uint64_t tag = fingerprint & ~seen_mask;
+
+        const uint64_t previous = repeat_slots_[fingerprint % repeat_slots].exchange(tag | seen,
+                                                                                     std::memory_order_relaxed);
+        return (previous & ~seen_mask) == tag && ((seen - previous) & seen_mask) < config_.repeat_window_seconds;
+    }
+
+    bool AdmissionController::in_conversation(const std::string_view source_ip, const Clock::time_point now)
+    {
+        Shard& shard = shards_[TransparentStringHash{}(source_ip) % shard_count];
+        std::scoped_lock lock(shard.mutex);
+        const auto it = shard.conversations.find(source_ip);
+        return it != shard.conversations.end() && it->second > now;
+    }
+
+    void AdmissionController::note_conversation(const std::string_view source_ip, const Clock::time_point now)
+    {
+        Shard& shard = shards_[TransparentStringHash{}(source_ip) % shard_count];
+        const auto until = now + std::chrono::seconds(config_.conversation_seconds);
+        std::scoped_lock lock(shard.mutex);
+        if (auto it = shard.conversations.find(source_ip); it != shard.conversations.end())
+        {
+            it.value() = until;
+            return;
+        }
+        if (shard.conversations.size() >= max_conversations_per_shard)
+        {
+            for (auto it = shard.conversations.begin(); it != shard.conversations.end();)
+            {
+                it = it->second <= now ? shard.conversations.erase(it) : std::next(it);
+            }
+            if (shard.conversations.size() >= max_conversations_per_shard)
+            {
+                return;
+            }
+        }
+        shard.conversations.emplace(std::string(source_ip), until);
+    }
+
+    AdmissionController::Decision AdmissionController::admit(const crow::request& req, crow::response& res,
+                                                             const bool flagged)
+    {
+        if (!config_.enabled)
+        {
+            return Decision::uncounted;
+        }
+
+        const auto now = Clock::now();
+        sample_queue_delay(req, now);
+        const bool repeat = is_repeat(req, now);
+        const bool overload = overloaded(now);
+
+        if (overload && (flagged || repeat) && !in_conversation(req.remote_ip_address, now))
+        {
+            (flagged ? shed_flagged_ : shed_repeated_).fetch_add(1, std::memory_order_relaxed);
+            res.code = crow::status::SERVICE_UNAVAILABLE;
+            res.set_header("Content-Type", "application/json; charset=utf-8");
+            res.body = busy_body;
+            res.end();
+            return Decision::shed;
+        }
+
+        admitted_.fetch_add(1, std::memory_order_relaxed);
+        if (flagged)
+        {
+            return Decision::uncounted; // held by the tarpit, which bounds those itself
+        }
+        in_flight_.fetch_add(1, std::memory_order_relaxed);
+        return Decision::counted;
+    }
+
+    void AdmissionController::release(const crow::request& req, const crow::response& res, const Decision decision)
+    {
+        if (decision == Decision::counted)
+        {
+            in_flight_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        if (config_.enabled && decision != Decision::shed && res.code == crow::status::OK
+            && is_generation_route(req.url))
+        {
+            note_conversation(req.remote_ip_address, Clock::now());
+        }
+    }
+
+    AdmissionController::Stats AdmissionController::stats() const
+    {
+        return {
+            .admitted = admitted_.load(std::memory_order_relaxed),
+            .shed_flagged = shed_flagged_.load(std::memory_order_relaxed),
+            .shed_repeated = shed_repeated_.load(std::memory_order_relaxed),
+            .overload_episodes = overload_episodes_.load(std::memory_order_relaxed),
+            .queue_delay_us = queue_delay_ns_.load(std::memory_order_relaxed) / 1000,
+            .in_flight = in_flight_.load(std::memory_order_relaxed),
+        };
+    }
+
+    void init_admission(const config::HoneypotConfig& config)
+    {
+        admission = std::make_unique<AdmissionController>(config.admission);
+        if (config.admission.enabled)
+        {
+            get_operational_logger()->info(
+                "Admission control enabled: sheds flagged and repeated requests past {} ms queue delay or {} "
+                "requests in flight.", config.admission.max_queue_delay_ms, config.admission.max_in_flight);
+        }
+    }
+
+    AdmissionController& get_admission()
+    {
+        if (!admission)
+        {
+            static AdmissionController disabled{config::AdmissionConfig{.enabled = false}};
+            return disabled;
+        }
+        return *admission;
+    }
+} // namespace honeypot::utils
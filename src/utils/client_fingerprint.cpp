@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <array>
+#include <string_view>
+#include <utility>
+
+#include <fmt/core.h>
+
+#include "utils/client_fingerprint.hpp"
+
+namespace honeypot::utils
+{
+    namespace
+    {
+        // Crow-parsed requests with more headers than this are fingerprinted on the first ones in name order.
+        constexpr size_t max_sorted_headers = 64;
+
+        char lower(const char c)
+        {
+            return c >= 'A' && c <= 'Z' ? static_cast<char>(c | 0x20) : c;
+        }
+
+        bool iequals(const std::string_view a, const std::string_view b)
+        {
+            return std::ranges::equal(a, b, [](const char x, const char y) { return lower(x) == lower(y); });
+        }
+
+        uint64_t fnv1a_64_lower(const std::string_view data, uint64_t seed = fnv1a_offset_basis)
+        {
+            for (const char c : data)
+            {
+                seed ^= static_cast<unsigned char>(lower(c));
+                seed *= fnv1a_prime;
+            }
+            return seed;
+        }
+
+        // "Mozilla/5.0 (X11; ...)" -> "Mozilla", "python-requests/2.31" -> "python-requests".
+        std::string_view product_name(const std::string_view user_agent)
+        {
+            return user_agent.substr(0, user_agent.find_first_of("/ "));
+        }
+
+        std::string_view method_token(const crow::HTTPMethod method)
+        {
+            switch (method)
+            {
+            case crow::HTTPMethod::Get: return "GET";
+            case crow::HTTPMethod::Post: return "POST";
+            case crow::HTTPMethod::Head: return "HEAD";
+            case crow::HTTPMethod::Put: return "PUT";
+            case crow::HTTPMethod::Delete: return "DELETE";
+            case crow::HTTPMethod::Options: return "OPTIONS";
+            case crow::HTTPMethod::Patch: return "PATCH";
+            case crow::HTTPMethod::Connect: return "CONNECT";
+            case crow::HTTPMethod::Trace: return "TRACE";
+            default: return "??";
+            }
+        }
+    }
+
+    void ClientFingerprint::Builder::add_header(const std::string_view name, const std::string_view value)
+    {
+        ++count_;
+        names_ = fnv1a_64_lower(name, names_);
+        names_ = fnv1a_64(",", names_);
+        for (const char c : name)
+        {
+            casing_ = fnv1a_64(c >= 'A' && c <= 'Z' ? "U" : "l", casing_);
+        }
+        casing_ = fnv1a_64(",", casing_);
+
+        if (!has_accept_ && iequals(name, "Accept"))
+        {
+            has_accept_ = true;
+            accept_ = fnv1a_64(value);
+        }
+        else if (!has_user_agent_ && iequals(name, "User-Agent"))
+        {
+            has_user_agent_ = true;
+            user_agent_family_ = fnv1a_64_lower(product_name(value));
+        }
+    }
+
+    ClientFingerprint ClientFingerprint::Builder::finish(const std::string_view method, const std::string_view version,
+                                                         const bool arrival_order) const
+    {
+        const std::array<uint64_t, 2> values{accept_, user_agent_family_};
+        const uint64_t values_hash = has_accept_ || has_user_agent_
+                                         ? fnv1a_64(std::string_view(reinterpret_cast<const char*>(values.data()),
+                                                                     sizeof(values)))
+                                         : 0;
+        const std::string_view digits = version.substr(std::min(version.size(), std::string_view("HTTP/").size()));
+
+        ClientFingerprint fingerprint;
+        const auto result = fmt::format_to_n(
+            fingerprint.text_.data(), fingerprint.text_.size(), "{}{}{}{}{}{:02}_{:012x}_{:08x}_{:08x}",
+            lower(method.empty() ? '?' : method[0]), lower(method.size() < 2 ? '?' : method[1]),
+            digits.empty() ? '0' : digits[0], digits.size() < 3 ? '0' : digits[2], arrival_order ? 'o' : 's',
+            std::min(count_, 99u), names_ >> 16, casing_ >> 32, values_hash >> 32);
+        fingerprint.size_ = static_cast<uint8_t>(std::min(result.size, fingerprint.text_.size()));
+        return fingerprint;
+    }
+
+    ClientFingerprint ClientFingerprint::of_request(const crow::request& req)
+    {
+        std::array<std::pair<std::string_view, std::string_view>, max_sorted_headers> headers;
+        size_t count = 0;
+        for (const auto& [name, value] : req.headers)
+        {
+            if (count == headers.size())
+            {
+                break;
+            }
+            headers[count++] = {name, value};
+        }
+        std::ranges::sort(headers.begin(), headers.begin() + static_cast<std::ptrdiff_t>(count),
+                          [](const auto& a, const auto& b) {
+                              return std::ranges::lexicographical_compare(
+                                  a.first, b.first, [](const char x, const char y) { return lower(x) < lower(y); });
+                          });
+
+        Builder builder;
+        for (size_t i = 0; i < count; ++i)
+        {
+            builder.add_header(headers[i].first, headers[i].second);
+        }
+        const char version[] = {'H', 'T', 'T', 'P', '/', static_cast<char>('0' + req.http_ver_major % 10), '.',
+                                static_cast<char>('0' + req.http_ver_minor % 10)};
+        return builder.finish(method_token(req.method), std::string_view(version, sizeof(version)), false);
+    }
+
+    ClientFingerprint ClientFingerprint::parse(const std::string_view text)
+    {
+        ClientFingerprint fingerprint;
+        const bool valid = !text.empty() && text.size() <= max_length && std::ranges::all_of(text, [](const char c) {
+            return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || c == '_' || c == '?';
+        });
+        if (valid)
+        {
+            std::ranges::copy(text, fingerprint.text_.begin());
+            fingerprint.size_ = static_cast<uint8_t>(text.size());
+        }
+        return fingerprint;
+    }
+} // namespace honeypot::utils
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <fstream>
 #include <stdexcept>
 #include <string_view>
@@ -68,10 +69,28 @@ namespace honeypot::config
         p.details = j.value("details", defaults.details); // delegate details deserialization
     }
 
+    void to_json(ordered_json& j, const ListenerConfig& p)
+    {
+        j["address"] = p.address;
+        j["port"] = p.port;
+        j["name"] = p.name;
+        j["ollama_version"] = p.ollama_version;
+    }
+
+    void from_json(const ordered_json& j, ListenerConfig& p)
+    {
+        ListenerConfig defaults;
+        p.address = j.value("address", defaults.address);
+        p.port = j.value("port", defaults.port);
+        p.name = j.value("name", defaults.name);
+        p.ollama_version = j.value("ollama_version", defaults.ollama_version);
+    }
+
     void to_json(ordered_json& j, const ServerConfig& p)
     {
         j["listen_address"] = p.listen_address;
         j["listen_port"] = p.listen_port;
+        j["listeners"] = p.listeners;
     }
 
     void from_json(const ordered_json& j, ServerConfig& p)
@@ -79,6 +98,22 @@ namespace honeypot::config
         ServerConfig defaults;
         p.listen_address = j.value("listen_address", defaults.listen_address);
         p.listen_port = j.value("listen_port", defaults.listen_port);
+        p.listeners = j.value("listeners", defaults.listeners);
+    }
+
+    void to_json(ordered_json& j, const FastPathConfig& p)
+    {
+        j["enabled"] = p.enabled;
+        j["backend_port"] = p.backend_port;
+        j["threads"] = p.threads;
+    }
+
+    void from_json(const ordered_json& j, FastPathConfig& p)
+    {
+        FastPathConfig defaults;
+        p.enabled = j.value("enabled", defaults.enabled);
+        p.backend_port = j.value("backend_port", defaults.backend_port);
+        p.threads = j.value("threads", defaults.threads);
     }
 
     void to_json(ordered_json& j, const LoggingConfig& p)
@@ -88,6 +123,11 @@ namespace honeypot::config
         j["log_file_path"] = p.log_file_path;
         j["log_pattern"] = p.log_pattern;
         j["request_log_path"] = p.request_log_path;
+        j["ip_index_path"] = p.ip_index_path;
+        j["collapse_window_seconds"] = p.collapse_window_seconds;
+        j["event_socket_path"] = p.event_socket_path;
+        j["event_buffer_bytes"] = p.event_buffer_bytes;
+        j["prompt_signatures_path"] = p.prompt_signatures_path;
     }
 
     void from_json(const ordered_json& j, LoggingConfig& p)
@@ -98,6 +138,11 @@ namespace honeypot::config
         p.log_file_path = j.value("log_file_path", defaults.log_file_path);
         p.log_pattern = j.value("log_pattern", defaults.log_pattern);
         p.request_log_path = j.value("request_log_path", defaults.request_log_path);
+        p.ip_index_path = j.value("ip_index_path", defaults.ip_index_path);
+        p.collapse_window_seconds = j.value("collapse_window_seconds", defaults.collapse_window_seconds);
+        p.event_socket_path = j.value("event_socket_path", defaults.event_socket_path);
+        p.event_buffer_bytes = j.value("event_buffer_bytes", defaults.event_buffer_bytes);
+        p.prompt_signatures_path = j.value("prompt_signatures_path", defaults.prompt_signatures_path);
     }
 
     void to_json(ordered_json& j, const ApiBehaviorConfig& p)
@@ -111,6 +156,11 @@ namespace honeypot::config
             show_map_json[key] = val;
         }
         j["show_file_map"] = std::move(show_map_json);
+        j["response_template_dir"] = p.response_template_dir;
+        j["text_model_path"] = p.text_model_path;
+        j["catalog_dir"] = p.catalog_dir;
+        j["detail_cache_bytes"] = p.detail_cache_bytes;
+        j["catalog_cache_bytes"] = p.catalog_cache_bytes;
     }
 
     void from_json(const ordered_json& j, ApiBehaviorConfig& p)
@@ -147,21 +197,160 @@ namespace honeypot::config
                 }
             }
         }
+
+        p.response_template_dir = j.value("response_template_dir", defaults.response_template_dir);
+        p.text_model_path = j.value("text_model_path", defaults.text_model_path);
+        p.catalog_dir = j.value("catalog_dir", defaults.catalog_dir);
+        p.detail_cache_bytes = j.value("detail_cache_bytes", defaults.detail_cache_bytes);
+        p.catalog_cache_bytes = j.value("catalog_cache_bytes", defaults.catalog_cache_bytes);
+    }
+
+    void to_json(ordered_json& j, const LatencyConfig& p)
+    {
+        j["enabled"] = p.enabled;
+        j["jitter"] = p.jitter;
+        j["memory_bandwidth_gbps"] = p.memory_bandwidth_gbps;
+        j["prompt_speedup"] = p.prompt_speedup;
+        j["load_bandwidth_mbps"] = p.load_bandwidth_mbps;
+        j["load_overhead_ms"] = p.load_overhead_ms;
+        j["warm_load_ms"] = p.warm_load_ms;
+    }
+
+    void from_json(const ordered_json& j, LatencyConfig& p)
+    {
+        LatencyConfig defaults;
+        p.enabled = j.value("enabled", defaults.enabled);
+        p.jitter = j.value("jitter", defaults.jitter);
+        p.memory_bandwidth_gbps = j.value("memory_bandwidth_gbps", defaults.memory_bandwidth_gbps);
+        p.prompt_speedup = j.value("prompt_speedup", defaults.prompt_speedup);
+        p.load_bandwidth_mbps = j.value("load_bandwidth_mbps", defaults.load_bandwidth_mbps);
+        p.load_overhead_ms = j.value("load_overhead_ms", defaults.load_overhead_ms);
+        p.warm_load_ms = j.value("warm_load_ms", defaults.warm_load_ms);
+    }
+
+    void to_json(ordered_json& j, const TarpitConfig& p)
+    {
+        j["enabled"] = p.enabled;
+        j["window_seconds"] = p.window_seconds;
+        j["max_requests_per_window"] = p.max_requests_per_window;
+        j["flag_seconds"] = p.flag_seconds;
+        j["initial_hold_ms"] = p.initial_hold_ms;
+        j["max_hold_ms"] = p.max_hold_ms;
+        j["max_held_connections"] = p.max_held_connections;
+    }
+
+    void from_json(const ordered_json& j, TarpitConfig& p)
+    {
+        TarpitConfig defaults;
+        p.enabled = j.value("enabled", defaults.enabled);
+        p.window_seconds = j.value("window_seconds", defaults.window_seconds);
+        p.max_requests_per_window = j.value("max_requests_per_window", defaults.max_requests_per_window);
+        p.flag_seconds = j.value("flag_seconds", defaults.flag_seconds);
+        p.initial_hold_ms = j.value("initial_hold_ms", defaults.initial_hold_ms);
+        p.max_hold_ms = j.value("max_hold_ms", defaults.max_hold_ms);
+        p.max_held_connections = j.value("max_held_connections", defaults.max_held_connections);
+    }
+
+    void to_json(ordered_json& j, const AdmissionConfig& p)
+    {
+        j["enabled"] = p.enabled;
+        j["max_queue_delay_ms"] = p.max_queue_delay_ms;
+        j["max_in_flight"] = p.max_in_flight;
+        j["repeat_window_seconds"] = p.repeat_window_seconds;
+        j["conversation_seconds"] = p.conversation_seconds;
+    }
+
+    void from_json(const ordered_json& j, AdmissionConfig& p)
+    {
+        AdmissionConfig defaults;
+        p.enabled = j.value("enabled", defaults.enabled);
+        p.max_queue_delay_ms = j.value("max_queue_delay_ms", defaults.max_queue_delay_ms);
+        p.max_in_flight = j.value("max_in_flight", defaults.max_in_flight);
+        p.repeat_window_seconds = j.value("repeat_window_seconds", defaults.repeat_window_seconds);
+        p.conversation_seconds = j.value("conversation_seconds", defaults.conversation_seconds);
+    }
+
+    void to_json(ordered_json& j, const SnapshotConfig& p)
+    {
+        j["enabled"] = p.enabled;
+        j["path"] = p.path;
+        j["interval_seconds"] = p.interval_seconds;
+    }
+    void from_json(const ordered_json& j, SnapshotConfig& p)
+    {
+        SnapshotConfig defaults;
+        p.enabled = j.value("enabled", defaults.enabled);
+        p.path = j.value("path", defaults.path);
+        p.interval_seconds = j.value("interval_seconds", defaults.interval_seconds);
+    }
+
+    void to_json(ordered_json& j, const SessionConfig& p)
+    {
+        j["ttl_seconds"] = p.ttl_seconds;
+        j["max_sessions"] = p.max_sessions;
+    }
+    void from_json(const ordered_json& j, SessionConfig& p)
+    {
+        SessionConfig defaults;
+        p.ttl_seconds = j.value("ttl_seconds", defaults.ttl_seconds);
+        p.max_sessions = j.value("max_sessions", defaults.max_sessions);
+    }
+
+    void to_json(ordered_json& j, const TracingConfig& p)
+    {
+        j["enabled"] = p.enabled;
+        j["sample_rate"] = p.sample_rate;
+        j["spans_per_thread"] = p.spans_per_thread;
+        j["dump_path"] = p.dump_path;
+    }
+    void from_json(const ordered_json& j, TracingConfig& p)
+    {
+        TracingConfig defaults;
+        p.enabled = j.value("enabled", defaults.enabled);
+        p.sample_rate = j.value("sample_rate", defaults.sample_rate);
+        p.spans_per_thread = j.value("spans_per_thread", defaults.spans_per_thread);
+        p.dump_path = j.value("dump_path", defaults.dump_path);
+    }
+
+    void to_json(ordered_json& j, const AdminConfig& p)
+    {
+        j["socket_path"] = p.socket_path;
+    }
+    void from_json(const ordered_json& j, AdminConfig& p)
+    {
+        AdminConfig defaults;
+        p.socket_path = j.value("socket_path", defaults.socket_path);
     }
 
     void to_json(ordered_json& j, const HoneypotConfig& p)
     {
         j["server"] = p.server; // delegates to ServerConfig's to_json
+        j["fast_path"] = p.fast_path;
         j["logging"] = p.logging; // delegates to LoggingConfig's to_json
         j["api_behavior"] = p.api_behavior; // delegates to ApiBehaviorConfig's to_json
+        j["latency"] = p.latency;
+        j["tarpit"] = p.tarpit;
+        j["admission"] = p.admission;
+        j["snapshot"] = p.snapshot;
+        j["sessions"] = p.sessions;
+        j["tracing"] = p.tracing;
+        j["admin"] = p.admin;
     }
 
     void from_json(const ordered_json& j, HoneypotConfig& p)
     {
         HoneypotConfig defaults;
         p.server = j.value("server", defaults.server);
+        p.fast_path = j.value("fast_path", defaults.fast_path);
         p.logging = j.value("logging", defaults.logging);
         p.api_behavior = j.value("api_behavior", defaults.api_behavior);
+        p.latency = j.value("latency", defaults.latency);
+        p.tarpit = j.value("tarpit", defaults.tarpit);
+        p.admission = j.value("admission", defaults.admission);
+        p.snapshot = j.value("snapshot", defaults.snapshot);
+        p.sessions = j.value("sessions", defaults.sessions);
+        p.tracing = j.value("tracing", defaults.tracing);
+        p.admin = j.value("admin", defaults.admin);
     }
 
 
@@ -200,6 +389,32 @@ namespace honeypot::config
         {
             throw std::runtime_error("Configuration error: 'server.listen_port' cannot be 0.");
         }
+        const auto& listeners = loaded_config.server.listeners;
+        for (auto it = listeners.begin(); it != listeners.end(); ++it)
+        {
+            if (it->port == 0)
+            {
+                throw std::runtime_error("Configuration error: 'server.listeners' port cannot be 0.");
+            }
+            if (std::ranges::any_of(listeners.begin(), it, [&](const ListenerConfig& other) {
+                return other.port == it->port && other.address == it->address;
+            }))
+            {
+                throw std::runtime_error(fmt::format(
+                    "Configuration error: 'server.listeners' lists {}:{} more than once.", it->address, it->port));
+            }
+        }
+        const bool front_listener = loaded_config.fast_path.enabled || !listeners.empty();
+        const bool backend_port_taken = listeners.empty()
+            ? loaded_config.fast_path.backend_port == loaded_config.server.listen_port
+            : std::ranges::any_of(listeners, [&](const ListenerConfig& listener) {
+                return listener.port == loaded_config.fast_path.backend_port;
+            });
+        if (front_listener && (loaded_config.fast_path.backend_port == 0 || backend_port_taken))
+        {
+            throw std::runtime_error(
+                "Configuration error: 'fast_path.backend_port' must be non-zero and differ from every listening port.");
+        }
 
         fs::path config_dir = fs::path(config_path).parent_path();
         std::vector<std::string> missing_files;
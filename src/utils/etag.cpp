@@ -0,0 +1,75 @@
+#include <string>
+#include <string_view>
+
+#include <fmt/core.h>
+#include <crow.h>
+
+#include "utils/etag.hpp"
+
+namespace honeypot::utils
+{
+    namespace
+    {
+        constexpr std::string_view trim(std::string_view s)
+        {
+            while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+            {
+                s.remove_prefix(1);
+            }
+            while (!s.empty() && (s.back() == ' ' || s.back() == '\t'))
+            {
+                s.remove_suffix(1);
+            }
+            return s;
+        }
+
+        constexpr std::string_view strip_weak(std::string_view tag)
+        {
+            if (tag.starts_with("W/"))
+            {
+                tag.remove_prefix(2);
+            }
+            return tag;
+        }
+    }
+
+    std::string make_strong_etag(const std::string_view prefix, const uint64_t value)
+    {
+        return fmt::format("\"{}-{:016x}\"", prefix, value);
+    }
+
+    bool if_none_match_hits(const std::string_view if_none_match, const std::string_view etag)
+    {
+        const std::string_view current = strip_weak(etag);
+        std::string_view rest = if_none_match;
+
+        while (!rest.empty())
+        {
+            const size_t comma = rest.find(',');
+            const std::string_view candidate = trim(rest.substr(0, comma));
+            rest = comma == std::string_view::npos ? std::string_view{} : rest.substr(comma + 1);
+
+            if (candidate == "*" || (!candidate.empty() && strip_weak(candidate) == current))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool request_matches_etag(const crow::request& req, const std::string_view etag)
+    {
+        if (!req.headers.contains("If-None-Match"))
+        {
+            return false;
+        }
+        return if_none_match_hits(req.get_header_value("If-None-Match"), etag);
+    }
+
+    crow::response make_not_modified(const std::string_view etag)
+    {
+        crow::response res(crow::status::NOT_MODIFIED);
+        res.set_header("ETag", std::string(etag));
+        return res;
+    }
+} // namespace honeypot::utils
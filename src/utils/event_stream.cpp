@@ -0,0 +1,285 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <fmt/core.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "utils/event_stream.hpp"
+#include "utils/logging.hpp"
+#include "utils/signals.hpp"
+
+namespace honeypot::utils
+{
+    bool EventStream::Consumer::push(const std::string_view header, const std::string_view payload)
+    {
+        const size_t frame_bytes = header.size() + payload.size();
+        if (ring.size() - size < frame_bytes)
+        {
+            ++frames_dropped;
+            return false;
+        }
+
+        size_t tail = (head + size) % ring.size();
+        for (const std::string_view part : {header, payload})
+        {
+            const size_t first = std::min(part.size(), ring.size() - tail);
+            std::memcpy(ring.data() + tail, part.data(), first);
+            std::memcpy(ring.data(), part.data() + first, part.size() - first);
+            tail = (tail + part.size()) % ring.size();
+        }
+        size += frame_bytes;
+        return true;
+    }
+
+#ifndef _WIN32
+    EventStream::EventStream(std::string socket_path, const size_t buffer_bytes)
+        : socket_path_(std::move(socket_path)),
+          buffer_bytes_(std::max<size_t>(buffer_bytes, 4096))
+    {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (socket_path_.size() >= sizeof(address.sun_path))
+        {
+            throw std::runtime_error(fmt::format("event socket path '{}' is too long", socket_path_));
+        }
+        std::memcpy(address.sun_path, socket_path_.c_str(), socket_path_.size() + 1);
+
+        // A socket left by a previous run is replaced; anything else at the path is not ours to delete.
+        struct stat existing{};
+        if (::lstat(socket_path_.c_str(), &existing) == 0)
+        {
+            if (!S_ISSOCK(existing.st_mode))
+            {
+                throw std::runtime_error(fmt::format("event socket path '{}' exists and is not a socket", socket_path_));
+            }
+            ::unlink(socket_path_.c_str());
+        }
+
+        listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listen_fd_ < 0 || ::pipe2(wake_fds_, O_NONBLOCK | O_CLOEXEC) != 0)
+        {
+            throw std::runtime_error(fmt::format("cannot create event socket: {}", std::strerror(errno)));
+        }
+        // Records carry bodies, prompts and client addresses: owner-only from the start, like the admin socket.
+        const mode_t previous_umask = ::umask(0077);
+        const bool bound = ::bind(listen_fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+        ::umask(previous_umask);
+        if (!bound || ::listen(listen_fd_, 16) != 0)
+        {
+            const std::string error = std::strerror(errno);
+            ::close(listen_fd_);
+            ::close(wake_fds_[0]);
+            ::close(wake_fds_[1]);
+            throw std::runtime_error(fmt::format("cannot listen on event socket '{}': {}", socket_path_, error));
+        }
+
+        // Started from init_logging(), possibly before main() masks the process; SIGHUP must never land here.
+        io_thread_ = std::thread([this] {
+            block_listener_signals();
+            run();
+        });
+    }
+
+    EventStream::~EventStream()
+    {
+        stopping_.store(true, std::memory_order_relaxed);
+        wake();
+        io_thread_.join();
+
+        std::scoped_lock lock(consumers_mutex_);
+        for (const auto& consumer : consumers_)
+        {
+            ::close(consumer->fd);
+        }
+        consumers_.clear();
+        ::close(listen_fd_);
+        ::close(wake_fds_[0]);
+        ::close(wake_fds_[1]);
+        ::unlink(socket_path_.c_str());
+    }
+
+    void EventStream::publish(const std::string_view record)
+    {
+        const auto length = static_cast<uint32_t>(record.size());
+        const char header[event_frame_header_bytes] = {
+            static_cast<char>(length & 0xff), static_cast<char>((length >> 8) & 0xff),
+            static_cast<char>((length >> 16) & 0xff), static_cast<char>((length >> 24) & 0xff)
+        };
+
+        // Only a ring going from empty to non-empty needs the I/O thread's attention.
+        bool needs_wake = false;
+        {
+            std::shared_lock lock(consumers_mutex_);
+            for (const auto& consumer : consumers_)
+            {
+                std::scoped_lock consumer_lock(consumer->mutex);
+                const bool was_empty = consumer->size == 0;
+                if (consumer->push(std::string_view(header, sizeof(header)), record))
+                {
+                    needs_wake |= was_empty;
+                }
+                else
+                {
+                    frames_dropped_.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+        if (needs_wake)
+        {
+            wake();
+        }
+    }
+
+    size_t EventStream::consumer_count() const
+    {
+        std::shared_lock lock(consumers_mutex_);
+        return consumers_.size();
+    }
+
+    void EventStream::wake()
+    {
+        // A full pipe already guarantees a wakeup, so EAGAIN is fine.
+        constexpr char byte = 0;
+        [[maybe_unused]] const auto written = ::write(wake_fds_[1], &byte, 1);
+    }
+
+    void EventStream::accept_consumers()
+    {
+        while (true)
+        {
+            const int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0)
+            {
+                return;
+            }
+            auto consumer = std::make_shared<Consumer>(fd, buffer_bytes_);
+            std::scoped_lock lock(consumers_mutex_);
+            consumers_.push_back(std::move(consumer));
+            get_operational_logger()->info("Event stream consumer connected ({} connected).", consumers_.size());
+        }
+    }
+
+    bool EventStream::drain(Consumer& consumer)
+    {
+        std::scoped_lock lock(consumer.mutex);
+        while (consumer.size > 0)
+        {
+            const size_t contiguous = std::min(consumer.size, consumer.ring.size() - consumer.head);
+            const ssize_t sent = ::send(consumer.fd, consumer.ring.data() + consumer.head, contiguous,
+                                        MSG_DONTWAIT | MSG_NOSIGNAL);
+            if (sent < 0)
+            {
+                return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+            }
+            consumer.head = (consumer.head + static_cast<size_t>(sent)) % consumer.ring.size();
+            consumer.size -= static_cast<size_t>(sent);
+        }
+        consumer.head = 0; // an empty ring restarts at the front, keeping sends contiguous
+        return true;
+    }
+
+    void EventStream::close_consumer(const std::shared_ptr<Consumer>& consumer)
+    {
+        {
+            std::scoped_lock lock(consumers_mutex_);
+            std::erase(consumers_, consumer);
+        }
+        ::close(consumer->fd);
+        get_operational_logger()->info("Event stream consumer disconnected; {} frames dropped for it.",
+                                       consumer->frames_dropped);
+    }
+
+    void EventStream::run()
+    {
+        std::vector<pollfd> fds;
+        std::vector<std::shared_ptr<Consumer>> polled;
+        while (!stopping_.load(std::memory_order_relaxed))
+        {
+            fds.assign({{wake_fds_[0], POLLIN, 0}, {listen_fd_, POLLIN, 0}});
+            {
+                std::shared_lock lock(consumers_mutex_);
+                polled = consumers_;
+            }
+            for (const auto& consumer : polled)
+            {
+                short events = POLLIN;
+                {
+                    std::scoped_lock consumer_lock(consumer->mutex);
+                    if (consumer->size > 0)
+                    {
+                        events |= POLLOUT;
+                    }
+                }
+                fds.push_back({consumer->fd, events, 0});
+            }
+
+            if (::poll(fds.data(), fds.size(), -1) < 0)
+            {
+                continue;
+            }
+
+            if (fds[0].revents & POLLIN)
+            {
+                char discard[256];
+                while (::read(wake_fds_[0], discard, sizeof(discard)) > 0)
+                {
+                }
+            }
+            if (fds[1].revents & POLLIN)
+            {
+                accept_consumers();
+            }
+
+            for (size_t i = 0; i < polled.size(); ++i)
+            {
+                const short revents = fds[i + 2].revents;
+                bool alive = (revents & (POLLERR | POLLNVAL)) == 0;
+                if (alive && (revents & (POLLIN | POLLHUP)))
+                {
+                    // Consumers do not talk back; reading only notices a closed peer.
+                    char discard[256];
+                    const ssize_t received = ::recv(polled[i]->fd, discard, sizeof(discard), MSG_DONTWAIT);
+                    alive = received > 0 || (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK));
+                }
+                if (alive)
+                {
+                    alive = drain(*polled[i]);
+                }
+                if (!alive)
+                {
+                    close_consumer(polled[i]);
+                }
+            }
+        }
+    }
+#else
+    EventStream::EventStream(std::string socket_path, const size_t buffer_bytes)
+        : socket_path_(std::move(socket_path)),
+          buffer_bytes_(buffer_bytes)
+    {
+        throw std::runtime_error("the request event stream needs Unix domain sockets");
+    }
+
+    EventStream::~EventStream() = default;
+
+    void EventStream::publish(std::string_view)
+    {
+    }
+
+    size_t EventStream::consumer_count() const
+    {
+        return 0;
+    }
+#endif
+} // namespace honeypot::utils
@@ -1,16 +1,104 @@
 #include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <filesystem>
+#include <iterator>
 
+#include <fmt/core.h>
+#include <fmt/chrono.h>
 #include <nlohmann/json.hpp>
 
 #include "utils/fake_data.hpp"
 #include "utils/config.hpp"
+#include "utils/hash.hpp"
+#include "utils/logging.hpp"
+#include "utils/request_arena.hpp"
 
 
 namespace honeypot::utils::fake_data
 {
-	nlohmann::ordered_json generate_error(std::string_view message)
+	namespace
 	{
-		return{{"error", message}};
+		std::atomic<std::shared_ptr<const NgramModel>> text_model;
+
+		bool ends_sentence(const std::string_view piece)
+		{
+			return piece.ends_with('.') || piece.ends_with('!') || piece.ends_with('?');
+		}
+
+		uint64_t splitmix64(uint64_t& state)
+		{
+			state += 0x9E3779B97F4A7C15ULL;
+			uint64_t z = state;
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+			return z ^ (z >> 31);
+		}
+
+		/**
+		 * Seconds since the epoch for an RFC 3339 timestamp such as "2025-04-13T11:38:51.9004452-07:00",
+		 * or 0 if it does not parse.
+		 */
+		int64_t parse_rfc3339_seconds(const std::string_view timestamp)
+		{
+			int year = 0;
+			unsigned month = 0, day = 0, hour = 0, minute = 0, second = 0;
+			int consumed = 0;
+			const std::string text(timestamp);
+			if (std::sscanf(text.c_str(), "%4d-%2u-%2uT%2u:%2u:%2u%n", &year, &month, &day, &hour, &minute, &second,
+			                &consumed) != 6)
+			{
+				return 0;
+			}
+			std::string_view rest = timestamp.substr(static_cast<size_t>(consumed));
+			if (rest.starts_with('.'))
+			{
+				rest.remove_prefix(std::min(rest.find_first_not_of("0123456789", 1), rest.size()));
+			}
+
+			int64_t offset_seconds = 0;
+			if (rest.size() >= 6 && (rest[0] == '+' || rest[0] == '-'))
+			{
+				offset_seconds = ((rest[1] - '0') * 10 + (rest[2] - '0')) * 3600 + ((rest[4] - '0') * 10 + (rest[5] - '0')) * 60;
+				if (rest[0] == '-')
+				{
+					offset_seconds = -offset_seconds;
+				}
+			}
+
+			const std::chrono::year_month_day date{std::chrono::year(year), std::chrono::month(month), std::chrono::day(day)};
+			if (!date.ok())
+			{
+				return 0;
+			}
+			const int64_t days = std::chrono::sys_days(date).time_since_epoch().count();
+			return days * 86400 + hour * 3600 + minute * 60 + second - offset_seconds;
+		}
+
+		// Ollama reports the name's namespace as owner: "library" unless the model was pulled as "owner/name".
+		std::string_view model_owner(const std::string_view model_name)
+		{
+			const std::string_view name = model_name.substr(0, model_name.find(':'));
+			const size_t last_slash = name.rfind('/');
+			if (last_slash == std::string_view::npos)
+			{
+				return "library";
+			}
+			const size_t owner_start = name.rfind('/', last_slash - 1);
+			return owner_start == std::string_view::npos || last_slash == 0
+				? name.substr(0, last_slash)
+				: name.substr(owner_start + 1, last_slash - owner_start - 1);
+		}
+	}
+
+	std::string generate_error_body(const std::string_view message)
+	{
+		ArenaScope arena;
+		return std::string(ArenaJson{{"error", message}}.dump());
 	}
 
 	nlohmann::ordered_json generate_ok_status()
@@ -45,4 +133,224 @@ namespace honeypot::utils::fake_data
 		root["models"] = std::move(models_array);
 		return root;
 	}
+
+	std::string generate_openai_model_list(const std::vector<config::TagModelInfo>& tag_models)
+	{
+		std::string out = R"({"object":"list","data":[)";
+		for (size_t i = 0; i < tag_models.size(); ++i)
+		{
+			const auto& model = tag_models[i];
+			out.append(i == 0 ? R"({"id":")" : R"(,{"id":")");
+			append_json_escaped(out, model.name);
+			fmt::format_to(std::back_inserter(out), R"(","object":"model","created":{},"owned_by":")",
+			               parse_rfc3339_seconds(model.modified_at));
+			append_json_escaped(out, model_owner(model.name));
+			out.append("\"}");
+		}
+		out.append("]}");
+		return out;
+	}
+
+	void generate_embedding(std::string& out, const std::string_view input, const size_t dimensions)
+	{
+		// splitmix64 over the input's hash gives a reproducible pseudo-random direction.
+		uint64_t state = std::hash<std::string_view>{}(input);
+		std::vector<float> values(dimensions);
+		double norm = 0.0;
+		for (auto& value : values)
+		{
+			const uint64_t z = splitmix64(state);
+			value = static_cast<float>(static_cast<double>(z >> 11) / 9007199254740992.0 * 2.0 - 1.0);
+			norm += static_cast<double>(value) * value;
+		}
+		const double scale = norm > 0.0 ? 1.0 / std::sqrt(norm) : 0.0;
+
+		out.push_back('[');
+		for (size_t i = 0; i < values.size(); ++i)
+		{
+			fmt::format_to(std::back_inserter(out), "{}{}", i == 0 ? "" : ",",
+			               static_cast<float>(values[i] * scale));
+		}
+		out.push_back(']');
+	}
+
+	std::string generate_digest(const std::string_view content)
+	{
+		uint64_t state = fnv1a_64(content);
+		std::string digest;
+		digest.reserve(64);
+		for (int i = 0; i < 4; ++i)
+		{
+			fmt::format_to(std::back_inserter(digest), "{:016x}", splitmix64(state));
+		}
+		return digest;
+	}
+
+	void append_json_escaped(std::string& out, const std::string_view text)
+	{
+		constexpr char hex_digits[] = "0123456789abcdef";
+
+		size_t run_start = 0;
+		for (size_t i = 0; i < text.size(); ++i)
+		{
+			const auto c = static_cast<unsigned char>(text[i]);
+			if (c >= 0x20 && c != '"' && c != '\\')
+			{
+				continue;
+			}
+
+			out.append(text.data() + run_start, i - run_start);
+			run_start = i + 1;
+			switch (c)
+			{
+				case '"': out.append("\\\""); break;
+				case '\\': out.append("\\\\"); break;
+				case '\n': out.append("\\n"); break;
+				case '\r': out.append("\\r"); break;
+				case '\t': out.append("\\t"); break;
+				default:
+					out.append("\\u00");
+					out.push_back(hex_digits[c >> 4]);
+					out.push_back(hex_digits[c & 0x0F]);
+			}
+		}
+		out.append(text.data() + run_start, text.size() - run_start);
+	}
+
+	std::string generate_timestamp_iso8601()
+	{
+		const auto now = std::chrono::system_clock::now();
+		const auto seconds = std::chrono::floor<std::chrono::seconds>(now);
+		const auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(now - seconds).count();
+		return fmt::format("{:%Y-%m-%dT%H:%M:%S}.{:09d}Z",
+		                   fmt::gmtime(std::chrono::system_clock::to_time_t(seconds)), nanos);
+	}
+
+	void generate_completion_chunk(std::string& out, const std::string_view model, const std::string_view created_at,
+	                               const std::string_view response_piece)
+	{
+		out.append(R"({"model":")");
+		append_json_escaped(out, model);
+		out.append(R"(","created_at":")");
+		out.append(created_at);
+		out.append(R"(","response":")");
+		append_json_escaped(out, response_piece);
+		out.append("\",\"done\":false}\n");
+	}
+
+	void generate_chat_chunk(std::string& out, const std::string_view model, const std::string_view created_at,
+	                         const std::string_view content_piece)
+	{
+		out.append(R"({"model":")");
+		append_json_escaped(out, model);
+		out.append(R"(","created_at":")");
+		out.append(created_at);
+		out.append(R"(","message":{"role":"assistant","content":")");
+		append_json_escaped(out, content_piece);
+		out.append("\"},\"done\":false}\n");
+	}
+
+	void generate_create_status_chunk(std::string& out, const std::string_view status)
+	{
+		out.append(R"({"status":")");
+		append_json_escaped(out, status);
+		out.append("\"}\n");
+	}
+
+	void generate_final_stats(std::string& out, const GenerationStats& stats)
+	{
+		fmt::format_to(std::back_inserter(out),
+		               R"(,"total_duration":{},"load_duration":{},"prompt_eval_count":{},"prompt_eval_duration":{},)"
+		               R"("eval_count":{},"eval_duration":{})",
+		               stats.total_duration, stats.load_duration, stats.prompt_eval_count,
+		               stats.prompt_eval_duration, stats.eval_count, stats.eval_duration);
+	}
+
+	void init_text_model(const config::HoneypotConfig& config)
+	{
+		const auto logger = get_operational_logger();
+		const std::string& model_path = config.api_behavior.text_model_path;
+		if (model_path.empty())
+		{
+			logger->info("No 'text_model_path' configured, generated text comes from response templates only.");
+			return;
+		}
+
+		const auto full_path = std::filesystem::path("config") / model_path;
+		try
+		{
+			auto model = NgramModel::open(full_path.string());
+			logger->info("Mapped n-gram text model '{}' ({} tokens, {} contexts, {} bytes).", full_path.string(),
+			             model->token_count(), model->context_count(), model->mapped_bytes());
+			text_model.store(std::move(model));
+		}
+		catch (const std::exception& e)
+		{
+			logger->error("Failed to map n-gram text model '{}': {}", full_path.string(), e.what());
+		}
+	}
+
+	std::shared_ptr<const NgramModel> get_text_model()
+	{
+		return text_model.load();
+	}
+
+	TextPieceSource::TextPieceSource(const TemplateKind kind, const std::string_view model,
+	                                 const std::string_view prompt, const uint64_t seed,
+	                                 const uint32_t target_pieces, const uint32_t max_pieces)
+		: ngram_(text_model.load()),
+		  target_pieces_(std::min(target_pieces, max_pieces)),
+		  max_pieces_(max_pieces)
+	{
+		if (ngram_)
+		{
+			stream_ = ngram_->start(seed);
+		}
+		else
+		{
+			text_ = generate_response_text(kind, model, prompt);
+		}
+	}
+
+	std::string_view TextPieceSource::next()
+	{
+		if (finished_ || emitted_ >= max_pieces_)
+		{
+			return {};
+		}
+
+		std::string_view piece;
+		if (ngram_)
+		{
+			piece = ngram_->next(stream_);
+		}
+		else
+		{
+			// Same shape as n-gram tokens: leading whitespace plus one word or punctuation run.
+			const size_t begin = text_pos_;
+			while (text_pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[text_pos_])))
+			{
+				++text_pos_;
+			}
+			while (text_pos_ < text_.size() && !std::isspace(static_cast<unsigned char>(text_[text_pos_])))
+			{
+				++text_pos_;
+			}
+			piece = std::string_view(text_).substr(begin, text_pos_ - begin);
+			finished_ = text_pos_ >= text_.size();
+		}
+
+		if (piece.empty())
+		{
+			finished_ = true;
+			return {};
+		}
+
+		++emitted_;
+		if (ngram_ && emitted_ >= target_pieces_ && ends_sentence(piece))
+		{
+			finished_ = true;
+		}
+		return piece;
+	}
 } // namespace honeypot::utils::fake_data
@@ -0,0 +1,700 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <ctime>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fmt/chrono.h>
+#include <fmt/core.h>
+#include <nlohmann/json.hpp>
+
+#include "state/honeypot_state.hpp"
+#include "utils/etag.hpp"
+#include "utils/fast_path.hpp"
+#include "utils/logging.hpp"
+#include "utils/tarpit.hpp"
+#include "utils/trace.hpp"
+
+namespace honeypot::utils
+{
+    namespace
+    {
+        using asio::ip::tcp;
+
+        std::atomic<const FastPathListener*> front_listener{nullptr}; // set while forwarding to Crow
+
+        // A head this large is not a client we want to serve quickly; the connection is dropped.
+        constexpr size_t max_head_bytes = 64 * 1024;
+        constexpr size_t read_chunk_bytes = 16 * 1024;
+        constexpr size_t max_chunk_line_bytes = 4096; // chunk-size line or trailer field in a chunked body
+        constexpr std::string_view end_of_head = "\r\n\r\n";
+
+        struct RequestHead
+        {
+            std::string_view method;
+            std::string_view target;
+            std::string_view version;
+            std::vector<std::pair<std::string_view, std::string_view>> headers;
+            size_t content_length = 0;
+            bool chunked = false;
+            bool close = false;
+
+            std::string_view path() const { return target.substr(0, target.find('?')); }
+
+            std::string_view header(const std::string_view name) const;
+        };
+
+        bool iequals(const std::string_view a, const std::string_view b)
+        {
+            return std::ranges::equal(a, b, [](const char x, const char y) {
+                return (x | 0x20) == (y | 0x20);
+            });
+        }
+
+        std::string_view trim(std::string_view s)
+        {
+            while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+            {
+                s.remove_prefix(1);
+            }
+            while (!s.empty() && (s.back() == ' ' || s.back() == '\t'))
+            {
+                s.remove_suffix(1);
+            }
+            return s;
+        }
+
+        std::string_view RequestHead::header(const std::string_view name) const
+        {
+            const auto it = std::ranges::find_if(headers, [&](const auto& h) { return iequals(h.first, name); });
+            return it != headers.end() ? it->second : std::string_view{};
+        }
+
+        /**
+         * Parses a request line and header fields; @p head ends with the last field's CRLF.
+         * Only what routing and framing need is interpreted, anything unusual is left to Crow.
+         */
+        std::optional<RequestHead> parse_head(const std::string_view head)
+        {
+            RequestHead parsed;
+            const size_t line_end = head.find("\r\n");
+            const std::string_view request_line = head.substr(0, line_end);
+            const size_t first_space = request_line.find(' ');
+            const size_t last_space = request_line.rfind(' ');
+            if (first_space == std::string_view::npos || last_space == first_space)
+            {
+                return std::nullopt;
+            }
+            parsed.method = request_line.substr(0, first_space);
+            parsed.target = request_line.substr(first_space + 1, last_space - first_space - 1);
+            parsed.version = request_line.substr(last_space + 1);
+            if (!parsed.version.starts_with("HTTP/1."))
+            {
+                return std::nullopt;
+            }
+
+            for (size_t pos = line_end + 2; pos < head.size();)
+            {
+                const size_t end = head.find("\r\n", pos);
+                const std::string_view line = head.substr(pos, end - pos);
+                pos = end + 2;
+
+                const size_t colon = line.find(':');
+                if (colon == std::string_view::npos || colon == 0)
+                {
+                    return std::nullopt;
+                }
+                const std::string_view name = line.substr(0, colon);
+                const std::string_view value = trim(line.substr(colon + 1));
+                if (iequals(name, "Content-Length"))
+                {
+                    const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(),
+                                                           parsed.content_length);
+                    if (ec != std::errc{} || ptr != value.data() + value.size())
+                    {
+                        return std::nullopt;
+                    }
+                }
+                else if (iequals(name, "Transfer-Encoding"))
+                {
+                    // Bodies are relayed chunk by chunk; any other coding could frame them differently than Crow.
+                    if (!iequals(value, "chunked"))
+                    {
+                        return std::nullopt;
+                    }
+                    parsed.chunked = true;
+                }
+                else if (iequals(name, "Connection") && iequals(value, "close"))
+                {
+                    parsed.close = true;
+                }
+                parsed.headers.emplace_back(name, value);
+            }
+            return parsed;
+        }
+
+        bool is_internal_header(const std::string_view name)
+        {
+            return iequals(name, FastPathListener::peer_header) || iequals(name, FastPathListener::fingerprint_header)
+                || iequals(name, FastPathListener::listener_header) || iequals(name, FastPathListener::secret_header);
+        }
+
+        ClientFingerprint fingerprint_head(const RequestHead& head)
+        {
+            ClientFingerprint::Builder builder;
+            for (const auto& [name, value] : head.headers)
+            {
+                if (!is_internal_header(name))
+                {
+                    builder.add_header(name, value);
+                }
+            }
+            return builder.finish(head.method, head.version, true);
+        }
+
+        bool is_loopback(const std::string_view address)
+        {
+            return address == "127.0.0.1" || address == "::1" || address == "::ffff:127.0.0.1";
+        }
+
+        bool secrets_equal(const std::string_view a, const std::string_view b)
+        {
+            if (a.size() != b.size())
+            {
+                return false;
+            }
+            unsigned char difference = 0;
+            for (size_t i = 0; i < a.size(); ++i)
+            {
+                difference |= static_cast<unsigned char>(a[i] ^ b[i]);
+            }
+            return difference == 0;
+        }
+
+        /**
+         * Removes every @p name field from @p headers; its value if there was exactly one.
+         */
+        std::optional<std::string> take_header(crow::ci_map& headers, const std::string_view name)
+        {
+            const auto [first, last] = headers.equal_range(std::string(name));
+            std::optional<std::string> value;
+            if (first != last && std::next(first) == last)
+            {
+                value = std::move(first->second);
+            }
+            headers.erase(first, last);
+            return value;
+        }
+
+        // "Date: <IMF-fixdate>\r\n", reformatted at most once a second per thread. Copy it before any
+        // co_await: other connections on the thread rewrite it.
+        std::string_view date_line()
+        {
+            thread_local std::time_t formatted_for = 0;
+            thread_local std::string line;
+            const std::time_t now = std::time(nullptr);
+            if (now != formatted_for)
+            {
+                line = fmt::format("Date: {:%a, %d %b %Y %H:%M:%S} GMT\r\n", fmt::gmtime(now));
+                formatted_for = now;
+            }
+            return line;
+        }
+
+        /**
+         * Header block for a /api/tags body, kept per thread for the last body served: sources without
+         * catalog changes all share the base body, so this is rebuilt about once per catalog change.
+         * Like date_line(), only valid until the next request on the thread.
+         */
+        std::string_view tags_head(const std::shared_ptr<const state::CachedBody>& body)
+        {
+            thread_local std::shared_ptr<const state::CachedBody> cached_for;
+            thread_local std::string head;
+            if (cached_for != body)
+            {
+                head = fmt::format("HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nETag: {}\r\n"
+                                   "Content-Length: {}\r\n", body->etag, body->body.size());
+                cached_for = body;
+            }
+            return head;
+        }
+
+        class Connection : public std::enable_shared_from_this<Connection>
+        {
+        public:
+            Connection(FastPathListener& listener, const FastPathListener::Endpoint& endpoint, tcp::socket client)
+                : listener_(listener),
+                  endpoint_(endpoint),
+                  client_(std::move(client)),
+                  upstream_(client_.get_executor())
+            {
+            }
+
+            static asio::awaitable<void> run(const std::shared_ptr<Connection> self)
+            {
+                try
+                {
+                    self->peer_ = self->client_.remote_endpoint().address().to_string();
+                    while (co_await self->serve_one())
+                    {
+                    }
+                    if (self->client_eof_ && self->upstream_.is_open())
+                    {
+                        // Let Crow finish answering; the relay closes the client once it has.
+                        self->upstream_.shutdown(tcp::socket::shutdown_send);
+                        co_return;
+                    }
+                }
+                catch (const std::exception& e)
+                {
+                    get_operational_logger()->debug("Fast path connection from {} ended: {}", self->peer_, e.what());
+                }
+                self->close();
+            }
+
+        private:
+            /**
+             * Handles the next request on the connection; false once it should be closed.
+             */
+            asio::awaitable<bool> serve_one()
+            {
+                size_t head_end;
+                while ((head_end = buffer_.find(end_of_head)) == std::string::npos)
+                {
+                    if (buffer_.size() > max_head_bytes || !co_await read_more())
+                    {
+                        co_return false;
+                    }
+                }
+
+                const auto head = parse_head(std::string_view(buffer_).substr(0, head_end + 2));
+                if (!head)
+                {
+                    co_return false;
+                }
+                const size_t head_bytes = head_end + end_of_head.size();
+
+                if (listener_.answers_hot_routes() && !upstream_.is_open() && is_hot(*head)
+                    && !get_tarpit().is_flagged(peer_))
+                {
+                    co_await answer(*head);
+                    buffer_.erase(0, head_bytes);
+                    co_return !head->close;
+                }
+
+                co_await forward(*head, head_bytes);
+                co_return true;
+            }
+
+            static bool is_hot(const RequestHead& head)
+            {
+                const std::string_view path = head.path();
+                return head.method == "GET" && head.version == "HTTP/1.1" && head.content_length == 0
+                    && !head.chunked && (path == "/api/version" || path == "/api/tags");
+            }
+
+            asio::awaitable<bool> read_more()
+            {
+                const size_t old_size = buffer_.size();
+                buffer_.resize(old_size + read_chunk_bytes);
+                asio::error_code ec;
+                const size_t received = co_await client_.async_read_some(
+                    asio::buffer(buffer_.data() + old_size, read_chunk_bytes),
+                    asio::redirect_error(asio::use_awaitable, ec));
+                buffer_.resize(old_size + received);
+                client_eof_ = ec == asio::error::eof;
+                co_return !ec;
+            }
+
+            asio::awaitable<void> answer(const RequestHead& head)
+            {
+                auto& tracer = get_tracer();
+                const auto trace = tracer.begin_request();
+                get_tarpit().observe(peer_);
+
+                // The header block is copied into response_head_, which this connection owns: the
+                // per-thread date and tags head buffers change under a write suspended on a slow client.
+                // The body is either the endpoint's or held by tags_body until the write is done.
+                int status = crow::status::OK;
+                std::string_view body;
+                std::shared_ptr<const state::CachedBody> tags_body;
+                if (head.path() == "/api/version")
+                {
+                    response_head_.assign(endpoint_.version_head);
+                    body = endpoint_.version_body;
+                }
+                else
+                {
+                    tags_body = listener_.state()->get_tags_body(peer_);
+                    if (if_none_match_hits(head.header("If-None-Match"), tags_body->etag))
+                    {
+                        status = crow::status::NOT_MODIFIED;
+                        response_head_.assign("HTTP/1.1 304 Not Modified\r\nETag: ").append(tags_body->etag)
+                            .append("\r\n");
+                    }
+                    else
+                    {
+                        response_head_.assign(tags_head(tags_body));
+                        body = tags_body->body;
+                    }
+                }
+                response_head_.append(date_line()).append("\r\n");
+                const std::array<asio::const_buffer, 2> response{asio::buffer(response_head_), asio::buffer(body)};
+                // The write may resume on another listener thread, which then carries the trace mark.
+                Tracer::resume_request({});
+                co_await asio::async_write(client_, response, asio::use_awaitable);
+
+                Tracer::resume_request(trace);
+                log_answer(head, status);
+                tracer.end_request(trace, "request (fast path)");
+            }
+
+            // Logs through the same path as Crow-served requests, so records are indistinguishable.
+            void log_answer(const RequestHead& head, const int status) const
+            {
+                crow::request req;
+                req.method = crow::HTTPMethod::Get;
+                req.raw_url = std::string(head.target);
+                req.url = std::string(head.path());
+                req.remote_ip_address = peer_;
+                for (const auto& [name, value] : head.headers)
+                {
+                    req.headers.emplace(std::string(name), std::string(value));
+                }
+                log_request(req, crow::response(status),
+                            {.client_fingerprint = fingerprint_head(head).view(), .listener = endpoint_.identity.name});
+            }
+
+            /**
+             * Sends the request to Crow with the client address attached; the first forwarded request
+             * opens the backend connection and starts relaying its responses.
+             */
+            asio::awaitable<void> forward(const RequestHead& head, const size_t head_bytes)
+            {
+                if (!upstream_.is_open())
+                {
+                    const auto& backend = listener_.config().fast_path;
+                    co_await upstream_.async_connect(
+                        tcp::endpoint(asio::ip::make_address("127.0.0.1"), backend.backend_port), asio::use_awaitable);
+                    asio::co_spawn(client_.get_executor(), relay(shared_from_this()), asio::detached);
+                }
+
+                const ClientFingerprint fingerprint = fingerprint_head(head);
+                std::string forwarded_head;
+                forwarded_head.reserve(head_bytes + peer_.size() + ClientFingerprint::max_length + 160);
+                forwarded_head.append(head.method).append(" ").append(head.target).append(" ").append(head.version)
+                    .append("\r\n");
+                for (const auto& [name, value] : head.headers)
+                {
+                    if (!is_internal_header(name))
+                    {
+                        forwarded_head.append(name).append(": ").append(value).append("\r\n");
+                    }
+                }
+                forwarded_head.append(FastPathListener::fingerprint_header).append(": ").append(fingerprint.view())
+                    .append("\r\n");
+                forwarded_head.append(FastPathListener::listener_header).append(": ").append(endpoint_.index)
+                    .append("\r\n");
+                forwarded_head.append(FastPathListener::secret_header).append(": ").append(listener_.forward_secret())
+                    .append("\r\n");
+                forwarded_head.append(FastPathListener::peer_header).append(": ").append(peer_).append("\r\n\r\n");
+                buffer_.erase(0, head_bytes);
+                co_await asio::async_write(upstream_, asio::buffer(forwarded_head), asio::use_awaitable);
+
+                const bool body_relayed = head.chunked
+                                              ? co_await relay_chunked_body()
+                                              : co_await relay_body(head.content_length);
+                if (!body_relayed)
+                {
+                    close();
+                }
+            }
+
+            /**
+             * Relays the next @p size body bytes, reading as needed; false if the client went away first.
+             */
+            asio::awaitable<bool> relay_body(size_t size)
+            {
+                while (size > 0)
+                {
+                    if (buffer_.empty() && !co_await read_more())
+                    {
+                        co_return false;
+                    }
+                    const size_t take = std::min(size, buffer_.size());
+                    co_await asio::async_write(upstream_, asio::buffer(buffer_.data(), take), asio::use_awaitable);
+                    buffer_.erase(0, take);
+                    size -= take;
+                }
+                co_return true;
+            }
+
+            /**
+             * Waits until the buffer starts with a CRLF-terminated line; its length without the CRLF.
+             */
+            asio::awaitable<std::optional<size_t>> buffered_line()
+            {
+                size_t end;
+                while ((end = buffer_.find("\r\n")) == std::string::npos)
+                {
+                    if (buffer_.size() > max_chunk_line_bytes || !co_await read_more())
+                    {
+                        co_return std::nullopt;
+                    }
+                }
+                co_return end <= max_chunk_line_bytes ? std::optional<size_t>(end) : std::nullopt;
+            }
+
+            /**
+             * Relays a chunked body chunk by chunk, so the request after it is parsed and stripped of
+             * internal headers like any other. Chunk-size lines are re-emitted without extensions and
+             * trailer fields are dropped (Crow would merge them into the headers), so Crow frames the
+             * body exactly as it was read here. False if the body is malformed or the client went away.
+             */
+            asio::awaitable<bool> relay_chunked_body()
+            {
+                while (true)
+                {
+                    const auto line = co_await buffered_line();
+                    if (!line)
+                    {
+                        co_return false;
+                    }
+                    const std::string_view size_line = std::string_view(buffer_).substr(0, *line);
+                    const std::string_view digits = trim(size_line.substr(0, size_line.find(';')));
+                    size_t size = 0;
+                    const auto [ptr, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), size, 16);
+                    if (digits.empty() || ec != std::errc{} || ptr != digits.data() + digits.size())
+                    {
+                        co_return false;
+                    }
+                    buffer_.erase(0, *line + 2);
+
+                    if (size == 0)
+                    {
+                        for (std::optional<size_t> trailer; (trailer = co_await buffered_line()) != 0;)
+                        {
+                            if (!trailer)
+                            {
+                                co_return false;
+                            }
+                            buffer_.erase(0, *trailer + 2);
+                        }
+                        buffer_.erase(0, 2);
+                        co_await asio::async_write(upstream_, asio::buffer(std::string_view("0\r\n\r\n")),
+                                                   asio::use_awaitable);
+                        co_return true;
+                    }
+
+                    const std::string chunk_size = fmt::format("{:x}\r\n", size);
+                    co_await asio::async_write(upstream_, asio::buffer(chunk_size), asio::use_awaitable);
+                    if (!co_await relay_body(size))
+                    {
+                        co_return false;
+                    }
+                    const auto chunk_end = co_await buffered_line();
+                    if (chunk_end != 0)
+                    {
+                        co_return false;
+                    }
+                    buffer_.erase(0, 2);
+                    co_await asio::async_write(upstream_, asio::buffer(std::string_view("\r\n")), asio::use_awaitable);
+                }
+            }
+
+            static asio::awaitable<void> relay(const std::shared_ptr<Connection> self)
+            {
+                std::array<char, read_chunk_bytes> chunk;
+                asio::error_code ec;
+                while (!ec)
+                {
+                    const size_t received = co_await self->upstream_.async_read_some(
+                        asio::buffer(chunk), asio::redirect_error(asio::use_awaitable, ec));
+                    if (!ec)
+                    {
+                        co_await asio::async_write(self->client_, asio::buffer(chunk.data(), received),
+                                                   asio::redirect_error(asio::use_awaitable, ec));
+                    }
+                }
+                self->close();
+            }
+
+            void close()
+            {
+                asio::error_code ignored;
+                client_.shutdown(tcp::socket::shutdown_both, ignored);
+                client_.close(ignored);
+                upstream_.close(ignored);
+            }
+
+            FastPathListener& listener_;
+            const FastPathListener::Endpoint& endpoint_;
+            tcp::socket client_;
+            tcp::socket upstream_;
+            std::string peer_;
+            std::string buffer_;
+            std::string response_head_; // status line and headers of the answer being written
+            bool client_eof_ = false;
+        };
+    }
+
+    FastPathListener::Endpoint::Endpoint(asio::io_context& io_context, const config::ListenerConfig& listener,
+                                         ListenerIdentity identity)
+        : address(asio::ip::make_address(listener.address), listener.port),
+          identity(std::move(identity)),
+          version_body(nlohmann::json{{"version", this->identity.ollama_version}}.dump()),
+          acceptor(io_context)
+    {
+        version_head = fmt::format("HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: {}\r\n",
+                                   version_body.size());
+    }
+
+    FastPathListener::FastPathListener(const config::HoneypotConfig& config,
+                                       std::shared_ptr<state::HoneypotState> state)
+        : config_(config),
+          state_(std::move(state))
+    {
+        std::random_device random;
+        forward_secret_ = fmt::format("{:08x}{:08x}{:08x}{:08x}", random(), random(), random(), random());
+
+        std::vector<config::ListenerConfig> listeners = config.server.listeners;
+        if (listeners.empty())
+        {
+            listeners.push_back({.address = config.server.listen_address, .port = config.server.listen_port});
+        }
+        for (const auto& listener : listeners)
+        {
+            ListenerIdentity identity{
+                .name = listener.name.empty() ? fmt::format("{}:{}", listener.address, listener.port) : listener.name,
+                .ollama_version = listener.ollama_version.empty()
+                                      ? config.api_behavior.ollama_version
+                                      : listener.ollama_version,
+            };
+            auto& endpoint = endpoints_.emplace_back(
+                std::make_unique<Endpoint>(io_context_, listener, std::move(identity)));
+            endpoint->index = std::to_string(endpoints_.size() - 1);
+        }
+    }
+
+    FastPathListener::~FastPathListener()
+    {
+        front_listener.store(nullptr, std::memory_order_relaxed);
+        io_context_.stop();
+        for (auto& thread : threads_)
+        {
+            thread.join();
+        }
+    }
+
+    bool FastPathListener::required(const config::HoneypotConfig& config)
+    {
+        return config.fast_path.enabled || !config.server.listeners.empty();
+    }
+
+    const ListenerIdentity* FastPathListener::identity(const size_t index) const
+    {
+        return index < endpoints_.size() ? &endpoints_[index]->identity : nullptr;
+    }
+
+    void FastPathListener::start()
+    {
+        for (const auto& endpoint : endpoints_)
+        {
+            endpoint->acceptor.open(endpoint->address.protocol());
+            endpoint->acceptor.set_option(tcp::acceptor::reuse_address(true));
+            endpoint->acceptor.bind(endpoint->address);
+            endpoint->acceptor.listen();
+        }
+
+        front_listener.store(this, std::memory_order_relaxed);
+        for (const auto& endpoint : endpoints_)
+        {
+            asio::co_spawn(io_context_, accept_loop(*endpoint), asio::detached);
+        }
+        const uint32_t thread_count = std::max<uint32_t>(config_.fast_path.threads, 1);
+        for (uint32_t i = 0; i < thread_count; ++i)
+        {
+            threads_.emplace_back([this] { io_context_.run(); });
+        }
+
+        for (const auto& endpoint : endpoints_)
+        {
+            get_operational_logger()->info("Front listener '{}' on {}:{}{}, forwarding to 127.0.0.1:{}.",
+                                           endpoint->identity.name, endpoint->address.address().to_string(),
+                                           endpoint->address.port(),
+                                           answers_hot_routes() ? " (fast path)" : "", config_.fast_path.backend_port);
+        }
+        get_operational_logger()->info("Front listener runs {} threads for {} endpoints.", thread_count,
+                                       endpoints_.size());
+    }
+
+    asio::awaitable<void> FastPathListener::accept_loop(Endpoint& endpoint)
+    {
+        while (true)
+        {
+            asio::error_code ec;
+            tcp::socket socket = co_await endpoint.acceptor.async_accept(
+                asio::make_strand(io_context_), asio::redirect_error(asio::use_awaitable, ec));
+            if (ec)
+            {
+                if (ec == asio::error::operation_aborted)
+                {
+                    co_return;
+                }
+                get_operational_logger()->warn("Front listener '{}' accept failed: {}", endpoint.identity.name,
+                                               ec.message());
+                continue;
+            }
+            socket.set_option(tcp::no_delay(true));
+            const auto executor = socket.get_executor();
+            asio::co_spawn(executor,
+                           Connection::run(std::make_shared<Connection>(*this, endpoint, std::move(socket))),
+                           asio::detached);
+        }
+    }
+
+    ForwardedRequest adopt_forwarded_peer(crow::request& req)
+    {
+        ForwardedRequest forwarded;
+        const FastPathListener* listener = front_listener.load(std::memory_order_relaxed);
+        if (listener == nullptr)
+        {
+            return forwarded;
+        }
+        // Removed whoever set them, so copies that reached Crow some other way never end up in records.
+        const auto secret = take_header(req.headers, FastPathListener::secret_header);
+        const auto peer = take_header(req.headers, FastPathListener::peer_header);
+        const auto fingerprint = take_header(req.headers, FastPathListener::fingerprint_header);
+        const auto index = take_header(req.headers, FastPathListener::listener_header);
+        if (!secret || !peer || !is_loopback(req.remote_ip_address)
+            || !secrets_equal(*secret, listener->forward_secret()))
+        {
+            return forwarded;
+        }
+
+        req.remote_ip_address = *peer;
+        if (fingerprint)
+        {
+            forwarded.fingerprint = ClientFingerprint::parse(*fingerprint);
+        }
+        size_t position = 0;
+        if (index)
+        {
+            if (const auto [ptr, ec] = std::from_chars(index->data(), index->data() + index->size(), position);
+                ec == std::errc{} && ptr == index->data() + index->size())
+            {
+                forwarded.listener = listener->identity(position);
+            }
+        }
+        return forwarded;
+    }
+} // namespace honeypot::utils
@@ -0,0 +1,270 @@
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <asio.hpp>
+#include <fmt/core.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "utils/ip_index.hpp"
+#include "utils/logging.hpp"
+
+namespace honeypot::utils
+{
+    namespace
+    {
+        std::atomic<std::shared_ptr<const IpIndex>> active_index;
+        std::atomic<uint64_t> index_generation{0};
+        std::filesystem::path index_path;
+
+        // Each thread keeps its own reference to the index and only touches the shared pointer
+        // when the generation moves, so the per-request path is a single atomic load.
+        struct CachedIndex
+        {
+            uint64_t generation = UINT64_MAX;
+            std::shared_ptr<const IpIndex> index;
+        };
+
+        thread_local CachedIndex cached_index;
+
+        bool section_fits(const uint64_t offset, const uint64_t count, const uint64_t element_size,
+                          const uint64_t file_size)
+        {
+            if (offset % 8 != 0 || offset > file_size)
+            {
+                return false;
+            }
+            return count <= (file_size - offset) / element_size;
+        }
+    }
+
+    std::shared_ptr<const IpIndex> IpIndex::open(const std::string& path)
+    {
+        std::shared_ptr<IpIndex> index(new IpIndex());
+
+#ifndef _WIN32
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            throw std::runtime_error(fmt::format("failed to open IP index '{}': {}", path, std::strerror(errno)));
+        }
+        struct stat st{};
+        if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(IpIndexFileHeader)))
+        {
+            ::close(fd);
+            throw std::runtime_error(fmt::format("IP index '{}' is truncated", path));
+        }
+        void* mapping = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED)
+        {
+            throw std::runtime_error(fmt::format("failed to map IP index '{}': {}", path, std::strerror(errno)));
+        }
+        index->data_ = static_cast<const std::byte*>(mapping);
+        index->size_ = static_cast<size_t>(st.st_size);
+        index->owns_mapping_ = true;
+#else
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in.is_open())
+        {
+            throw std::runtime_error(fmt::format("failed to open IP index '{}'", path));
+        }
+        index->size_ = static_cast<size_t>(in.tellg());
+        if (index->size_ < sizeof(IpIndexFileHeader))
+        {
+            throw std::runtime_error(fmt::format("IP index '{}' is truncated", path));
+        }
+        index->heap_copy_ = std::make_unique<std::byte[]>(index->size_);
+        in.seekg(0);
+        in.read(reinterpret_cast<char*>(index->heap_copy_.get()), static_cast<std::streamsize>(index->size_));
+        index->data_ = index->heap_copy_.get();
+#endif
+
+        const auto* header = reinterpret_cast<const IpIndexFileHeader*>(index->data_);
+        const uint64_t file_size = index->size_;
+        if (std::memcmp(header->magic, ip_index_magic, sizeof(ip_index_magic)) != 0
+            || header->version != ip_index_format_version
+            || header->endian_tag != ip_index_endian_tag
+            || header->file_size != file_size)
+        {
+            throw std::runtime_error(fmt::format("'{}' is not a compatible IP index", path));
+        }
+        if (header->node_count == 0 || header->v4_root >= header->node_count || header->v6_root >= header->node_count
+            || !section_fits(header->nodes_offset, header->node_count, sizeof(IpIndexNode), file_size)
+            || !section_fits(header->leaves_offset, header->leaf_count, sizeof(uint32_t), file_size)
+            || !section_fits(header->records_offset, header->record_count, sizeof(IpIndexRecord), file_size)
+            || header->strings_offset > file_size || header->strings_size > file_size - header->strings_offset)
+        {
+            throw std::runtime_error(fmt::format("IP index '{}' has out-of-range sections", path));
+        }
+
+        index->header_ = header;
+        index->nodes_ = reinterpret_cast<const IpIndexNode*>(index->data_ + header->nodes_offset);
+        index->leaves_ = reinterpret_cast<const uint32_t*>(index->data_ + header->leaves_offset);
+        index->records_ = reinterpret_cast<const IpIndexRecord*>(index->data_ + header->records_offset);
+        index->strings_ = reinterpret_cast<const char*>(index->data_ + header->strings_offset);
+
+#if !defined(_WIN32) && defined(MADV_RANDOM)
+        ::madvise(const_cast<std::byte*>(index->data_), index->size_, MADV_RANDOM);
+#endif
+        return index;
+    }
+
+    IpIndex::~IpIndex()
+    {
+#ifndef _WIN32
+        if (owns_mapping_ && data_ != nullptr)
+        {
+            ::munmap(const_cast<std::byte*>(data_), size_);
+        }
+#endif
+    }
+
+    std::optional<IpInfo> IpIndex::walk(uint32_t node, const uint8_t* bytes, const size_t length) const
+    {
+        for (size_t depth = 0; depth < length; ++depth)
+        {
+            // Offsets come from the mapped file; clamp rather than trust them.
+            if (node >= header_->node_count)
+            {
+                return std::nullopt;
+            }
+            const IpIndexNode& current = nodes_[node];
+            const unsigned word = bytes[depth] / 64;
+            const unsigned bit = bytes[depth] % 64;
+            const uint64_t up_to_bit = ~uint64_t{0} >> (63 - bit);
+            if ((current.child_bits[word] >> bit) & 1)
+            {
+                node = current.child_base + current.child_rank[word]
+                       + static_cast<uint32_t>(std::popcount(current.child_bits[word] & (up_to_bit >> 1)));
+                continue;
+            }
+
+            // The run covering this slot is the last one starting at or before it.
+            const uint64_t leaf = uint64_t{current.leaf_base} + current.leaf_rank[word]
+                                  + static_cast<uint32_t>(std::popcount(current.leaf_bits[word] & up_to_bit)) - 1;
+            if (leaf >= header_->leaf_count || leaves_[leaf] == 0 || leaves_[leaf] > header_->record_count)
+            {
+                return std::nullopt;
+            }
+            const IpIndexRecord& record = records_[leaves_[leaf] - 1];
+            IpInfo info;
+            info.asn = record.asn;
+            if (uint64_t{record.organization_offset} + record.organization_length <= header_->strings_size)
+            {
+                info.organization = {strings_ + record.organization_offset, record.organization_length};
+            }
+            if (record.country[0] != '\0')
+            {
+                info.country = {record.country, 2};
+            }
+            return info;
+        }
+        return std::nullopt;
+    }
+
+    std::optional<IpInfo> IpIndex::lookup_v4(const uint32_t address) const
+    {
+        const std::array<uint8_t, 4> bytes{static_cast<uint8_t>(address >> 24), static_cast<uint8_t>(address >> 16),
+                                           static_cast<uint8_t>(address >> 8), static_cast<uint8_t>(address)};
+        return walk(header_->v4_root, bytes.data(), bytes.size());
+    }
+
+    std::optional<IpInfo> IpIndex::lookup_v6(const std::array<uint8_t, 16>& address) const
+    {
+        return walk(header_->v6_root, address.data(), address.size());
+    }
+
+    std::optional<IpInfo> IpIndex::lookup(const std::string_view address) const
+    {
+        std::array<char, 64> text{};
+        if (address.empty() || address.size() >= text.size())
+        {
+            return std::nullopt;
+        }
+        std::memcpy(text.data(), address.data(), address.size());
+
+        asio::error_code ec;
+        const asio::ip::address parsed = asio::ip::make_address(text.data(), ec);
+        if (ec)
+        {
+            return std::nullopt;
+        }
+        if (parsed.is_v4())
+        {
+            return lookup_v4(parsed.to_v4().to_uint());
+        }
+        const asio::ip::address_v6 v6 = parsed.to_v6();
+        if (v6.is_v4_mapped())
+        {
+            return lookup_v4(asio::ip::make_address_v4(asio::ip::v4_mapped, v6).to_uint());
+        }
+        return lookup_v6(v6.to_bytes());
+    }
+
+    void init_ip_index(const config::HoneypotConfig& config)
+    {
+        const auto logger = get_operational_logger();
+        if (config.logging.ip_index_path.empty())
+        {
+            logger->info("No 'ip_index_path' configured, request logs are not enriched with ASN/country.");
+            return;
+        }
+
+        index_path = std::filesystem::path("config") / config.logging.ip_index_path;
+        reload_ip_index();
+    }
+
+    bool reload_ip_index()
+    {
+        const auto logger = get_operational_logger();
+        if (index_path.empty())
+        {
+            logger->info("IP index reload requested but no index is configured.");
+            return false;
+        }
+
+        try
+        {
+            auto index = IpIndex::open(index_path.string());
+            logger->info("Mapped IP index '{}' ({} nodes, {} leaves, {} records, {} bytes).", index_path.string(),
+                         index->node_count(), index->leaf_count(), index->record_count(), index->mapped_bytes());
+            active_index.store(std::move(index));
+            index_generation.fetch_add(1, std::memory_order_release);
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            logger->error("Failed to map IP index '{}': {}", index_path.string(), e.what());
+            return false;
+        }
+    }
+
+    std::optional<IpInfo> lookup_ip(const std::string_view address)
+    {
+        const uint64_t generation = index_generation.load(std::memory_order_acquire);
+        if (cached_index.generation != generation)
+        {
+            cached_index.index = active_index.load();
+            cached_index.generation = generation;
+        }
+        if (!cached_index.index)
+        {
+            return std::nullopt;
+        }
+        return cached_index.index->lookup(address);
+    }
+} // namespace honeypot::utils
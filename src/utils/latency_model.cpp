@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <utility>
+
+#include "utils/latency_model.hpp"
+#include "utils/logging.hpp"
+
+namespace honeypot::utils
+{
+    namespace
+    {
+        std::unique_ptr<const LatencyModel> latency_model;
+
+        // llama.cpp's effective bits per weight, including block scales.
+        constexpr std::array<std::pair<std::string_view, double>, 22> quantization_bits{{
+            {"F32", 32.0}, {"F16", 16.0}, {"BF16", 16.0}, {"Q8_0", 8.5}, {"Q6_K", 6.56},
+            {"Q5_1", 6.0}, {"Q5_K_M", 5.69}, {"Q5_K_S", 5.54}, {"Q5_0", 5.5}, {"Q4_1", 5.0},
+            {"Q4_K_M", 4.85}, {"Q4_K_S", 4.58}, {"Q4_0", 4.55}, {"IQ4_NL", 4.5}, {"IQ4_XS", 4.25},
+            {"Q3_K_L", 4.27}, {"Q3_K_M", 3.91}, {"Q3_K_S", 3.5}, {"IQ3_XXS", 3.06}, {"Q2_K", 2.63},
+            {"IQ2_XS", 2.31}, {"IQ1_S", 1.56},
+        }};
+
+        constexpr double default_parameter_count = 8.0e9;
+        constexpr double default_bits_per_weight = 4.85;
+
+        double jitter_factor(std::mt19937_64& rng, const double jitter)
+        {
+            if (jitter <= 0.0)
+            {
+                return 1.0;
+            }
+            std::uniform_real_distribution<double> spread(1.0 - jitter, 1.0 + jitter);
+            return std::max(spread(rng), 0.05);
+        }
+    }
+
+    double parse_parameter_count(std::string_view parameter_size)
+    {
+        while (!parameter_size.empty() && std::isspace(static_cast<unsigned char>(parameter_size.back())))
+        {
+            parameter_size.remove_suffix(1);
+        }
+        if (parameter_size.empty())
+        {
+            return 0.0;
+        }
+
+        double scale = 1.0;
+        switch (std::toupper(static_cast<unsigned char>(parameter_size.back())))
+        {
+            case 'K': scale = 1e3; break;
+            case 'M': scale = 1e6; break;
+            case 'B': scale = 1e9; break;
+            case 'T': scale = 1e12; break;
+            default: break;
+        }
+        if (scale != 1.0)
+        {
+            parameter_size.remove_suffix(1);
+        }
+
+        double value = 0.0;
+        const auto [ptr, ec] = std::from_chars(parameter_size.data(), parameter_size.data() + parameter_size.size(),
+                                               value);
+        if (ec != std::errc{} || ptr != parameter_size.data() + parameter_size.size() || value <= 0.0)
+        {
+            return 0.0;
+        }
+        return value * scale;
+    }
+
+    double bits_per_weight(const std::string_view quantization_level)
+    {
+        for (const auto& [name, bits] : quantization_bits)
+        {
+            if (std::ranges::equal(name, quantization_level, [](const char a, const char b) {
+                return a == std::toupper(static_cast<unsigned char>(b));
+            }))
+            {
+                return bits;
+            }
+        }
+        return 0.0;
+    }
+
+    ModelTiming LatencyModel::compute_timing(const config::LatencyConfig& config,
+                                             const config::ModelDetails& details, const uint64_t size_bytes)
+    {
+        const double parameters = parse_parameter_count(details.parameter_size);
+        const double bits = bits_per_weight(details.quantization_level);
+
+        double weight_bytes = 0.0;
+        if (parameters > 0.0)
+        {
+            weight_bytes = parameters * (bits > 0.0 ? bits : default_bits_per_weight) / 8.0;
+        }
+        else if (size_bytes > 0)
+        {
+            weight_bytes = static_cast<double>(size_bytes);
+        }
+        else
+        {
+            weight_bytes = default_parameter_count * default_bits_per_weight / 8.0;
+        }
+
+        const double file_bytes = size_bytes > 0 ? static_cast<double>(size_bytes) : weight_bytes;
+
+        ModelTiming timing;
+        timing.eval_ns_per_token = weight_bytes / std::max(config.memory_bandwidth_gbps, 1.0);
+        timing.prompt_ns_per_token = timing.eval_ns_per_token / std::max(config.prompt_speedup, 1.0);
+        timing.cold_load_ns = file_bytes / std::max(config.load_bandwidth_mbps, 1.0) * 1e3
+                              + static_cast<double>(config.load_overhead_ms) * 1e6;
+        return timing;
+    }
+
+    LatencyModel::LatencyModel(const config::LatencyConfig& config, const std::vector<config::TagModelInfo>& catalog)
+        : config_(config),
+          default_timing_(compute_timing(config, config::ModelDetails{"gguf", "llama", "", std::nullopt,
+                                                                      "8.0B", "Q4_K_M"}, 0))
+    {
+        const auto logger = get_operational_logger();
+        timings_.reserve(catalog.size());
+        for (const auto& model : catalog)
+        {
+            const ModelTiming timing = compute_timing(config_, model.details, model.size);
+            timings_.insert_or_assign(model.name, CatalogTiming{model.digest, timing});
+            logger->debug("Latency profile for '{}': {:.1f} tok/s, prompt {:.0f} tok/s, cold load {:.2f}s",
+                          model.name, 1e9 / timing.eval_ns_per_token, 1e9 / timing.prompt_ns_per_token,
+                          timing.cold_load_ns / 1e9);
+        }
+    }
+
+    ModelTiming LatencyModel::timing(const config::TagModelInfo* model) const
+    {
+        if (model == nullptr)
+        {
+            return default_timing_;
+        }
+        if (const auto it = timings_.find(model->name); it != timings_.end() && it->second.digest == model->digest)
+        {
+            return it->second.timing;
+        }
+        return compute_timing(config_, model->details, model->size);
+    }
+
+    SimulatedTiming LatencyModel::simulate(const config::TagModelInfo* model_info, const bool cold_load,
+                                           const uint64_t prompt_tokens, const uint64_t eval_tokens) const
+    {
+        thread_local std::mt19937_64 rng{std::random_device{}()};
+        const ModelTiming model = timing(model_info);
+
+        const double load_ns = cold_load ? model.cold_load_ns : static_cast<double>(config_.warm_load_ms) * 1e6;
+
+        SimulatedTiming result;
+        result.load_duration = static_cast<uint64_t>(load_ns * jitter_factor(rng, config_.jitter));
+        result.prompt_eval_duration = static_cast<uint64_t>(static_cast<double>(prompt_tokens)
+                                                            * model.prompt_ns_per_token
+                                                            * jitter_factor(rng, config_.jitter));
+        result.eval_duration = static_cast<uint64_t>(static_cast<double>(eval_tokens) * model.eval_ns_per_token
+                                                     * jitter_factor(rng, config_.jitter));
+        return result;
+    }
+
+    void init_latency_model(const config::HoneypotConfig& config, const std::vector<config::TagModelInfo>& catalog)
+    {
+        latency_model = std::make_unique<const LatencyModel>(config.latency, catalog);
+        get_operational_logger()->info("Latency simulation {} for {} catalog models.",
+                                       config.latency.enabled ? "enabled" : "disabled", catalog.size());
+    }
+
+    const LatencyModel& get_latency_model()
+    {
+        if (!latency_model)
+        {
+            static const LatencyModel fallback{config::LatencyConfig{}, {}};
+            return fallback;
+        }
+        return *latency_model;
+    }
+} // namespace honeypot::utils
@@ -1,3 +1,4 @@
+#include <array>
 #include <vector>
 #include <memory>
 #include <stdexcept>
@@ -13,6 +14,13 @@
 
 #include "utils/logging.hpp"
 #include "utils/config.hpp"
+#include "utils/event_stream.hpp"
+#include "utils/hash.hpp"
+#include "utils/ip_index.hpp"
+#include "utils/prompt_classifier.hpp"
+#include "utils/request_arena.hpp"
+#include "utils/request_aggregator.hpp"
+#include "utils/trace.hpp"
 
 namespace honeypot::utils
 {
@@ -20,7 +28,89 @@ namespace honeypot::utils
     {
         std::shared_ptr<spdlog::logger> operational_logger_instance;
         std::shared_ptr<spdlog::logger> request_logger_instance;
+        std::unique_ptr<EventStream> event_stream;              // set when local consumers may subscribe
+        std::unique_ptr<RequestAggregator> request_aggregator; // set when repeats are collapsed
         bool logging_initialized = false;
+
+        void write_request_record(const std::string_view line)
+        {
+            if (request_logger_instance)
+            {
+                request_logger_instance->info(line);
+            }
+            if (event_stream)
+            {
+                event_stream->publish(line);
+            }
+        }
+
+        /**
+         * Builds a request record as @p Json: ArenaJson when it is written right away, nlohmann::json
+         * when the aggregator keeps it past the request.
+         */
+        template <typename Json>
+        Json make_log_entry(const crow::request& req, const crow::response& res, const RequestTags& tags)
+        {
+            using String = typename Json::string_t;
+            Json log_entry;
+
+            std::array<char, 32> timestamp;
+            const auto timestamp_end = fmt::format_to_n(timestamp.data(), timestamp.size(), "{:%Y-%m-%dT%H:%M:%S}Z",
+                                                        fmt::gmtime(
+                                                            std::chrono::system_clock::to_time_t(
+                                                                std::chrono::system_clock::now()))).out;
+            log_entry["timestamp"] = std::string_view(timestamp.data(), timestamp_end - timestamp.data());
+            log_entry["source_ip"] = std::string_view(req.remote_ip_address);
+            if (const auto source = lookup_ip(req.remote_ip_address))
+            {
+                log_entry["source_asn"] = source->asn;
+                log_entry["source_org"] = source->organization;
+                log_entry["source_country"] = source->country;
+            }
+            // log_entry["source_port"] = req.remote_port; // Placeholder
+
+            log_entry["method"] = crow::method_name(req.method);
+            log_entry["url"] = std::string_view(req.url);
+            if (!tags.probe_class.empty())
+            {
+                log_entry["probe_class"] = tags.probe_class;
+            }
+            if (!tags.listener.empty())
+            {
+                log_entry["listener"] = tags.listener;
+            }
+
+            Json headers_json = Json::object();
+            for (const auto& [fst, snd] : req.headers)
+            {
+                headers_json[String(fst)] = std::string_view(snd);
+            }
+            log_entry["headers"] = std::move(headers_json);
+            if (!tags.client_fingerprint.empty())
+            {
+                log_entry["client_fingerprint"] = tags.client_fingerprint;
+            }
+            if (req.headers.contains("User-Agent"))
+            {
+                log_entry["user_agent"] = std::string_view(req.get_header_value("User-Agent"));
+            }
+
+            constexpr size_t max_body_log_size = 4096;
+            log_entry["body"] = std::string_view(req.body).substr(0, max_body_log_size);
+            if (req.body.length() > max_body_log_size)
+            {
+                log_entry["body_truncated"] = true;
+            }
+            if (const auto prompt_tags = classify_prompt(req.body); !prompt_tags.empty())
+            {
+                log_entry["prompt_tags"] = prompt_tags; // matched over the whole body, not just the logged part
+            }
+
+            log_entry["response_status"] = res.code;
+
+            log_entry["_future_fields"] = Json::object();
+            return log_entry;
+        }
     }
 
     void init_logging(const config::HoneypotConfig& config)
@@ -40,7 +130,12 @@ namespace honeypot::utils
                 log_outputs,
                 log_file_path,
                 log_pattern,
-                request_log_path] = config.logging;
+                request_log_path,
+                ip_index_path,
+                collapse_window_seconds,
+                event_socket_path,
+                event_buffer_bytes,
+                prompt_signatures_path] = config.logging;
 
             std::vector<spdlog::sink_ptr> operational_sinks;
 
@@ -113,6 +208,29 @@ namespace honeypot::utils
                 operational_logger_instance->info("Request logging initialized to file: {}", request_log_path);
             }
 
+            if (!event_socket_path.empty())
+            {
+                try
+                {
+                    event_stream = std::make_unique<EventStream>(event_socket_path, event_buffer_bytes);
+                    operational_logger_instance->info("Streaming request records to consumers on '{}'.",
+                                                      event_socket_path);
+                }
+                catch (const std::exception& e)
+                {
+                    operational_logger_instance->warn("Request event stream disabled: {}", e.what());
+                }
+            }
+
+            if (collapse_window_seconds > 0 && (request_logger_instance || event_stream))
+            {
+                request_aggregator = std::make_unique<RequestAggregator>(
+                    std::chrono::seconds(collapse_window_seconds),
+                    [](const nlohmann::json& record) { write_request_record(record.dump()); });
+                operational_logger_instance->info("Identical requests from a source are collapsed per {}s window.",
+                                                  collapse_window_seconds);
+            }
+
             logging_initialized = true; // Set flag
         }
         catch (const spdlog::spdlog_ex& ex)
@@ -133,51 +251,29 @@ namespace honeypot::utils
         return operational_logger_instance;
     }
 
-    void log_request(const crow::request& req, const crow::response& res)
+    void log_request(const crow::request& req, const crow::response& res, const RequestTags& tags)
     {
-        if (!request_logger_instance)
+        if (!request_logger_instance && !event_stream)
         {
             return;
         }
 
+        TraceSpan span("request log write");
         try
         {
-            nlohmann::json log_entry;
-
-            log_entry["timestamp"] = fmt::format("{:%Y-%m-%dT%H:%M:%S}Z",
-                                                 fmt::gmtime(
-                                                     std::chrono::system_clock::to_time_t(
-                                                         std::chrono::system_clock::now())));
-            log_entry["source_ip"] = req.remote_ip_address;
-            // log_entry["source_port"] = req.remote_port; // Placeholder
-
-            log_entry["method"] = crow::method_name(req.method);
-            log_entry["url"] = req.url;
-
-            nlohmann::json headers_json = nlohmann::json::object();
-            for (const auto& [fst, snd] : req.headers)
+            if (request_aggregator)
             {
-                headers_json[fst] = snd;
+                // The same request on another listener, or sent by another client stack (header order
+                // and casing), is a different record.
+                uint64_t fingerprint = fnv1a_64(tags.listener, RequestAggregator::fingerprint(req, res.code));
+                fingerprint = fnv1a_64(tags.client_fingerprint, fingerprint);
+                request_aggregator->record(fingerprint, [&] {
+                    return make_log_entry<nlohmann::json>(req, res, tags);
+                });
+                return;
             }
-            log_entry["headers"] = std::move(headers_json);
-            if (req.headers.contains("User-Agent"))
-            {
-                log_entry["user_agent"] = req.get_header_value("User-Agent");
-            }
-
-            log_entry["body"] = req.body;
-            constexpr size_t max_body_log_size = 4096;
-            if (req.body.length() > max_body_log_size)
-            {
-                log_entry["body_truncated"] = true;
-                log_entry["body"] = req.body.substr(0, max_body_log_size);
-            }
-
-            log_entry["response_status"] = res.code;
-
-            log_entry["_future_fields"] = nlohmann::json::object();
-
-            request_logger_instance->info(log_entry.dump());
+            ArenaScope arena; // the record and its serialization are gone in one reset once written
+            write_request_record(make_log_entry<ArenaJson>(req, res, tags).dump());
         }
         catch (const std::exception& e)
         {
@@ -187,4 +283,18 @@ namespace honeypot::utils
             }
         }
     }
+
+    void shutdown_request_log()
+    {
+        request_aggregator.reset();
+        if (event_stream)
+        {
+            if (const uint64_t dropped = event_stream->frames_dropped(); dropped > 0)
+            {
+                operational_logger_instance->warn("Request event stream dropped {} frames for slow consumers.",
+                                                  dropped);
+            }
+            event_stream.reset();
+        }
+    }
 } // namespace honeypot::utils
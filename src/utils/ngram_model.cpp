@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <fmt/core.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "utils/ngram_model.hpp"
+
+namespace honeypot::utils
+{
+    namespace
+    {
+        constexpr uint64_t splitmix64(uint64_t& state) noexcept
+        {
+            uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            return z ^ (z >> 31);
+        }
+
+        // Maps a 32-bit random value onto [0, range) without a division.
+        constexpr uint32_t bounded(const uint32_t random, const uint32_t range) noexcept
+        {
+            return static_cast<uint32_t>((static_cast<uint64_t>(random) * range) >> 32);
+        }
+
+        bool section_fits(const uint64_t offset, const uint64_t count, const uint64_t element_size,
+                          const uint64_t file_size)
+        {
+            if (offset % 8 != 0 || offset > file_size)
+            {
+                return false;
+            }
+            return count <= (file_size - offset) / element_size;
+        }
+    }
+
+    std::shared_ptr<const NgramModel> NgramModel::open(const std::string& path)
+    {
+        std::shared_ptr<NgramModel> model(new NgramModel());
+
+#ifndef _WIN32
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            throw std::runtime_error(fmt::format("failed to open n-gram model '{}': {}", path, std::strerror(errno)));
+        }
+        struct stat st{};
+        if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(NgramFileHeader)))
+        {
+            ::close(fd);
+            throw std::runtime_error(fmt::format("n-gram model '{}' is truncated", path));
+        }
+        void* mapping = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED)
+        {
+            throw std::runtime_error(fmt::format("failed to map n-gram model '{}': {}", path, std::strerror(errno)));
+        }
+        model->data_ = static_cast<const std::byte*>(mapping);
+        model->size_ = static_cast<size_t>(st.st_size);
+        model->owns_mapping_ = true;
+#else
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in.is_open())
+        {
+            throw std::runtime_error(fmt::format("failed to open n-gram model '{}'", path));
+        }
+        model->size_ = static_cast<size_t>(in.tellg());
+        if (model->size_ < sizeof(NgramFileHeader))
+        {
+            throw std::runtime_error(fmt::format("n-gram model '{}' is truncated", path));
+        }
+        model->heap_copy_ = std::make_unique<std::byte[]>(model->size_);
+        in.seekg(0);
+        in.read(reinterpret_cast<char*>(model->heap_copy_.get()), static_cast<std::streamsize>(model->size_));
+        model->data_ = model->heap_copy_.get();
+#endif
+
+        const auto* header = reinterpret_cast<const NgramFileHeader*>(model->data_);
+        const uint64_t file_size = model->size_;
+        if (std::memcmp(header->magic, ngram_magic, sizeof(ngram_magic)) != 0
+            || header->version != ngram_format_version
+            || header->endian_tag != ngram_endian_tag
+            || header->file_size != file_size)
+        {
+            throw std::runtime_error(fmt::format("'{}' is not a compatible n-gram model", path));
+        }
+        if (header->context_count == 0 || header->token_count == 0
+            || !section_fits(header->token_offsets_offset, uint64_t{header->token_count} + 1, sizeof(uint32_t), file_size)
+            || !section_fits(header->contexts_offset, header->context_count, sizeof(NgramContext), file_size)
+            || !section_fits(header->edges_offset, header->edge_count, sizeof(NgramEdge), file_size)
+            || !section_fits(header->starts_offset, header->start_count, sizeof(uint32_t), file_size)
+            || header->strings_offset > file_size)
+        {
+            throw std::runtime_error(fmt::format("n-gram model '{}' has out-of-range sections", path));
+        }
+
+        model->header_ = header;
+        model->token_offsets_ = reinterpret_cast<const uint32_t*>(model->data_ + header->token_offsets_offset);
+        model->strings_ = reinterpret_cast<const char*>(model->data_ + header->strings_offset);
+        model->contexts_ = reinterpret_cast<const NgramContext*>(model->data_ + header->contexts_offset);
+        model->edges_ = reinterpret_cast<const NgramEdge*>(model->data_ + header->edges_offset);
+        model->starts_ = reinterpret_cast<const uint32_t*>(model->data_ + header->starts_offset);
+
+        // Offsets must not decrease, so every token's text lies within the last offset, checked here.
+        const bool offsets_ordered = std::ranges::is_sorted(
+            std::span(model->token_offsets_, size_t{header->token_count} + 1));
+        if (!offsets_ordered || model->token_offsets_[header->token_count] > file_size - header->strings_offset)
+        {
+            throw std::runtime_error(fmt::format("n-gram model '{}' has an out-of-range string table", path));
+        }
+        model->strings_bytes_ = model->token_offsets_[header->token_count];
+
+#if !defined(_WIN32) && defined(MADV_WILLNEED)
+        ::madvise(const_cast<std::byte*>(model->data_), model->size_, MADV_WILLNEED);
+#endif
+        return model;
+    }
+
+    NgramModel::~NgramModel()
+    {
+#ifndef _WIN32
+        if (owns_mapping_ && data_ != nullptr)
+        {
+            ::munmap(const_cast<std::byte*>(data_), size_);
+        }
+#endif
+    }
+
+    std::string_view NgramModel::token_text(const uint32_t token) const
+    {
+        // Ids come from the mapped file; clamp rather than trust them. Offsets were checked at load, but
+        // the mapping follows the file, so they are clamped to the checked string table as well.
+        if (token >= header_->token_count)
+        {
+            return {};
+        }
+        const uint32_t limit = strings_bytes_;
+        const uint32_t end = std::min(token_offsets_[token + 1], limit);
+        const uint32_t begin = std::min(token_offsets_[token], end);
+        return std::string_view(strings_ + begin, end - begin);
+    }
+
+    NgramStream NgramModel::start(const uint64_t seed) const
+    {
+        NgramStream stream;
+        stream.rng_state = seed;
+        const uint32_t random = static_cast<uint32_t>(splitmix64(stream.rng_state));
+        stream.context = header_->start_count > 0
+                             ? starts_[bounded(random, header_->start_count)]
+                             : bounded(random, header_->context_count);
+        if (stream.context >= header_->context_count)
+        {
+            stream.context = 0;
+        }
+        return stream;
+    }
+
+    std::string_view NgramModel::next(NgramStream& stream) const
+    {
+        if (stream.emitted++ == 0)
+        {
+            // The first token of a stream is the start context itself, without leading whitespace.
+            std::string_view first = token_text(contexts_[stream.context].token);
+            while (!first.empty() && (first.front() == ' ' || first.front() == '\n'))
+            {
+                first.remove_prefix(1);
+            }
+            return first;
+        }
+
+        const NgramContext& context = contexts_[stream.context];
+        const uint64_t random = splitmix64(stream.rng_state);
+
+        if (context.edge_count == 0 || uint64_t{context.edge_begin} + context.edge_count > header_->edge_count)
+        {
+            // Dead end: jump to a fresh sentence.
+            stream.context = start(random).context;
+            return token_text(contexts_[stream.context].token);
+        }
+
+        const uint32_t slot = bounded(static_cast<uint32_t>(random >> 32), context.edge_count);
+        const NgramEdge& candidate = edges_[context.edge_begin + slot];
+        const uint32_t chosen = static_cast<uint32_t>(random) < candidate.threshold ? slot : candidate.alias;
+        const NgramEdge& edge = edges_[context.edge_begin + (chosen < context.edge_count ? chosen : slot)];
+
+        stream.context = edge.next_context < header_->context_count ? edge.next_context : 0;
+        return token_text(contexts_[stream.context].token);
+    }
+} // namespace honeypot::utils
@@ -0,0 +1,248 @@
+#include <algorithm>
+#include <array>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "utils/probe_classifier.hpp"
+
+namespace honeypot::utils
+{
+    namespace
+    {
+        constexpr std::string_view unknown_class = "unknown";
+        constexpr std::string_view root_class = "root";
+
+        constexpr std::array builtin_patterns{
+            // Only unrouted paths are classified, so served endpoints (/api/tags, /api/create,
+            // /v1/models, ...) never show up here; these are the Ollama ones that are not routed.
+            ProbePattern{"/api/ps", "ollama_api"},
+            ProbePattern{"/api/pull", "ollama_api"},
+            ProbePattern{"/api/push", "ollama_api"},
+            ProbePattern{"/api/embed", "ollama_api"},
+            ProbePattern{"/api/blobs/", "ollama_api"},
+            ProbePattern{"/api/", "ollama_api"},
+            // OpenAI-compatible paths beyond the routed /v1 endpoints
+            ProbePattern{"/v1/", "openai_api"},
+            // Secrets and source disclosure
+            ProbePattern{"/.env", "credential_leak"},
+            ProbePattern{"/.aws/", "credential_leak"},
+            ProbePattern{"/.ssh/", "credential_leak"},
+            ProbePattern{"/.npmrc", "credential_leak"},
+            ProbePattern{"/.docker/config.json", "credential_leak"},
+            ProbePattern{"/config.json$", "credential_leak"},
+            ProbePattern{"^/credentials", "credential_leak"},
+            ProbePattern{"/.git/", "source_leak"},
+            ProbePattern{"/.svn/", "source_leak"},
+            ProbePattern{"/.hg/", "source_leak"},
+            ProbePattern{"/.ds_store", "source_leak"},
+            ProbePattern{"^/backup", "source_leak"},
+            ProbePattern{"/server-status", "source_leak"},
+            ProbePattern{"/phpinfo.php", "source_leak"},
+            ProbePattern{"/info.php", "source_leak"},
+            // CMS and PHP frameworks
+            ProbePattern{"/wp-login.php", "wordpress"},
+            ProbePattern{"/wp-admin", "wordpress"},
+            ProbePattern{"/wp-content/", "wordpress"},
+            ProbePattern{"/wp-includes/", "wordpress"},
+            ProbePattern{"/xmlrpc.php", "wordpress"},
+            ProbePattern{"/phpmyadmin", "phpmyadmin"},
+            ProbePattern{"/pma/", "phpmyadmin"},
+            ProbePattern{"/vendor/phpunit/", "php_exploit"},
+            ProbePattern{"/_ignition/", "php_exploit"},
+            ProbePattern{"^/laravel", "php_exploit"},
+            // Java / admin consoles
+            ProbePattern{"/actuator", "admin_console"},
+            ProbePattern{"/manager/html", "admin_console"},
+            ProbePattern{"^/console", "admin_console"},
+            ProbePattern{"/solr/", "admin_console"},
+            ProbePattern{"/jenkins", "admin_console"},
+            ProbePattern{"/druid/", "admin_console"},
+            // Routers, cameras and other embedded devices
+            ProbePattern{"/cgi-bin/", "device_exploit"},
+            ProbePattern{"/boaform/", "device_exploit"},
+            ProbePattern{"/hnap1", "device_exploit"},
+            ProbePattern{"/gponform/", "device_exploit"},
+            ProbePattern{"/setup.cgi", "device_exploit"},
+            ProbePattern{"^/shell", "device_exploit"},
+            ProbePattern{"/goform/", "device_exploit"},
+            ProbePattern{"^/sdk", "device_exploit"},
+            // Other AI / inference servers
+            ProbePattern{"/sdapi/", "ai_service"},
+            ProbePattern{"/gradio_api/", "ai_service"},
+            ProbePattern{"/queue/join", "ai_service"},
+            ProbePattern{"/v2/models", "ai_service"},
+            ProbePattern{"/generate$", "ai_service"},
+            // Crawlers and fingerprinting
+            ProbePattern{"/robots.txt$", "crawler"},
+            ProbePattern{"/sitemap.xml$", "crawler"},
+            ProbePattern{"/favicon.ico$", "crawler"},
+            ProbePattern{"/.well-known/", "crawler"},
+        };
+
+        constexpr char lower(const char c)
+        {
+            return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+        }
+    }
+
+    ProbeClassifier::ProbeClassifier(const std::span<const ProbePattern> patterns)
+    {
+        // Build with ordered child maps, then flatten into contiguous sorted edge lists.
+        struct BuildNode
+        {
+            std::map<char, uint32_t> children;
+            uint32_t prefix_class = no_class;
+            uint32_t exact_class = no_class;
+            uint32_t root_prefix_class = no_class;
+            uint32_t root_exact_class = no_class;
+        };
+        std::vector<BuildNode> build(1);
+
+        for (const auto& [pattern, probe_class] : patterns)
+        {
+            auto class_id = static_cast<uint32_t>(
+                std::ranges::find(classes_, probe_class) - classes_.begin());
+            if (class_id == classes_.size())
+            {
+                classes_.push_back(probe_class);
+            }
+
+            std::string_view text = pattern;
+            const bool anchored = text.starts_with('^');
+            if (anchored)
+            {
+                text.remove_prefix(1);
+            }
+            const bool exact = text.ends_with('$');
+            if (exact)
+            {
+                text.remove_suffix(1);
+            }
+
+            uint32_t node = 0;
+            for (const char c : text)
+            {
+                const char key = lower(c);
+                const auto it = build[node].children.find(key);
+                if (it != build[node].children.end())
+                {
+                    node = it->second;
+                    continue;
+                }
+                const auto child = static_cast<uint32_t>(build.size());
+                build[node].children.emplace(key, child);
+                build.emplace_back();
+                node = child;
+            }
+            BuildNode& target = build[node];
+            if (anchored)
+            {
+                (exact ? target.root_exact_class : target.root_prefix_class) = class_id;
+            }
+            else
+            {
+                (exact ? target.exact_class : target.prefix_class) = class_id;
+            }
+        }
+
+        nodes_.resize(build.size());
+        for (size_t i = 0; i < build.size(); ++i)
+        {
+            nodes_[i].first_edge = static_cast<uint32_t>(edges_.size());
+            nodes_[i].edge_count = static_cast<uint32_t>(build[i].children.size());
+            nodes_[i].prefix_class = build[i].prefix_class;
+            nodes_[i].exact_class = build[i].exact_class;
+            nodes_[i].root_prefix_class = build[i].root_prefix_class;
+            nodes_[i].root_exact_class = build[i].root_exact_class;
+            for (const auto& [byte, child] : build[i].children)
+            {
+                edges_.push_back({byte, child});
+            }
+        }
+    }
+
+    std::pair<size_t, uint32_t> ProbeClassifier::match_at(const std::string_view path, const bool at_root) const
+    {
+        size_t best_length = 0;
+        uint32_t best_class = no_class;
+        uint32_t node = 0;
+        for (size_t depth = 0;; ++depth)
+        {
+            const Node& current = nodes_[node];
+            const uint32_t prefix_class =
+                at_root && current.root_prefix_class != no_class ? current.root_prefix_class : current.prefix_class;
+            if (prefix_class != no_class)
+            {
+                best_length = depth;
+                best_class = prefix_class;
+            }
+            if (depth == path.size())
+            {
+                const uint32_t exact_class =
+                    at_root && current.root_exact_class != no_class ? current.root_exact_class : current.exact_class;
+                if (exact_class != no_class)
+                {
+                    best_length = depth;
+                    best_class = exact_class;
+                }
+                break;
+            }
+
+            const char key = lower(path[depth]);
+            const Edge* begin = edges_.data() + current.first_edge;
+            const Edge* end = begin + current.edge_count;
+            const Edge* edge = std::lower_bound(begin, end, key, [](const Edge& e, const char k) {
+                return e.byte < k;
+            });
+            if (edge == end || edge->byte != key)
+            {
+                break;
+            }
+            node = edge->child;
+        }
+        return {best_length, best_class};
+    }
+
+    std::string_view ProbeClassifier::classify(const std::string_view path) const
+    {
+        if (path.empty() || path == "/")
+        {
+            return root_class;
+        }
+
+        size_t best_length = 0;
+        uint32_t best_class = no_class;
+        for (size_t start = 0; start < path.size(); start = path.find('/', start + 1))
+        {
+            if (path[start] != '/')
+            {
+                continue;
+            }
+            const auto [length, probe_class] = match_at(path.substr(start), start == 0);
+            if (probe_class != no_class && length > best_length)
+            {
+                best_length = length;
+                best_class = probe_class;
+            }
+        }
+        return best_class == no_class ? unknown_class : classes_[best_class];
+    }
+
+    const ProbeClassifier& get_probe_classifier()
+    {
+        static const ProbeClassifier classifier{builtin_patterns};
+        return classifier;
+    }
+
+    bool is_exploit_probe(const std::string_view probe_class)
+    {
+        static constexpr std::array<std::string_view, 7> exploit_classes = {
+            "credential_leak", "source_leak", "wordpress", "phpmyadmin", "php_exploit", "admin_console",
+            "device_exploit",
+        };
+        return std::ranges::find(exploit_classes, probe_class) != exploit_classes.end();
+    }
+} // namespace honeypot::utils
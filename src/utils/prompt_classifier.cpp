@@ -0,0 +1,786 @@
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <bitset>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fmt/core.h>
+#include <nlohmann/json.hpp>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define HONEYPOT_SHUFTI_SSSE3 1
+#endif
+
+#include "utils/prompt_classifier.hpp"
+#include "utils/logging.hpp"
+
+namespace honeypot::utils
+{
+    namespace
+    {
+        std::atomic<std::shared_ptr<const PromptClassifier>> active_classifier;
+        std::atomic<uint64_t> classifier_generation{0};
+        std::filesystem::path signatures_path;
+
+        // Same per-thread caching as the IP index: one atomic load per scan while nothing reloads.
+        struct CachedClassifier
+        {
+            uint64_t generation = UINT64_MAX;
+            std::shared_ptr<const PromptClassifier> classifier;
+            std::vector<std::string_view> tags;
+        };
+        thread_local CachedClassifier cached_classifier;
+
+        constexpr uint32_t no_node = UINT32_MAX;
+        constexpr size_t prefilter_buckets = 8;
+
+        using ByteSet = std::bitset<256>;
+
+        struct NfaNode
+        {
+            enum class Kind : uint8_t
+            {
+                epsilon,
+                bytes,
+                accept
+            };
+
+            Kind kind = Kind::epsilon;
+            uint32_t out = no_node;
+            uint32_t out2 = no_node;
+            uint32_t set = 0;      // bytes nodes: index into Nfa::sets
+            uint32_t category = 0; // accept nodes
+        };
+
+        struct Nfa
+        {
+            std::vector<NfaNode> nodes;
+            std::vector<ByteSet> sets;
+
+            uint32_t add(const NfaNode& node)
+            {
+                nodes.push_back(node);
+                return static_cast<uint32_t>(nodes.size() - 1);
+            }
+
+            uint32_t add_epsilon(const uint32_t out = no_node, const uint32_t out2 = no_node)
+            {
+                return add({NfaNode::Kind::epsilon, out, out2});
+            }
+        };
+
+        // A piece of NFA with one entry and one exit; the exit is an epsilon node without outs yet.
+        struct Fragment
+        {
+            uint32_t start;
+            uint32_t end;
+        };
+
+        Fragment bytes_fragment(Nfa& nfa, const ByteSet& set)
+        {
+            nfa.sets.push_back(set);
+            const uint32_t end = nfa.add_epsilon();
+            const uint32_t start = nfa.add({NfaNode::Kind::bytes, end, no_node,
+                                            static_cast<uint32_t>(nfa.sets.size() - 1)});
+            return {start, end};
+        }
+
+        Fragment concat(Nfa& nfa, const Fragment first, const Fragment second)
+        {
+            nfa.nodes[first.end].out = second.start;
+            return {first.start, second.end};
+        }
+
+        size_t lowest_byte(const ByteSet& set)
+        {
+            size_t b = 0;
+            while (b < set.size() && !set[b])
+            {
+                ++b;
+            }
+            return b;
+        }
+
+        ByteSet single_byte(const unsigned char byte)
+        {
+            ByteSet set;
+            set.set(byte);
+            return set;
+        }
+
+        ByteSet class_escape(const char escape)
+        {
+            ByteSet set;
+            for (int b = 0; b < 256; ++b)
+            {
+                const auto c = static_cast<unsigned char>(b);
+                const bool member = escape == 'd' || escape == 'D' ? std::isdigit(c) != 0
+                                    : escape == 'w' || escape == 'W' ? std::isalnum(c) != 0 || c == '_'
+                                    : std::isspace(c) != 0;
+                set[b] = member != (std::isupper(static_cast<unsigned char>(escape)) != 0);
+            }
+            return set;
+        }
+
+        /**
+         * Recursive-descent parser for the restricted dialect, emitting Thompson NFA fragments:
+         *   alternation := concatenation ('|' concatenation)*
+         *   concatenation := repetition*
+         *   repetition := atom ('?' | '*' | '+')*
+         *   atom := '(' alternation ')' | '[' class ']' | '.' | '\' escape | literal
+         */
+        class RegexParser
+        {
+        public:
+            RegexParser(Nfa& nfa, const std::string_view pattern) : nfa_(nfa), pattern_(pattern) {}
+
+            Fragment parse()
+            {
+                const Fragment fragment = alternation();
+                if (pos_ != pattern_.size())
+                {
+                    fail("unbalanced ')'");
+                }
+                return fragment;
+            }
+
+        private:
+            [[noreturn]] void fail(const std::string_view reason) const
+            {
+                throw std::invalid_argument(fmt::format("{} at offset {}", reason, pos_));
+            }
+
+            bool at_end() const { return pos_ >= pattern_.size(); }
+            char peek() const { return pattern_[pos_]; }
+
+            Fragment alternation()
+            {
+                Fragment fragment = concatenation();
+                while (!at_end() && peek() == '|')
+                {
+                    ++pos_;
+                    const Fragment other = concatenation();
+                    const uint32_t end = nfa_.add_epsilon();
+                    nfa_.nodes[fragment.end].out = end;
+                    nfa_.nodes[other.end].out = end;
+                    fragment = {nfa_.add_epsilon(fragment.start, other.start), end};
+                }
+                return fragment;
+            }
+
+            Fragment concatenation()
+            {
+                const uint32_t empty = nfa_.add_epsilon();
+                Fragment fragment{empty, empty};
+                while (!at_end() && peek() != '|' && peek() != ')')
+                {
+                    fragment = concat(nfa_, fragment, repetition());
+                }
+                return fragment;
+            }
+
+            Fragment repetition()
+            {
+                Fragment fragment = atom();
+                while (!at_end() && (peek() == '?' || peek() == '*' || peek() == '+'))
+                {
+                    const char quantifier = pattern_[pos_++];
+                    const uint32_t end = nfa_.add_epsilon();
+                    if (quantifier == '?')
+                    {
+                        nfa_.nodes[fragment.end].out = end;
+                        fragment = {nfa_.add_epsilon(fragment.start, end), end};
+                    }
+                    else
+                    {
+                        const uint32_t loop = nfa_.add_epsilon(fragment.start, end);
+                        nfa_.nodes[fragment.end].out = loop;
+                        fragment = {quantifier == '*' ? loop : fragment.start, end};
+                    }
+                }
+                return fragment;
+            }
+
+            Fragment atom()
+            {
+                const char c = pattern_[pos_++];
+                switch (c)
+                {
+                case '(':
+                {
+                    const Fragment fragment = alternation();
+                    if (at_end() || peek() != ')')
+                    {
+                        fail("missing ')'");
+                    }
+                    ++pos_;
+                    return fragment;
+                }
+                case '[':
+                    return bytes_fragment(nfa_, byte_class());
+                case '.':
+                    return bytes_fragment(nfa_, ~single_byte('\n'));
+                case '\\':
+                    return bytes_fragment(nfa_, escape(false));
+                case '^':
+                case '$':
+                    fail("anchors are not supported");
+                case '{':
+                case '}':
+                    fail("counted repetition is not supported (escape braces to match them)");
+                case '?':
+                case '*':
+                case '+':
+                    fail("quantifier without anything to repeat");
+                default:
+                    return bytes_fragment(nfa_, single_byte(static_cast<unsigned char>(c)));
+                }
+            }
+
+            ByteSet escape(const bool in_class)
+            {
+                if (at_end())
+                {
+                    fail("trailing '\\'");
+                }
+                const char c = pattern_[pos_++];
+                switch (c)
+                {
+                case 'd': case 'D': case 'w': case 'W': case 's': case 'S':
+                    return class_escape(c);
+                case 'n':
+                    return single_byte('\n');
+                case 'r':
+                    return single_byte('\r');
+                case 't':
+                    return single_byte('\t');
+                default:
+                    if (std::isalnum(static_cast<unsigned char>(c)))
+                    {
+                        fail(in_class ? "unsupported escape in class" : "unsupported escape");
+                    }
+                    return single_byte(static_cast<unsigned char>(c));
+                }
+            }
+
+            ByteSet byte_class()
+            {
+                ByteSet set;
+                const bool negated = !at_end() && peek() == '^';
+                if (negated)
+                {
+                    ++pos_;
+                }
+                for (bool first = true;; first = false)
+                {
+                    if (at_end())
+                    {
+                        fail("missing ']'");
+                    }
+                    if (peek() == ']' && !first)
+                    {
+                        ++pos_;
+                        break;
+                    }
+
+                    const ByteSet low = class_atom();
+                    if (low.count() != 1 || pos_ + 1 >= pattern_.size() || peek() != '-' || pattern_[pos_ + 1] == ']')
+                    {
+                        set |= low;
+                        continue;
+                    }
+                    ++pos_; // '-'
+                    const ByteSet high = class_atom();
+                    if (high.count() != 1)
+                    {
+                        fail("class escape as range bound");
+                    }
+                    const size_t from = lowest_byte(low);
+                    const size_t to = lowest_byte(high);
+                    if (to < from)
+                    {
+                        fail("reversed range");
+                    }
+                    for (size_t b = from; b <= to; ++b)
+                    {
+                        set.set(b);
+                    }
+                }
+                return negated ? ~set : set;
+            }
+
+            ByteSet class_atom()
+            {
+                const char c = pattern_[pos_++];
+                return c == '\\' ? escape(true) : single_byte(static_cast<unsigned char>(c));
+            }
+
+            Nfa& nfa_;
+            std::string_view pattern_;
+            size_t pos_ = 0;
+        };
+
+        Fragment literal_fragment(Nfa& nfa, const std::string_view text)
+        {
+            const uint32_t empty = nfa.add_epsilon();
+            Fragment fragment{empty, empty};
+            for (const char c : text)
+            {
+                fragment = concat(nfa, fragment, bytes_fragment(nfa, single_byte(static_cast<unsigned char>(c))));
+            }
+            return fragment;
+        }
+
+        /**
+         * The bytes and accept nodes reachable from @p seeds through epsilon edges, sorted.
+         * Only those distinguish DFA states.
+         */
+        std::vector<uint32_t> closure(const Nfa& nfa, std::vector<uint32_t> stack)
+        {
+            std::vector<uint32_t> result;
+            std::vector<bool> visited(nfa.nodes.size());
+            while (!stack.empty())
+            {
+                const uint32_t id = stack.back();
+                stack.pop_back();
+                if (id == no_node || visited[id])
+                {
+                    continue;
+                }
+                visited[id] = true;
+                const NfaNode& node = nfa.nodes[id];
+                if (node.kind == NfaNode::Kind::epsilon)
+                {
+                    stack.push_back(node.out);
+                    stack.push_back(node.out2);
+                }
+                else
+                {
+                    result.push_back(id);
+                }
+            }
+            std::ranges::sort(result);
+            return result;
+        }
+
+        ByteSet first_bytes(const Nfa& nfa, const std::vector<uint32_t>& nodes, bool& can_accept)
+        {
+            ByteSet set;
+            for (const uint32_t id : nodes)
+            {
+                const NfaNode& node = nfa.nodes[id];
+                if (node.kind == NfaNode::Kind::bytes)
+                {
+                    set |= nfa.sets[node.set];
+                }
+                else
+                {
+                    can_accept = true;
+                }
+            }
+            return set;
+        }
+
+#ifdef HONEYPOT_SHUFTI_SSSE3
+        /**
+         * Double shufti: for 16 positions at once, looks up each byte's bucket bits by low and high
+         * nibble (pshufb) for both the byte and its successor, and stops at the first position where
+         * they share a bucket. Stops short of the last 16 bytes, which the DFA reads one by one.
+         */
+        __attribute__((target("ssse3")))
+        size_t shufti_next(const PromptClassifier::PrefilterTables& tables, const uint8_t* data, size_t pos,
+                           const size_t size)
+        {
+            const __m128i nibble = _mm_set1_epi8(0x0f);
+            const __m128i first_lo = _mm_load_si128(reinterpret_cast<const __m128i*>(tables.first_lo.data()));
+            const __m128i first_hi = _mm_load_si128(reinterpret_cast<const __m128i*>(tables.first_hi.data()));
+            const __m128i second_lo = _mm_load_si128(reinterpret_cast<const __m128i*>(tables.second_lo.data()));
+            const __m128i second_hi = _mm_load_si128(reinterpret_cast<const __m128i*>(tables.second_hi.data()));
+            const __m128i zero = _mm_setzero_si128();
+
+            while (pos + 17 <= size)
+            {
+                const __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+                const __m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + 1));
+                const __m128i first = _mm_and_si128(
+                    _mm_shuffle_epi8(first_lo, _mm_and_si128(current, nibble)),
+                    _mm_shuffle_epi8(first_hi, _mm_and_si128(_mm_srli_epi16(current, 4), nibble)));
+                const __m128i second = _mm_and_si128(
+                    _mm_shuffle_epi8(second_lo, _mm_and_si128(next, nibble)),
+                    _mm_shuffle_epi8(second_hi, _mm_and_si128(_mm_srli_epi16(next, 4), nibble)));
+                const int misses = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(first, second), zero));
+                if (misses != 0xffff)
+                {
+                    return pos + static_cast<size_t>(std::countr_one(static_cast<unsigned>(misses)));
+                }
+                pos += 16;
+            }
+            return pos;
+        }
+#endif
+    }
+
+    PromptClassifier::PromptClassifier(const std::span<const PromptSignature> signatures)
+        : signature_count_(signatures.size())
+    {
+        Nfa nfa;
+        std::vector<uint32_t> starts;
+        std::vector<uint64_t> signature_categories;
+        for (size_t i = 0; i < signatures.size(); ++i)
+        {
+            const PromptSignature& signature = signatures[i];
+            auto category_it = std::ranges::find(categories_, signature.category);
+            if (category_it == categories_.end())
+            {
+                if (categories_.size() == max_categories)
+                {
+                    throw std::invalid_argument(fmt::format("more than {} categories", max_categories));
+                }
+                categories_.push_back(signature.category);
+                category_it = categories_.end() - 1;
+            }
+            const auto category = static_cast<uint32_t>(category_it - categories_.begin());
+
+            Fragment fragment{};
+            try
+            {
+                fragment = signature.literal ? literal_fragment(nfa, signature.expression)
+                                             : RegexParser(nfa, signature.expression).parse();
+            }
+            catch (const std::invalid_argument& e)
+            {
+                throw std::invalid_argument(fmt::format("signature {} ('{}'): {}", i, signature.expression,
+                                                        e.what()));
+            }
+            nfa.nodes[fragment.end].out = nfa.add({NfaNode::Kind::accept, no_node, no_node, 0, category});
+            starts.push_back(fragment.start);
+        }
+        all_categories_ = categories_.size() == 64 ? ~uint64_t{0} : (uint64_t{1} << categories_.size()) - 1;
+
+        // ASCII case folding happens once, on the byte sets, so scanning needs no lowercasing.
+        for (ByteSet& set : nfa.sets)
+        {
+            for (unsigned b = 'a'; b <= 'z'; ++b)
+            {
+                if (set[b] || set[b - 32])
+                {
+                    set.set(b);
+                    set.set(b - 32);
+                }
+            }
+        }
+
+        // Bytes that every byte set treats alike share a class, and a column of the table.
+        std::map<std::vector<bool>, uint8_t> class_ids;
+        std::vector<uint8_t> class_representative;
+        for (unsigned b = 0; b < 256; ++b)
+        {
+            std::vector<bool> membership(nfa.sets.size());
+            for (size_t s = 0; s < nfa.sets.size(); ++s)
+            {
+                membership[s] = nfa.sets[s][b];
+            }
+            const auto [it, inserted] = class_ids.emplace(std::move(membership),
+                                                          static_cast<uint8_t>(class_representative.size()));
+            if (inserted)
+            {
+                class_representative.push_back(static_cast<uint8_t>(b));
+            }
+            byte_class_[b] = it->second;
+        }
+        class_count_ = class_representative.size();
+
+        // Subset construction. Every state also holds the start closure, which makes the scan
+        // unanchored: a match may begin at any byte.
+        const std::vector<uint32_t> start_closure = closure(nfa, starts);
+        for (size_t i = 0; i < starts.size(); ++i)
+        {
+            bool can_accept = false;
+            first_bytes(nfa, closure(nfa, {starts[i]}), can_accept);
+            if (can_accept)
+            {
+                throw std::invalid_argument(fmt::format("signature {} ('{}') matches the empty string", i,
+                                                        signatures[i].expression));
+            }
+        }
+
+        std::vector<std::vector<uint32_t>> states{start_closure};
+        std::map<std::vector<uint32_t>, uint32_t> state_ids{{start_closure, 0}};
+        std::vector<uint32_t> raw_transitions; // unnumbered: [state * class_count_ + class] = state
+        for (size_t current = 0; current < states.size(); ++current)
+        {
+            for (size_t cls = 0; cls < class_count_; ++cls)
+            {
+                const uint8_t byte = class_representative[cls];
+                std::vector<uint32_t> seeds = starts;
+                for (const uint32_t id : states[current])
+                {
+                    const NfaNode& node = nfa.nodes[id];
+                    if (node.kind == NfaNode::Kind::bytes && nfa.sets[node.set][byte])
+                    {
+                        seeds.push_back(node.out);
+                    }
+                }
+                std::vector<uint32_t> next = closure(nfa, std::move(seeds));
+                const auto [it, inserted] = state_ids.emplace(next, static_cast<uint32_t>(states.size()));
+                if (inserted)
+                {
+                    if (states.size() == max_states)
+                    {
+                        throw std::invalid_argument(fmt::format("signatures need more than {} DFA states",
+                                                                max_states));
+                    }
+                    states.push_back(std::move(next));
+                }
+                raw_transitions.push_back(it->second);
+            }
+        }
+        state_count_ = states.size();
+
+        // Renumber so accepting states come last; the scan loop then checks them with one compare.
+        std::vector<uint64_t> masks(states.size());
+        for (size_t s = 0; s < states.size(); ++s)
+        {
+            for (const uint32_t id : states[s])
+            {
+                if (nfa.nodes[id].kind == NfaNode::Kind::accept)
+                {
+                    masks[s] |= uint64_t{1} << nfa.nodes[id].category;
+                }
+            }
+        }
+        std::vector<uint32_t> order(states.size());
+        uint32_t next_id = 0;
+        for (const bool accepting : {false, true})
+        {
+            if (accepting)
+            {
+                first_accepting_ = next_id * static_cast<uint32_t>(class_count_);
+            }
+            for (size_t s = 0; s < states.size(); ++s)
+            {
+                if ((masks[s] != 0) == accepting)
+                {
+                    order[s] = next_id++;
+                    if (accepting)
+                    {
+                        accept_.push_back(masks[s]);
+                    }
+                }
+            }
+        }
+        transitions_.resize(states.size() * class_count_);
+        for (size_t s = 0; s < states.size(); ++s)
+        {
+            for (size_t cls = 0; cls < class_count_; ++cls)
+            {
+                transitions_[order[s] * class_count_ + cls] =
+                    order[raw_transitions[s * class_count_ + cls]] * static_cast<uint32_t>(class_count_);
+            }
+        }
+        start_ = order[0] * static_cast<uint32_t>(class_count_);
+
+        // Prefilter buckets: signatures with the same lowest first byte share one, so a bucket's
+        // first-byte set stays small. A signature that can match a single byte allows any second byte.
+        std::vector<uint8_t> lowest_first;
+        std::vector<std::pair<ByteSet, ByteSet>> pairs;
+        for (const uint32_t start : starts)
+        {
+            bool unused = false;
+            const std::vector<uint32_t> entry = closure(nfa, {start});
+            const ByteSet first = first_bytes(nfa, entry, unused);
+            ByteSet second;
+            for (const uint32_t id : entry)
+            {
+                bool single_byte_match = false;
+                second |= first_bytes(nfa, closure(nfa, {nfa.nodes[id].out}), single_byte_match);
+                if (single_byte_match)
+                {
+                    second.set();
+                }
+            }
+            pairs.emplace_back(first, second);
+            lowest_first.push_back(static_cast<uint8_t>(lowest_byte(first)));
+        }
+        std::vector<uint8_t> distinct_lowest = lowest_first;
+        std::ranges::sort(distinct_lowest);
+        distinct_lowest.erase(std::ranges::unique(distinct_lowest).begin(), distinct_lowest.end());
+        for (size_t i = 0; i < pairs.size(); ++i)
+        {
+            const auto rank = std::ranges::lower_bound(distinct_lowest, lowest_first[i]) - distinct_lowest.begin();
+            const auto bucket = static_cast<uint8_t>(1u << (rank % prefilter_buckets));
+            for (unsigned b = 0; b < 256; ++b)
+            {
+                if (pairs[i].first[b])
+                {
+                    prefilter_tables_.first_lo[b & 0x0f] |= bucket;
+                    prefilter_tables_.first_hi[b >> 4] |= bucket;
+                }
+                if (pairs[i].second[b])
+                {
+                    prefilter_tables_.second_lo[b & 0x0f] |= bucket;
+                    prefilter_tables_.second_hi[b >> 4] |= bucket;
+                }
+            }
+        }
+#ifdef HONEYPOT_SHUFTI_SSSE3
+        if (!signatures.empty() && __builtin_cpu_supports("ssse3"))
+        {
+            prefilter_ = &shufti_next;
+        }
+#endif
+    }
+
+    uint64_t PromptClassifier::scan(const std::string_view text) const
+    {
+        if (signature_count_ == 0)
+        {
+            return 0;
+        }
+
+        const auto* data = reinterpret_cast<const uint8_t*>(text.data());
+        const size_t size = text.size();
+        const uint32_t* transitions = transitions_.data();
+        uint32_t state = start_;
+        uint64_t matched = 0;
+        for (size_t pos = 0; pos < size; ++pos)
+        {
+            if (state == start_ && prefilter_ != nullptr)
+            {
+                pos = prefilter_(prefilter_tables_, data, pos, size);
+            }
+            state = transitions[state + byte_class_[data[pos]]];
+            if (state >= first_accepting_)
+            {
+                matched |= accept_[(state - first_accepting_) / class_count_];
+                if (matched == all_categories_)
+                {
+                    break;
+                }
+            }
+        }
+        return matched;
+    }
+
+    std::shared_ptr<const PromptClassifier> PromptClassifier::load(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            throw std::runtime_error("cannot open file");
+        }
+        std::stringstream content;
+        content << file.rdbuf();
+
+        nlohmann::json document;
+        try
+        {
+            document = nlohmann::json::parse(content.str());
+        }
+        catch (const nlohmann::json::parse_error& e)
+        {
+            throw std::runtime_error(e.what());
+        }
+
+        std::vector<PromptSignature> signatures;
+        if (!document.contains("signatures") || !document["signatures"].is_array())
+        {
+            throw std::runtime_error("missing 'signatures' array");
+        }
+        for (const auto& entry : document["signatures"])
+        {
+            if (!entry.is_object() || !entry.contains("category") || !entry["category"].is_string())
+            {
+                throw std::runtime_error("signature without a 'category' string");
+            }
+            PromptSignature signature{.category = entry["category"].get<std::string>(), .expression = {}};
+            if (entry.contains("literal") && entry["literal"].is_string())
+            {
+                signature.expression = entry["literal"].get<std::string>();
+                signature.literal = true;
+            }
+            else if (entry.contains("pattern") && entry["pattern"].is_string())
+            {
+                signature.expression = entry["pattern"].get<std::string>();
+            }
+            else
+            {
+                throw std::runtime_error("signature without a 'literal' or 'pattern' string");
+            }
+            signatures.push_back(std::move(signature));
+        }
+        return std::make_shared<const PromptClassifier>(signatures);
+    }
+
+    void init_prompt_classifier(const config::HoneypotConfig& config)
+    {
+        const auto logger = get_operational_logger();
+        if (config.logging.prompt_signatures_path.empty())
+        {
+            logger->info("No 'prompt_signatures_path' configured, request logs are not tagged with prompt categories.");
+            return;
+        }
+
+        signatures_path = std::filesystem::path("config") / config.logging.prompt_signatures_path;
+        reload_prompt_classifier();
+    }
+
+    bool reload_prompt_classifier()
+    {
+        const auto logger = get_operational_logger();
+        if (signatures_path.empty())
+        {
+            logger->info("Prompt signature reload requested but no signature file is configured.");
+            return false;
+        }
+
+        try
+        {
+            auto classifier = PromptClassifier::load(signatures_path.string());
+            logger->info("Compiled {} prompt signatures from '{}' ({} categories, {} DFA states, {} byte classes{}).",
+                         classifier->signature_count(), signatures_path.string(), classifier->category_count(),
+                         classifier->state_count(), classifier->class_count(),
+                         classifier->prefiltered() ? ", SSSE3 prefilter" : "");
+            active_classifier.store(std::move(classifier));
+            classifier_generation.fetch_add(1, std::memory_order_release);
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            logger->error("Failed to load prompt signatures '{}': {}", signatures_path.string(), e.what());
+            return false;
+        }
+    }
+
+    std::vector<std::string_view> classify_prompt(const std::string_view text)
+    {
+        CachedClassifier& cache = cached_classifier;
+        const uint64_t generation = classifier_generation.load(std::memory_order_acquire);
+        if (cache.generation != generation)
+        {
+            cache.classifier = active_classifier.load();
+            cache.generation = generation;
+        }
+        cache.tags.clear();
+        if (!cache.classifier)
+        {
+            return {};
+        }
+
+        for (uint64_t matched = cache.classifier->scan(text); matched != 0; matched &= matched - 1)
+        {
+            cache.tags.push_back(cache.classifier->category(static_cast<size_t>(std::countr_zero(matched))));
+        }
+        return cache.tags;
+    }
+} // namespace honeypot::utils
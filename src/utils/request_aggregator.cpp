@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <chrono>
+#include <string_view>
+#include <utility>
+
+#include <fmt/chrono.h>
+#include <fmt/core.h>
+
+#include "utils/hash.hpp"
+#include "utils/request_aggregator.hpp"
+#include "utils/signals.hpp"
+
+namespace honeypot::utils
+{
+    namespace
+    {
+        std::string format_timestamp(const RequestAggregator::Clock::time_point time)
+        {
+            const auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(
+                time.time_since_epoch()).count() % 1000;
+            return fmt::format("{:%Y-%m-%dT%H:%M:%S}.{:03}Z",
+                               fmt::gmtime(RequestAggregator::Clock::to_time_t(time)), millis);
+        }
+
+        // Hashes one field followed by a separator, so adjacent fields cannot run into each other.
+        uint64_t hash_field(const std::string_view field, const uint64_t seed)
+        {
+            return fnv1a_64(std::string_view("\xff", 1), fnv1a_64(field, seed));
+        }
+    }
+
+    RequestAggregator::RequestAggregator(const std::chrono::seconds window, Emit emit)
+        : window_(window),
+          emit_(std::move(emit))
+    {
+        // init_logging() may run before main() masks the process; SIGHUP must never land here.
+        flusher_ = std::thread([this] {
+            block_listener_signals();
+            run();
+        });
+    }
+
+    RequestAggregator::~RequestAggregator()
+    {
+        {
+            std::scoped_lock lock(flusher_mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        flusher_.join();
+        flush(true);
+    }
+
+    uint64_t RequestAggregator::fingerprint(const crow::request& req, const int status)
+    {
+        uint64_t hash = hash_field(req.remote_ip_address, fnv1a_offset_basis);
+        hash = hash_field(crow::method_name(req.method), hash);
+        hash = hash_field(req.raw_url, hash);
+
+        // Order-independent: the header map's iteration order is not part of the request.
+        uint64_t headers_hash = 0;
+        for (const auto& [name, value] : req.headers)
+        {
+            headers_hash += hash_field(value, hash_field(name, fnv1a_offset_basis));
+        }
+        hash = hash_field(std::string_view(reinterpret_cast<const char*>(&headers_hash), sizeof(headers_hash)), hash);
+        hash = hash_field(req.body, hash);
+        return hash_field(std::string_view(reinterpret_cast<const char*>(&status), sizeof(status)), hash);
+    }
+
+    RequestAggregator::ThreadTable& RequestAggregator::local_table()
+    {
+        thread_local ThreadTable* table = nullptr;
+        thread_local const RequestAggregator* owner = nullptr;
+        if (owner != this)
+        {
+            auto created = std::make_unique<ThreadTable>();
+            table = created.get();
+            owner = this;
+            std::scoped_lock lock(tables_mutex_);
+            tables_.push_back(std::move(created));
+        }
+        return *table;
+    }
+
+    bool RequestAggregator::count_repeat(const uint64_t fingerprint, const Clock::time_point now)
+    {
+        ThreadTable& table = local_table();
+        std::scoped_lock lock(table.mutex);
+        const auto it = table.entries.find(fingerprint);
+        if (it == table.entries.end())
+        {
+            return false;
+        }
+        Entry& entry = it.value();
+        ++entry.count;
+        entry.last_seen = now;
+        return true;
+    }
+
+    void RequestAggregator::open_window(const uint64_t fingerprint, const Clock::time_point now,
+                                        nlohmann::json record)
+    {
+        Entry entry{std::move(record), now, now, 1};
+        {
+            ThreadTable& table = local_table();
+            std::scoped_lock lock(table.mutex);
+            if (table.entries.size() < max_entries_per_thread)
+            {
+                table.entries.emplace(fingerprint, std::move(entry));
+                return;
+            }
+        }
+        emit(entry);
+    }
+
+    void RequestAggregator::emit(Entry& entry) const
+    {
+        entry.record["count"] = entry.count;
+        entry.record["first_seen"] = format_timestamp(entry.first_seen);
+        entry.record["last_seen"] = format_timestamp(entry.last_seen);
+        emit_(entry.record);
+    }
+
+    void RequestAggregator::flush(const bool everything)
+    {
+        std::vector<ThreadTable*> tables;
+        {
+            std::scoped_lock lock(tables_mutex_);
+            tables.reserve(tables_.size());
+            for (const auto& table : tables_)
+            {
+                tables.push_back(table.get());
+            }
+        }
+
+        const auto now = Clock::now();
+        tsl::robin_map<uint64_t, Entry> closed;
+        for (ThreadTable* table : tables)
+        {
+            std::scoped_lock lock(table->mutex);
+            for (auto it = table->entries.begin(); it != table->entries.end();)
+            {
+                if (!everything && now - it->second.first_seen < window_)
+                {
+                    ++it;
+                    continue;
+                }
+
+                Entry& entry = it.value();
+                if (const auto merged = closed.find(it->first); merged != closed.end())
+                {
+                    Entry& into = merged.value();
+                    if (entry.first_seen < into.first_seen)
+                    {
+                        into.record = std::move(entry.record);
+                    }
+                    into.count += entry.count;
+                    into.first_seen = std::min(into.first_seen, entry.first_seen);
+                    into.last_seen = std::max(into.last_seen, entry.last_seen);
+                }
+                else
+                {
+                    closed.emplace(it->first, std::move(entry));
+                }
+                it = table->entries.erase(it);
+            }
+        }
+
+        std::vector<Entry*> ordered;
+        ordered.reserve(closed.size());
+        for (auto it = closed.begin(); it != closed.end(); ++it)
+        {
+            ordered.push_back(&it.value());
+        }
+        std::ranges::sort(ordered, {}, &Entry::first_seen);
+        for (Entry* entry : ordered)
+        {
+            emit(*entry);
+        }
+    }
+
+    void RequestAggregator::run()
+    {
+        const auto interval = std::min<std::chrono::seconds>(window_, std::chrono::seconds(1));
+        std::unique_lock lock(flusher_mutex_);
+        while (!wake_.wait_for(lock, interval, [this] { return stopping_; }))
+        {
+            lock.unlock();
+            flush(false);
+            lock.lock();
+        }
+    }
+} // namespace honeypot::utils
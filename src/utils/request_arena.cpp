@@ -0,0 +1,109 @@
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+#include "utils/request_arena.hpp"
+
+namespace honeypot::utils
+{
+    namespace
+    {
+        // Covers parsing a typical request body plus its log record; larger requests spill to the heap.
+        constexpr size_t initial_block_bytes = 64 * 1024;
+
+#ifndef NDEBUG
+        /**
+         * Counts live allocations so releasing the arena can assert none outlive their scope
+         * (or were allocated elsewhere and freed here).
+         */
+        class CheckedResource final : public std::pmr::memory_resource
+        {
+        public:
+            explicit CheckedResource(std::pmr::memory_resource& upstream)
+                : upstream_(upstream)
+            {
+            }
+
+            long live() const { return live_; }
+
+        private:
+            void* do_allocate(const size_t bytes, const size_t alignment) override
+            {
+                void* p = upstream_.allocate(bytes, alignment);
+                ++live_;
+                return p;
+            }
+
+            void do_deallocate(void* p, const size_t bytes, const size_t alignment) override
+            {
+                --live_;
+                upstream_.deallocate(p, bytes, alignment);
+            }
+
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+            {
+                return this == &other;
+            }
+
+            std::pmr::memory_resource& upstream_;
+            long live_ = 0;
+        };
+#endif
+
+        struct ThreadArena
+        {
+            std::unique_ptr<std::byte[]> block = std::make_unique<std::byte[]>(initial_block_bytes);
+            std::pmr::monotonic_buffer_resource resource{block.get(), initial_block_bytes,
+                                                         std::pmr::new_delete_resource()};
+#ifndef NDEBUG
+            CheckedResource checked{resource};
+#endif
+            unsigned depth = 0;
+
+            std::pmr::memory_resource* handed_out()
+            {
+#ifndef NDEBUG
+                return &checked;
+#else
+                return &resource;
+#endif
+            }
+        };
+
+        ThreadArena& thread_arena()
+        {
+            thread_local ThreadArena arena;
+            return arena;
+        }
+
+        thread_local std::pmr::memory_resource* active_resource = nullptr;
+    }
+
+    ArenaScope::ArenaScope()
+    {
+        ThreadArena& arena = thread_arena();
+        if (arena.depth++ == 0)
+        {
+            active_resource = arena.handed_out();
+        }
+    }
+
+    ArenaScope::~ArenaScope()
+    {
+        ThreadArena& arena = thread_arena();
+        if (--arena.depth == 0)
+        {
+            active_resource = nullptr;
+#ifndef NDEBUG
+            assert(arena.checked.live() == 0 && "arena allocation outlived its ArenaScope");
+#endif
+            arena.resource.release(); // back to the first block, which is kept
+        }
+    }
+
+    std::pmr::memory_resource* arena_resource() noexcept
+    {
+        return active_resource != nullptr ? active_resource : std::pmr::new_delete_resource();
+    }
+} // namespace honeypot::utils
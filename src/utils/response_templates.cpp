@@ -0,0 +1,396 @@
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fmt/core.h>
+#include <fmt/chrono.h>
+#include <nlohmann/json.hpp>
+
+#include "utils/response_templates.hpp"
+#include "utils/config.hpp"
+#include "utils/logging.hpp"
+
+namespace fs = std::filesystem;
+
+namespace honeypot::utils::fake_data
+{
+    namespace
+    {
+        constexpr uint32_t default_prompt_echo_bytes = 80;
+        constexpr uint32_t max_prompt_echo_bytes = 4096;
+        constexpr uint32_t max_time_bytes = 32;
+
+        std::atomic<std::shared_ptr<const TemplateSet>> active_templates;
+        fs::path template_directory;
+
+        std::minstd_rand& template_rng()
+        {
+            thread_local std::minstd_rand rng{std::random_device{}()};
+            return rng;
+        }
+
+        /**
+         * Cuts the prompt to at most @p max_bytes without splitting a UTF-8 sequence.
+         */
+        std::string_view prompt_fragment(std::string_view prompt, const uint32_t max_bytes)
+        {
+            while (!prompt.empty() && std::isspace(static_cast<unsigned char>(prompt.front())))
+            {
+                prompt.remove_prefix(1);
+            }
+            if (prompt.size() > max_bytes)
+            {
+                size_t cut = max_bytes;
+                while (cut > 0 && (static_cast<unsigned char>(prompt[cut]) & 0xC0) == 0x80)
+                {
+                    --cut;
+                }
+                prompt = prompt.substr(0, cut);
+            }
+            while (!prompt.empty() && std::isspace(static_cast<unsigned char>(prompt.back())))
+            {
+                prompt.remove_suffix(1);
+            }
+            return prompt;
+        }
+    }
+
+    uint32_t TemplateSet::intern(const std::string_view text)
+    {
+        const auto offset = static_cast<uint32_t>(arena_.size());
+        arena_.append(text);
+        return offset;
+    }
+
+    uint32_t TemplateSet::compile(const std::string_view source)
+    {
+        CompiledTemplate compiled{};
+        compiled.first_op = static_cast<uint32_t>(ops_.size());
+
+        std::string pending_literal;
+        const auto flush_literal = [&] {
+            if (pending_literal.empty())
+            {
+                return;
+            }
+            const auto length = static_cast<uint32_t>(pending_literal.size());
+            ops_.push_back({OpCode::literal, intern(pending_literal), length});
+            compiled.static_bytes += length;
+            pending_literal.clear();
+        };
+
+        size_t pos = 0;
+        while (pos < source.size())
+        {
+            const size_t open = source.find("{{", pos);
+            if (open == std::string_view::npos)
+            {
+                pending_literal.append(source.substr(pos));
+                break;
+            }
+            pending_literal.append(source.substr(pos, open - pos));
+
+            const size_t close = source.find("}}", open + 2);
+            if (close == std::string_view::npos)
+            {
+                throw std::runtime_error(fmt::format("unterminated placeholder in template '{}'", source));
+            }
+            const std::string_view inner = source.substr(open + 2, close - open - 2);
+            pos = close + 2;
+
+            if (inner == "model")
+            {
+                flush_literal();
+                ops_.push_back({OpCode::model, 0, 0});
+                ++compiled.model_refs;
+            }
+            else if (inner == "prompt" || inner.starts_with("prompt:"))
+            {
+                uint32_t max_bytes = default_prompt_echo_bytes;
+                if (inner.size() > 7)
+                {
+                    const std::string_view digits = inner.substr(7);
+                    const auto [ptr, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), max_bytes);
+                    if (ec != std::errc{} || ptr != digits.data() + digits.size())
+                    {
+                        throw std::runtime_error(fmt::format("invalid prompt length in placeholder '{{{{{}}}}}'",
+                                                             inner));
+                    }
+                    max_bytes = std::min(max_bytes, max_prompt_echo_bytes);
+                }
+                flush_literal();
+                ops_.push_back({OpCode::prompt, max_bytes, 0});
+                compiled.prompt_bytes += max_bytes;
+            }
+            else if (inner == "timestamp" || inner == "date")
+            {
+                flush_literal();
+                ops_.push_back({inner == "date" ? OpCode::date : OpCode::timestamp, 0, 0});
+                ++compiled.time_refs;
+            }
+            else if (inner.starts_with("pick:"))
+            {
+                flush_literal();
+                const auto first_choice = static_cast<uint32_t>(choices_.size());
+                uint32_t longest = 0;
+                std::string_view rest = inner.substr(5);
+                while (true)
+                {
+                    const size_t bar = rest.find('|');
+                    const std::string_view choice = rest.substr(0, bar);
+                    const auto length = static_cast<uint32_t>(choice.size());
+                    choices_.push_back({intern(choice), length});
+                    longest = std::max(longest, length);
+                    if (bar == std::string_view::npos)
+                    {
+                        break;
+                    }
+                    rest.remove_prefix(bar + 1);
+                }
+                ops_.push_back({OpCode::pick, first_choice, static_cast<uint32_t>(choices_.size()) - first_choice});
+                compiled.static_bytes += longest;
+            }
+            else
+            {
+                pending_literal.append(source.substr(open, close + 2 - open));
+            }
+        }
+        flush_literal();
+
+        compiled.op_count = static_cast<uint32_t>(ops_.size()) - compiled.first_op;
+        templates_.push_back(compiled);
+        return static_cast<uint32_t>(templates_.size() - 1);
+    }
+
+    void TemplateSet::add_persona_from_json(const std::string& file_name, const std::string& text)
+    {
+        const nlohmann::ordered_json persona_json = nlohmann::ordered_json::parse(text);
+
+        Persona persona;
+        for (const auto& [key, target] : {std::pair{"generate", &persona.generate}, std::pair{"chat", &persona.chat}})
+        {
+            if (!persona_json.contains(key))
+            {
+                continue;
+            }
+            for (const auto& source : persona_json.at(key))
+            {
+                target->push_back(compile(source.get<std::string>()));
+            }
+        }
+
+        const auto models = persona_json.value("models", std::vector<std::string>{});
+        if (models.empty())
+        {
+            throw std::runtime_error(fmt::format("template file '{}' lists no models", file_name));
+        }
+        for (const auto& model : models)
+        {
+            Persona& slot = model == "*" ? fallback_ : personas_[model];
+            slot.generate.insert(slot.generate.end(), persona.generate.begin(), persona.generate.end());
+            slot.chat.insert(slot.chat.end(), persona.chat.begin(), persona.chat.end());
+        }
+    }
+
+    std::shared_ptr<const TemplateSet> TemplateSet::load_directory(const std::string& directory)
+    {
+        std::vector<fs::path> files;
+        for (const auto& entry : fs::directory_iterator(directory))
+        {
+            if (entry.is_regular_file() && entry.path().extension() == ".json")
+            {
+                files.push_back(entry.path());
+            }
+        }
+        std::ranges::sort(files);
+
+        auto set = std::make_shared<TemplateSet>();
+        for (const auto& file : files)
+        {
+            std::ifstream in(file, std::ios::binary);
+            if (!in.is_open())
+            {
+                throw std::runtime_error(fmt::format("failed to open template file '{}'", file.string()));
+            }
+            const std::string text{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+            try
+            {
+                set->add_persona_from_json(file.string(), text);
+            }
+            catch (const nlohmann::json::exception& e)
+            {
+                throw std::runtime_error(fmt::format("template file '{}': {}", file.string(), e.what()));
+            }
+        }
+
+        if (set->templates_.empty())
+        {
+            throw std::runtime_error(fmt::format("no templates found in '{}'", directory));
+        }
+        return set;
+    }
+
+    std::shared_ptr<const TemplateSet> TemplateSet::builtin()
+    {
+        static const std::shared_ptr<const TemplateSet> builtin_set = [] {
+            auto set = std::make_shared<TemplateSet>();
+            set->fallback_.generate = {
+                set->compile("{{pick:Sure|Certainly|Of course}}! Here is a short answer to \"{{prompt:60}}\": "
+                    "it depends on the context, but in most cases the simplest approach is the right one."),
+                set->compile("I'm not completely sure what you mean by \"{{prompt:60}}\". "
+                    "Could you give me a bit more detail about what you are trying to achieve?"),
+            };
+            set->fallback_.chat = {
+                set->compile("{{pick:Hello|Hi there|Hey}}! {{pick:Happy to help.|Glad you asked.}} "
+                    "Regarding \"{{prompt:60}}\", could you tell me a little more about your goal?"),
+                set->compile("That's a good question. The short answer is that it depends, "
+                    "but I can walk you through the main options if you'd like."),
+            };
+            return set;
+        }();
+        return builtin_set;
+    }
+
+    const TemplateSet::Persona* TemplateSet::find_persona(const std::string_view model) const
+    {
+        const auto it = personas_.find(model);
+        return it != personas_.end() ? &it->second : &fallback_;
+    }
+
+    bool TemplateSet::render(const TemplateKind kind, const std::string_view model, const std::string_view prompt,
+                             std::string& out) const
+    {
+        const auto pick_ids = [kind](const Persona& persona) -> const std::vector<uint32_t>& {
+            return kind == TemplateKind::generate ? persona.generate : persona.chat;
+        };
+
+        const std::vector<uint32_t>* candidates = &pick_ids(*find_persona(model));
+        if (candidates->empty())
+        {
+            candidates = &pick_ids(fallback_);
+        }
+        out.clear();
+        if (candidates->empty())
+        {
+            return false;
+        }
+
+        auto& rng = template_rng();
+        const CompiledTemplate& compiled = templates_[(*candidates)[rng() % candidates->size()]];
+
+        out.reserve(compiled.static_bytes + compiled.prompt_bytes
+                    + compiled.model_refs * model.size() + compiled.time_refs * max_time_bytes);
+
+        std::tm now_tm{};
+        if (compiled.time_refs > 0)
+        {
+            now_tm = fmt::gmtime(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()));
+        }
+
+        const Op* op = ops_.data() + compiled.first_op;
+        const Op* const end = op + compiled.op_count;
+        for (; op != end; ++op)
+        {
+            switch (op->code)
+            {
+                case OpCode::literal:
+                    out.append(arena_.data() + op->a, op->b);
+                    break;
+                case OpCode::model:
+                    out.append(model);
+                    break;
+                case OpCode::prompt:
+                    // Line breaks are flattened so an echoed prompt stays inside its sentence.
+                    for (const char c : prompt_fragment(prompt, op->a))
+                    {
+                        out.push_back(c == '\n' || c == '\r' ? ' ' : c);
+                    }
+                    break;
+                case OpCode::timestamp:
+                    fmt::format_to(std::back_inserter(out), "{:%Y-%m-%dT%H:%M:%S}Z", now_tm);
+                    break;
+                case OpCode::date:
+                    fmt::format_to(std::back_inserter(out), "{:%Y-%m-%d}", now_tm);
+                    break;
+                case OpCode::pick:
+                {
+                    const Span& choice = choices_[op->a + rng() % op->b];
+                    out.append(arena_.data() + choice.offset, choice.length);
+                    break;
+                }
+            }
+        }
+        return true;
+    }
+
+    void init_response_templates(const config::HoneypotConfig& config)
+    {
+        const auto logger = get_operational_logger();
+        const std::string& configured_dir = config.api_behavior.response_template_dir;
+
+        active_templates.store(TemplateSet::builtin());
+        if (configured_dir.empty())
+        {
+            logger->info("No 'response_template_dir' configured, using built-in response templates.");
+            return;
+        }
+
+        template_directory = fs::path("config") / configured_dir;
+        if (!reload_response_templates())
+        {
+            logger->warn("Falling back to built-in response templates.");
+        }
+    }
+
+    bool reload_response_templates()
+    {
+        const auto logger = get_operational_logger();
+        if (template_directory.empty())
+        {
+            logger->info("Response template reload requested but no template directory is configured.");
+            return false;
+        }
+
+        try
+        {
+            auto loaded = TemplateSet::load_directory(template_directory.string());
+            logger->info("Loaded {} response templates from '{}'.", loaded->template_count(),
+                         template_directory.string());
+            active_templates.store(std::move(loaded));
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            logger->error("Failed to load response templates from '{}': {}", template_directory.string(), e.what());
+            return false;
+        }
+    }
+
+    std::shared_ptr<const TemplateSet> get_response_templates()
+    {
+        return active_templates.load();
+    }
+
+    std::string_view generate_response_text(const TemplateKind kind, const std::string_view model,
+                                            const std::string_view prompt)
+    {
+        thread_local std::string buffer;
+
+        const auto templates = active_templates.load();
+        if (!templates || !templates->render(kind, model, prompt, buffer))
+        {
+            buffer.clear();
+        }
+        return buffer;
+    }
+} // namespace honeypot::utils::fake_data
@@ -0,0 +1,87 @@
+#include <functional>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <ranges>
+
+#ifndef _WIN32
+#include <csignal>
+#include <pthread.h>
+#endif
+
+#include "utils/signals.hpp"
+#include "utils/logging.hpp"
+
+namespace honeypot::utils
+{
+    namespace
+    {
+        std::vector<std::pair<int, std::function<void()>>> signal_handlers;
+
+#ifndef _WIN32
+        sigset_t listener_signals()
+        {
+            sigset_t signal_set;
+            sigemptyset(&signal_set);
+            sigaddset(&signal_set, SIGHUP);
+            sigaddset(&signal_set, SIGUSR2);
+            return signal_set;
+        }
+#endif
+    }
+
+    void block_listener_signals()
+    {
+#ifndef _WIN32
+        const sigset_t signal_set = listener_signals();
+        pthread_sigmask(SIG_BLOCK, &signal_set, nullptr);
+#endif
+    }
+
+    void on_signal(const int signum, std::function<void()> handler)
+    {
+        signal_handlers.emplace_back(signum, std::move(handler));
+    }
+
+    void start_signal_listener()
+    {
+#ifndef _WIN32
+        // Listener signals without a handler (SIGUSR2 with tracing off) are still taken here and dropped.
+        sigset_t signal_set = listener_signals();
+        for (const auto& signum : signal_handlers | std::views::keys)
+        {
+            sigaddset(&signal_set, signum);
+        }
+        pthread_sigmask(SIG_BLOCK, &signal_set, nullptr);
+
+        std::thread([signal_set] {
+            while (true)
+            {
+                int signum = 0;
+                if (sigwait(&signal_set, &signum) != 0)
+                {
+                    continue;
+                }
+
+                const auto logger = get_operational_logger();
+                logger->info("Received signal {}, running handlers.", signum);
+                for (const auto& [registered, handler] : signal_handlers)
+                {
+                    if (registered != signum)
+                    {
+                        continue;
+                    }
+                    try
+                    {
+                        handler();
+                    }
+                    catch (const std::exception& e)
+                    {
+                        logger->error("Signal {} handler failed: {}", signum, e.what());
+                    }
+                }
+            }
+        }).detach();
+#endif
+    }
+} // namespace honeypot::utils
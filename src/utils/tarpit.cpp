@@ -0,0 +1,213 @@
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <asio.hpp>
+
+#include "utils/tarpit.hpp"
+#include "utils/logging.hpp"
+#include "utils/timer_wheel.hpp"
+
+namespace honeypot::utils
+{
+    namespace
+    {
+        std::unique_ptr<Tarpit> tarpit;
+
+        // Held coroutines wake this often to notice connections that went away.
+        constexpr std::chrono::milliseconds hold_step{5000};
+
+        struct HeldSlot
+        {
+            std::atomic<size_t>& held;
+            ~HeldSlot() { held.fetch_sub(1, std::memory_order_relaxed); }
+        };
+
+        asio::awaitable<void> hold_response(crow::response& res, crow::response ready,
+                                            std::chrono::milliseconds remaining, std::atomic<size_t>& held)
+        {
+            HeldSlot slot{held};
+            auto& wheel = get_timer_wheel();
+            while (remaining.count() > 0 && res.is_alive())
+            {
+                const auto step = std::min(remaining, hold_step);
+                co_await wheel.async_wait(step, asio::use_awaitable);
+                remaining -= step;
+            }
+            res = std::move(ready);
+            res.end();
+        }
+    }
+
+    Tarpit::Tarpit(const config::TarpitConfig& config)
+        : config_(config)
+    {
+    }
+
+    Tarpit::Shard& Tarpit::shard_for(const std::string_view source_ip)
+    {
+        return shards_[TransparentStringHash{}(source_ip) % shard_count];
+    }
+
+    void Tarpit::make_room(Shard& shard, const Clock::time_point now) const
+    {
+        // Oldest first: idle sources go, active ones get another round. After max_eviction_checks the
+        // oldest unflagged source goes regardless, and after twice that any source, so a new source
+        // costs a bounded number of steps and never a scan. Flagged sources are kept longest, so a
+        // flood of fresh addresses does not wash out the ones already held.
+        const auto window = std::chrono::seconds(config_.window_seconds);
+        for (size_t checked = 0; shard.sources.size() >= max_sources_per_shard && !shard.arrival.empty(); ++checked)
+        {
+            std::string source = std::move(shard.arrival.front());
+            shard.arrival.pop_front();
+            const auto it = shard.sources.find(source);
+            if (it == shard.sources.end())
+            {
+                continue;
+            }
+            const SourceScore& score = it->second;
+            const bool flagged = score.flagged_until > now;
+            const bool idle = !flagged && now - score.window_start >= window;
+            if (idle || (!flagged && checked >= max_eviction_checks) || checked >= 2 * max_eviction_checks)
+            {
+                shard.sources.erase(it);
+            }
+            else
+            {
+                shard.arrival.push_back(std::move(source));
+            }
+        }
+    }
+
+    Tarpit::SourceScore& Tarpit::score_for(Shard& shard, const std::string_view source_ip,
+                                           const Clock::time_point now)
+    {
+        auto it = shard.sources.find(source_ip);
+        if (it == shard.sources.end())
+        {
+            make_room(shard, now);
+            it = shard.sources.emplace(std::string(source_ip), SourceScore{now}).first;
+            shard.arrival.emplace_back(source_ip);
+        }
+        return it.value();
+    }
+
+    std::chrono::milliseconds Tarpit::hold_for(const SourceScore& score) const
+    {
+        const uint32_t doublings = std::min<uint32_t>(score.offences > 0 ? score.offences - 1 : 0, 16);
+        const uint64_t hold = static_cast<uint64_t>(config_.initial_hold_ms) << doublings;
+        return std::chrono::milliseconds(std::min<uint64_t>(hold, config_.max_hold_ms));
+    }
+
+    std::chrono::milliseconds Tarpit::observe(const std::string_view source_ip)
+    {
+        if (!config_.enabled || source_ip.empty())
+        {
+            return std::chrono::milliseconds::zero();
+        }
+
+        const auto now = Clock::now();
+        Shard& shard = shard_for(source_ip);
+        std::scoped_lock lock(shard.mutex);
+        SourceScore& score = score_for(shard, source_ip, now);
+
+        if (now - score.window_start >= std::chrono::seconds(config_.window_seconds))
+        {
+            score.window_start = now;
+            score.window_requests = 0;
+        }
+        ++score.window_requests;
+
+        if (score.window_requests > config_.max_requests_per_window)
+        {
+            if (score.window_requests == config_.max_requests_per_window + 1)
+            {
+                ++score.offences;
+                get_operational_logger()->info("Tarpitting {}: exceeded {} requests in {}s (offence {}).",
+                                               source_ip, config_.max_requests_per_window,
+                                               config_.window_seconds, score.offences);
+            }
+            score.flagged_until = now + std::chrono::seconds(config_.flag_seconds);
+        }
+
+        return score.flagged_until > now ? hold_for(score) : std::chrono::milliseconds::zero();
+    }
+
+    void Tarpit::flag(const std::string_view source_ip, const std::string_view reason)
+    {
+        if (!config_.enabled || source_ip.empty())
+        {
+            return;
+        }
+
+        const auto now = Clock::now();
+        Shard& shard = shard_for(source_ip);
+        std::scoped_lock lock(shard.mutex);
+        SourceScore& score = score_for(shard, source_ip, now);
+        if (score.flagged_until <= now)
+        {
+            ++score.offences;
+            get_operational_logger()->info("Tarpitting {}: {} (offence {}).", source_ip, reason, score.offences);
+        }
+        score.flagged_until = now + std::chrono::seconds(config_.flag_seconds);
+    }
+
+    bool Tarpit::is_flagged(const std::string_view source_ip)
+    {
+        if (!config_.enabled || source_ip.empty())
+        {
+            return false;
+        }
+
+        Shard& shard = shard_for(source_ip);
+        std::scoped_lock lock(shard.mutex);
+        const auto it = shard.sources.find(source_ip);
+        return it != shard.sources.end() && it->second.flagged_until > Clock::now();
+    }
+
+    void Tarpit::complete(const crow::request& req, crow::response& res, crow::response ready,
+                          const std::chrono::milliseconds hold)
+    {
+        bool reserved = false;
+        if (hold.count() > 0 && req.io_context != nullptr)
+        {
+            reserved = held_.fetch_add(1, std::memory_order_relaxed) < config_.max_held_connections;
+            if (!reserved)
+            {
+                held_.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+        if (!reserved)
+        {
+            res = std::move(ready);
+            res.end();
+            return;
+        }
+
+        asio::co_spawn(*req.io_context, hold_response(res, std::move(ready), hold, held_), asio::detached);
+    }
+
+    void init_tarpit(const config::HoneypotConfig& config)
+    {
+        tarpit = std::make_unique<Tarpit>(config.tarpit);
+        if (config.tarpit.enabled)
+        {
+            get_operational_logger()->info(
+                "Tarpit enabled: >{} requests per {}s flags a source, holds {}-{} ms, at most {} held connections.",
+                config.tarpit.max_requests_per_window, config.tarpit.window_seconds, config.tarpit.initial_hold_ms,
+                config.tarpit.max_hold_ms, config.tarpit.max_held_connections);
+        }
+    }
+
+    Tarpit& get_tarpit()
+    {
+        if (!tarpit)
+        {
+            static Tarpit disabled{config::TarpitConfig{.enabled = false}};
+            return disabled;
+        }
+        return *tarpit;
+    }
+} // namespace honeypot::utils
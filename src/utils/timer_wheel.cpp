@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <utility>
+
+#include "utils/timer_wheel.hpp"
+#include "utils/logging.hpp"
+
+namespace honeypot::utils
+{
+    TimerWheel::TimerWheel(const Clock::duration tick)
+        : tick_(tick),
+          epoch_(Clock::now()),
+          ticker_(io_context_),
+          work_(asio::make_work_guard(io_context_))
+    {
+        thread_ = std::thread([this] {
+            io_context_.run();
+        });
+    }
+
+    TimerWheel::~TimerWheel()
+    {
+        work_.reset();
+        io_context_.stop();
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+    }
+
+    void TimerWheel::schedule(const Clock::duration delay, Callback callback)
+    {
+        constexpr uint64_t max_delay_ticks = (uint64_t{1} << (slot_bits * level_count)) - 1;
+        const auto ticks = (std::max(delay, Clock::duration::zero()) + tick_ - Clock::duration(1)) / tick_;
+        const uint64_t delay_ticks = std::clamp<uint64_t>(static_cast<uint64_t>(ticks), 1, max_delay_ticks);
+
+        bool needs_arm = false;
+        {
+            std::scoped_lock lock(mutex_);
+            const uint64_t now = now_tick();
+            if (pending_ == 0)
+            {
+                current_tick_ = std::max(current_tick_, now); // empty wheel, safe to jump ahead
+            }
+
+            Entry* entry = free_list_;
+            if (entry != nullptr)
+            {
+                free_list_ = entry->next;
+            }
+            else
+            {
+                entry = &storage_.emplace_back();
+            }
+            // The current tick is partly elapsed, so round up to never fire early.
+            entry->expiry_tick = std::max(current_tick_, now) + delay_ticks + 1;
+            entry->callback = std::move(callback);
+            insert(entry);
+            ++pending_;
+
+            needs_arm = !armed_;
+            armed_ = true;
+        }
+
+        if (needs_arm)
+        {
+            asio::post(io_context_, [this] { arm(); });
+        }
+    }
+
+    void TimerWheel::post_after(asio::io_context& io_context, const Clock::duration delay, Callback callback)
+    {
+        schedule(delay, [&io_context, callback = std::move(callback)]() mutable {
+            asio::post(io_context, std::move(callback));
+        });
+    }
+
+    size_t TimerWheel::pending() const
+    {
+        std::scoped_lock lock(mutex_);
+        return pending_;
+    }
+
+    uint64_t TimerWheel::now_tick() const
+    {
+        return static_cast<uint64_t>((Clock::now() - epoch_) / tick_);
+    }
+
+    void TimerWheel::insert(Entry* entry)
+    {
+        const uint64_t expiry = std::max(entry->expiry_tick, current_tick_);
+        const uint64_t delta = expiry - current_tick_;
+
+        size_t level = 0;
+        while (level + 1 < level_count && delta >= (uint64_t{1} << (slot_bits * (level + 1))))
+        {
+            ++level;
+        }
+        auto& head = slots_[level][(expiry >> (slot_bits * level)) & (slot_count - 1)];
+        entry->next = head;
+        head = entry;
+    }
+
+    void TimerWheel::advance(std::vector<Callback>& due)
+    {
+        ++current_tick_;
+
+        // At each level's window boundary, redistribute that window's slot into the levels below.
+        for (size_t level = 1; level < level_count; ++level)
+        {
+            const unsigned shift = slot_bits * level;
+            if ((current_tick_ & ((uint64_t{1} << shift) - 1)) != 0)
+            {
+                break;
+            }
+            Entry* list = std::exchange(slots_[level][(current_tick_ >> shift) & (slot_count - 1)], nullptr);
+            while (list != nullptr)
+            {
+                Entry* next = list->next;
+                insert(list);
+                list = next;
+            }
+        }
+
+        Entry* list = std::exchange(slots_[0][current_tick_ & (slot_count - 1)], nullptr);
+        while (list != nullptr)
+        {
+            Entry* next = list->next;
+            due.push_back(std::move(list->callback));
+            list->callback = nullptr;
+            list->next = free_list_;
+            free_list_ = list;
+            --pending_;
+            list = next;
+        }
+    }
+
+    void TimerWheel::arm()
+    {
+        Clock::time_point deadline;
+        {
+            std::scoped_lock lock(mutex_);
+            deadline = epoch_ + tick_ * static_cast<Clock::rep>(current_tick_ + 1);
+        }
+        ticker_.expires_at(deadline);
+        ticker_.async_wait([this](const asio::error_code& ec) { on_tick(ec); });
+    }
+
+    void TimerWheel::on_tick(const asio::error_code& ec)
+    {
+        if (ec)
+        {
+            return;
+        }
+
+        bool keep_running = false;
+        {
+            std::scoped_lock lock(mutex_);
+            const uint64_t target = now_tick();
+            while (current_tick_ < target && pending_ > 0)
+            {
+                advance(due_);
+            }
+            current_tick_ = std::max(current_tick_, target);
+            keep_running = pending_ > 0;
+            armed_ = keep_running;
+        }
+
+        for (auto& callback : due_)
+        {
+            try
+            {
+                callback();
+            }
+            catch (const std::exception& e)
+            {
+                get_operational_logger()->error("Timer callback threw: {}", e.what());
+            }
+        }
+        due_.clear();
+
+        if (keep_running)
+        {
+            arm();
+        }
+    }
+
+    TimerWheel& get_timer_wheel()
+    {
+        static TimerWheel wheel;
+        return wheel;
+    }
+} // namespace honeypot::utils
@@ -0,0 +1,403 @@
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "utils/tokenizer.hpp"
+
+namespace honeypot::utils
+{
+    namespace
+    {
+        constexpr uint32_t unknown_token = std::numeric_limits<uint32_t>::max();
+        constexpr size_t max_word_bytes = 256; // longer runs are encoded in slices to bound merge cost
+
+        void append_utf8(std::string& out, const uint32_t codepoint)
+        {
+            if (codepoint < 0x80)
+            {
+                out.push_back(static_cast<char>(codepoint));
+            }
+            else if (codepoint < 0x800)
+            {
+                out.push_back(static_cast<char>(0xC0 | (codepoint >> 6)));
+                out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+            }
+            else
+            {
+                out.push_back(static_cast<char>(0xE0 | (codepoint >> 12)));
+                out.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+            }
+        }
+
+        /**
+         * GPT-2's reversible byte to printable-codepoint mapping, pre-encoded as UTF-8, which is
+         * how byte-level vocabularies spell their tokens (a leading space becomes "Ġ").
+         */
+        const std::array<std::string, 256>& byte_level_alphabet()
+        {
+            static const std::array<std::string, 256> alphabet = [] {
+                std::array<std::string, 256> table;
+                uint32_t shifted = 0;
+                for (uint32_t b = 0; b < 256; ++b)
+                {
+                    const bool printable = (b >= 33 && b <= 126) || (b >= 161 && b <= 172) || b >= 174;
+                    append_utf8(table[b], printable ? b : 256 + shifted++);
+                }
+                return table;
+            }();
+            return alphabet;
+        }
+
+        // Byte classes approximating the \p{L} / \p{N} / \s classes of the llama3-style split regex.
+        // Non-ASCII bytes count as letters, which keeps multi-byte characters inside words.
+        constexpr bool is_letter(const unsigned char c) { return std::isalpha(c) || c >= 0x80; }
+        constexpr bool is_digit(const unsigned char c) { return c >= '0' && c <= '9'; }
+        constexpr bool is_space(const unsigned char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+        constexpr bool is_newline(const unsigned char c) { return c == '\n' || c == '\r'; }
+        constexpr bool is_symbol(const unsigned char c) { return !is_space(c) && !is_letter(c) && !is_digit(c); }
+
+        /**
+         * Splits text into pre-tokens following
+         * (?i:'s|'t|'re|'ve|'m|'ll|'d)|[^\r\n\p{L}\p{N}]?\p{L}+|\p{N}{1,3}| ?[^\s\p{L}\p{N}]+[\r\n]*|\s*[\r\n]+|\s+(?!\S)|\s+
+         */
+        template <typename Emit>
+        void pretokenize(const std::string_view text, Emit&& emit)
+        {
+            const auto at = [&text](const size_t i) { return static_cast<unsigned char>(text[i]); };
+            const size_t n = text.size();
+            size_t pos = 0;
+
+            while (pos < n)
+            {
+                const size_t start = pos;
+                const unsigned char c = at(pos);
+
+                if (c == '\'' && pos + 1 < n)
+                {
+                    const auto lower = [&](const size_t i) { return i < n ? std::tolower(at(i)) : 0; };
+                    const int c1 = lower(pos + 1);
+                    const int c2 = lower(pos + 2);
+                    size_t length = 0;
+                    if ((c1 == 'r' && c2 == 'e') || (c1 == 'v' && c2 == 'e') || (c1 == 'l' && c2 == 'l'))
+                    {
+                        length = 3;
+                    }
+                    else if (c1 == 's' || c1 == 't' || c1 == 'm' || c1 == 'd')
+                    {
+                        length = 2;
+                    }
+                    if (length > 0)
+                    {
+                        pos += length;
+                        emit(text.substr(start, pos - start));
+                        continue;
+                    }
+                }
+
+                if (is_letter(c) || (!is_digit(c) && !is_newline(c) && pos + 1 < n && is_letter(at(pos + 1))))
+                {
+                    ++pos;
+                    while (pos < n && is_letter(at(pos)))
+                    {
+                        ++pos;
+                    }
+                }
+                else if (is_digit(c))
+                {
+                    while (pos < n && pos - start < 3 && is_digit(at(pos)))
+                    {
+                        ++pos;
+                    }
+                }
+                else if (is_symbol(c) || (c == ' ' && pos + 1 < n && is_symbol(at(pos + 1))))
+                {
+                    ++pos;
+                    while (pos < n && is_symbol(at(pos)))
+                    {
+                        ++pos;
+                    }
+                    while (pos < n && is_newline(at(pos)))
+                    {
+                        ++pos;
+                    }
+                }
+                else
+                {
+                    size_t end = pos;
+                    size_t after_last_newline = 0;
+                    while (end < n && is_space(at(end)))
+                    {
+                        if (is_newline(at(end)))
+                        {
+                            after_last_newline = end + 1;
+                        }
+                        ++end;
+                    }
+
+                    if (after_last_newline != 0)
+                    {
+                        pos = after_last_newline;
+                    }
+                    else if (end < n && end - pos > 1)
+                    {
+                        pos = end - 1; // leave one space to prefix the following word
+                    }
+                    else
+                    {
+                        pos = end;
+                    }
+                }
+
+                emit(text.substr(start, pos - start));
+            }
+        }
+
+        constexpr uint64_t pair_key(const uint32_t left, const uint32_t right)
+        {
+            return (static_cast<uint64_t>(left) << 32) | right;
+        }
+
+        constexpr uint32_t no_symbol = std::numeric_limits<uint32_t>::max();
+
+        // One symbol of a word being merged; merged-away symbols are unlinked and marked unknown_token.
+        struct Symbol
+        {
+            uint32_t id;
+            uint32_t prev;
+            uint32_t next;
+        };
+
+        // A merge of the symbol at left with its successor, valid while both still hold these ids.
+        struct MergeCandidate
+        {
+            uint32_t rank;
+            uint32_t left;
+            uint32_t left_id;
+            uint32_t right_id;
+            uint32_t merged_id;
+        };
+
+        // Min-heap order: lowest rank first, leftmost first among equal ranks.
+        constexpr bool merges_later(const MergeCandidate& a, const MergeCandidate& b)
+        {
+            return a.rank != b.rank ? a.rank > b.rank : a.left > b.left;
+        }
+    }
+
+    struct BpeTokenizer::Scratch
+    {
+        std::string mapped;
+        std::vector<Symbol> symbols;
+        std::vector<MergeCandidate> candidates;
+    };
+
+    BpeTokenizer::Scratch& BpeTokenizer::scratch()
+    {
+        thread_local Scratch instance;
+        return instance;
+    }
+
+    std::shared_ptr<const BpeTokenizer> BpeTokenizer::from_model_info(const nlohmann::ordered_json& model_info)
+    {
+        if (!model_info.is_object() || model_info.value("tokenizer.ggml.model", std::string{}) != "gpt2")
+        {
+            return nullptr;
+        }
+        const auto tokens_it = model_info.find("tokenizer.ggml.tokens");
+        const auto merges_it = model_info.find("tokenizer.ggml.merges");
+        if (tokens_it == model_info.end() || !tokens_it->is_array() || tokens_it->empty()
+            || merges_it == model_info.end() || !merges_it->is_array())
+        {
+            return nullptr;
+        }
+
+        std::shared_ptr<BpeTokenizer> tokenizer(new BpeTokenizer());
+        tokenizer->vocab_size_ = tokens_it->size();
+        tokenizer->vocab_.reserve(tokens_it->size());
+        uint32_t id = 0;
+        for (const auto& token : *tokens_it)
+        {
+            if (token.is_string())
+            {
+                tokenizer->vocab_.emplace(token.get<std::string>(), id);
+            }
+            ++id;
+        }
+
+        const auto& alphabet = byte_level_alphabet();
+        for (size_t b = 0; b < alphabet.size(); ++b)
+        {
+            const auto it = tokenizer->vocab_.find(std::string_view(alphabet[b]));
+            tokenizer->byte_tokens_[b] = it != tokenizer->vocab_.end() ? it->second : unknown_token;
+        }
+
+        tokenizer->merges_.reserve(merges_it->size());
+        std::string merged;
+        uint32_t rank = 0;
+        for (const auto& merge : *merges_it)
+        {
+            const uint32_t this_rank = rank++;
+            if (!merge.is_string())
+            {
+                continue;
+            }
+            const auto& rule = merge.get_ref<const std::string&>();
+            const size_t split = rule.find(' ');
+            if (split == std::string::npos)
+            {
+                continue;
+            }
+            const std::string_view left(rule.data(), split);
+            const std::string_view right(rule.data() + split + 1, rule.size() - split - 1);
+
+            merged.assign(left).append(right);
+            const auto left_it = tokenizer->vocab_.find(left);
+            const auto right_it = tokenizer->vocab_.find(right);
+            const auto merged_it = tokenizer->vocab_.find(std::string_view(merged));
+            if (left_it == tokenizer->vocab_.end() || right_it == tokenizer->vocab_.end()
+                || merged_it == tokenizer->vocab_.end())
+            {
+                continue;
+            }
+            tokenizer->merges_.try_emplace(pair_key(left_it->second, right_it->second),
+                                           MergeEntry{this_rank, merged_it->second});
+        }
+
+        return tokenizer;
+    }
+
+    template <typename Sink>
+    void BpeTokenizer::encode_word(const std::string_view word, Scratch& scratch, Sink&& sink) const
+    {
+        const auto& alphabet = byte_level_alphabet();
+        auto& [mapped, symbols, candidates] = scratch;
+
+        mapped.clear();
+        for (const char c : word)
+        {
+            mapped.append(alphabet[static_cast<unsigned char>(c)]);
+        }
+        if (const auto it = vocab_.find(std::string_view(mapped)); it != vocab_.end())
+        {
+            sink(it->second);
+            return;
+        }
+
+        const auto count = static_cast<uint32_t>(word.size());
+        symbols.clear();
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            symbols.push_back({byte_tokens_[static_cast<unsigned char>(word[i])], i == 0 ? no_symbol : i - 1,
+                               i + 1 == count ? no_symbol : i + 1});
+        }
+
+        candidates.clear();
+        const auto add_candidate = [&](const uint32_t left) {
+            const uint32_t right = symbols[left].next;
+            if (right == no_symbol)
+            {
+                return;
+            }
+            const auto it = merges_.find(pair_key(symbols[left].id, symbols[right].id));
+            if (it == merges_.end())
+            {
+                return;
+            }
+            candidates.push_back({it->second.rank, left, symbols[left].id, symbols[right].id, it->second.merged_id});
+            std::ranges::push_heap(candidates, merges_later);
+        };
+        for (uint32_t i = 0; i + 1 < count; ++i)
+        {
+            add_candidate(i);
+        }
+
+        // Same result as repeatedly merging the lowest-ranked leftmost pair; stale candidates are skipped.
+        while (!candidates.empty())
+        {
+            std::ranges::pop_heap(candidates, merges_later);
+            const MergeCandidate candidate = candidates.back();
+            candidates.pop_back();
+
+            Symbol& left = symbols[candidate.left];
+            if (left.id != candidate.left_id || left.next == no_symbol || symbols[left.next].id != candidate.right_id)
+            {
+                continue;
+            }
+            Symbol& right = symbols[left.next];
+            left.id = candidate.merged_id;
+            left.next = right.next;
+            if (right.next != no_symbol)
+            {
+                symbols[right.next].prev = candidate.left;
+            }
+            right.id = unknown_token;
+
+            if (left.prev != no_symbol)
+            {
+                add_candidate(left.prev);
+            }
+            add_candidate(candidate.left);
+        }
+
+        for (uint32_t i = 0; i != no_symbol; i = symbols[i].next)
+        {
+            sink(symbols[i].id);
+        }
+    }
+
+    void BpeTokenizer::encode(const std::string_view text, std::vector<uint32_t>& ids) const
+    {
+        Scratch& buffers = scratch();
+        pretokenize(text, [&](std::string_view word) {
+            while (!word.empty())
+            {
+                const std::string_view slice = word.substr(0, max_word_bytes);
+                encode_word(slice, buffers, [&ids](const uint32_t id) { ids.push_back(id); });
+                word.remove_prefix(slice.size());
+            }
+        });
+    }
+
+    size_t BpeTokenizer::memory_bytes() const
+    {
+        // Slot arrays dominate; tokens longer than the small-string buffer add their own bytes.
+        size_t bytes = sizeof(*this)
+            + vocab_.bucket_count() * (sizeof(std::pair<std::string, uint32_t>) + sizeof(uint32_t))
+            + merges_.bucket_count() * (sizeof(std::pair<uint64_t, MergeEntry>) + sizeof(uint32_t));
+        for (const auto& [token, id] : vocab_)
+        {
+            if (token.capacity() > std::string().capacity())
+            {
+                bytes += token.capacity() + 1;
+            }
+        }
+        return bytes;
+    }
+
+    size_t BpeTokenizer::count_tokens(const std::string_view text) const
+    {
+        Scratch& buffers = scratch();
+        size_t count = 0;
+        pretokenize(text, [&](std::string_view word) {
+            while (!word.empty())
+            {
+                const std::string_view slice = word.substr(0, max_word_bytes);
+                encode_word(slice, buffers, [&count](uint32_t) { ++count; });
+                word.remove_prefix(slice.size());
+            }
+        });
+        return count;
+    }
+
+    size_t estimate_tokens(const std::string_view text)
+    {
+        return text.empty() ? 0 : (text.size() + 3) / 4;
+    }
+} // namespace honeypot::utils
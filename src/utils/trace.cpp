@@ -0,0 +1,192 @@
+#include <algorithm>
+#include <bit>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <fmt/core.h>
+
+#include "utils/logging.hpp"
+#include "utils/trace.hpp"
+
+namespace honeypot::utils
+{
+    namespace
+    {
+        std::unique_ptr<Tracer> tracer;
+
+        uint64_t next_random()
+        {
+            // xorshift64*, seeded per thread; only has to be cheap and roughly uniform.
+            thread_local uint64_t state = std::hash<std::thread::id>{}(std::this_thread::get_id()) | 1;
+            state ^= state >> 12;
+            state ^= state << 25;
+            state ^= state >> 27;
+            return state * 0x2545F4914F6CDD1DULL;
+        }
+
+        uint64_t threshold_for(const double rate)
+        {
+            if (rate >= 1.0)
+            {
+                return std::numeric_limits<uint64_t>::max();
+            }
+            if (rate <= 0.0)
+            {
+                return 0;
+            }
+            return static_cast<uint64_t>(std::min(rate * 18446744073709551616.0, 18446744073709549568.0));
+        }
+
+        struct DumpedSpan
+        {
+            const char* name;
+            uint64_t start_ns;
+            uint64_t end_ns;
+            uint32_t thread_id;
+        };
+    }
+
+    Tracer::Ring::Ring(const size_t capacity, const uint32_t thread_id)
+        : slots(std::make_unique<Slot[]>(capacity)),
+          mask(capacity - 1),
+          thread_id(thread_id)
+    {
+    }
+
+    Tracer::Tracer(const config::TracingConfig& config)
+        : config_(config),
+          sample_threshold_(threshold_for(config.sample_rate)),
+          ring_capacity_(std::bit_ceil(std::max<size_t>(config.spans_per_thread, 1))),
+          epoch_(Clock::now())
+    {
+    }
+
+    Tracer::RequestTrace Tracer::begin_request()
+    {
+        RequestTrace trace;
+        if (config_.enabled && sample_threshold_ != 0 && next_random() <= sample_threshold_)
+        {
+            trace.sampled = true;
+            trace.start_ns = now_ns();
+        }
+        request_sampled_ = trace.sampled;
+        return trace;
+    }
+
+    void Tracer::end_request(const RequestTrace& trace, const char* name)
+    {
+        if (trace.sampled)
+        {
+            record(name, trace.start_ns, now_ns());
+        }
+        request_sampled_ = false;
+    }
+
+    uint64_t Tracer::now_ns() const
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - epoch_).count();
+    }
+
+    Tracer::Ring& Tracer::local_ring()
+    {
+        thread_local Ring* ring = nullptr;
+        thread_local const Tracer* owner = nullptr;
+        if (owner != this)
+        {
+            std::scoped_lock lock(rings_mutex_);
+            rings_.push_back(std::make_unique<Ring>(ring_capacity_, static_cast<uint32_t>(rings_.size() + 1)));
+            ring = rings_.back().get();
+            owner = this;
+        }
+        return *ring;
+    }
+
+    void Tracer::record(const char* name, const uint64_t start_ns, const uint64_t end_ns)
+    {
+        Ring& ring = local_ring();
+        const uint64_t head = ring.head.load(std::memory_order_relaxed);
+        Slot& slot = ring.slots[head & ring.mask];
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.start_ns.store(start_ns, std::memory_order_relaxed);
+        slot.end_ns.store(end_ns, std::memory_order_relaxed);
+        ring.head.store(head + 1, std::memory_order_release);
+    }
+
+    size_t Tracer::dump(const std::string& path) const
+    {
+        std::vector<DumpedSpan> spans;
+        {
+            std::scoped_lock lock(rings_mutex_);
+            for (const auto& ring : rings_)
+            {
+                const size_t capacity = ring->mask + 1;
+                const uint64_t end = ring->head.load(std::memory_order_acquire);
+                const uint64_t begin = end > capacity ? end - capacity : 0;
+                const size_t copied_from = spans.size();
+                for (uint64_t i = begin; i < end; ++i)
+                {
+                    const Slot& slot = ring->slots[i & ring->mask];
+                    spans.push_back({slot.name.load(std::memory_order_relaxed),
+                                     slot.start_ns.load(std::memory_order_relaxed),
+                                     slot.end_ns.load(std::memory_order_relaxed), ring->thread_id});
+                }
+
+                // The owner kept writing while we copied; drop the slots it may have overwritten.
+                std::atomic_thread_fence(std::memory_order_acquire);
+                const uint64_t head_after = ring->head.load(std::memory_order_relaxed);
+                const uint64_t overwritten = head_after >= capacity ? head_after - capacity + 1 : 0;
+                if (overwritten > begin)
+                {
+                    const auto drop = static_cast<std::ptrdiff_t>(std::min(overwritten - begin, end - begin));
+                    spans.erase(spans.begin() + static_cast<std::ptrdiff_t>(copied_from),
+                                spans.begin() + static_cast<std::ptrdiff_t>(copied_from) + drop);
+                }
+            }
+        }
+
+        std::string out = R"({"displayTimeUnit":"ms","traceEvents":[)";
+        bool first = true;
+        for (const auto& [name, start_ns, end_ns, thread_id] : spans)
+        {
+            fmt::format_to(std::back_inserter(out),
+                           R"({}{{"name":"{}","cat":"honeypot","ph":"X","pid":1,"tid":{},"ts":{:.3f},"dur":{:.3f}}})",
+                           first ? "" : ",\n", name, thread_id, static_cast<double>(start_ns) / 1000.0,
+                           static_cast<double>(end_ns - start_ns) / 1000.0);
+            first = false;
+        }
+        out += "]}\n";
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file || !file.write(out.data(), static_cast<std::streamsize>(out.size())))
+        {
+            throw std::runtime_error(fmt::format("Failed to write trace to '{}'", path));
+        }
+        return spans.size();
+    }
+
+    void init_tracing(const config::HoneypotConfig& config)
+    {
+        tracer = std::make_unique<Tracer>(config.tracing);
+        if (config.tracing.enabled)
+        {
+            get_operational_logger()->info(
+                "Tracing enabled: sampling {:.2f}% of requests, {} spans per thread, dumps to '{}'.",
+                config.tracing.sample_rate * 100.0, config.tracing.spans_per_thread, config.tracing.dump_path);
+        }
+    }
+
+    Tracer& get_tracer()
+    {
+        if (!tracer)
+        {
+            static Tracer disabled{config::TracingConfig{.enabled = false}};
+            return disabled;
+        }
+        return *tracer;
+    }
+} // namespace honeypot::utils
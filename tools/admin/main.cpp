@@ -0,0 +1,170 @@
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "utils/admin.hpp"
+
+namespace
+{
+    struct Options
+    {
+        std::string socket_path;
+        std::string command; // name and argument, as sent
+        bool raw = false;    // print the reply line as received
+    };
+
+    void print_usage(const char* program, std::ostream& out)
+    {
+        out << "Usage: " << program << " [--raw] <admin.sock> <command> [argument]" << std::endl
+            << "  Sends one command to the honeypot's admin socket and prints the reply." << std::endl
+            << "  '" << program << " <admin.sock> help' lists the commands." << std::endl;
+    }
+
+#ifndef _WIN32
+    bool send_all(const int fd, std::string_view data)
+    {
+        while (!data.empty())
+        {
+            const ssize_t sent = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+            if (sent < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            data.remove_prefix(static_cast<size_t>(sent));
+        }
+        return true;
+    }
+
+    /**
+     * Reads up to the reply's newline; false if the server closes the connection first.
+     */
+    bool read_line(const int fd, std::string& line)
+    {
+        char buffer[4096];
+        while (line.find('\n') == std::string::npos)
+        {
+            const ssize_t received = ::recv(fd, buffer, sizeof(buffer), 0);
+            if (received <= 0)
+            {
+                if (received < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            line.append(buffer, static_cast<size_t>(received));
+        }
+        line.resize(line.find('\n'));
+        return true;
+    }
+#endif
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+
+    std::vector<std::string_view> args(argv, argv + argc);
+    std::vector<std::string_view> positional;
+    for (size_t i = 1; i < args.size(); ++i)
+    {
+        if (args[i] == "--raw")
+        {
+            options.raw = true;
+        }
+        else if (args[i] == "-h" || args[i] == "--help")
+        {
+            print_usage(argv[0], std::cout);
+            return 0;
+        }
+        else
+        {
+            positional.push_back(args[i]);
+        }
+    }
+
+    if (positional.size() < 2)
+    {
+        print_usage(argv[0], std::cerr);
+        return 1;
+    }
+    options.socket_path = std::string(positional[0]);
+    for (size_t i = 1; i < positional.size(); ++i)
+    {
+        if (i > 1)
+        {
+            options.command += ' ';
+        }
+        options.command += positional[i];
+    }
+    if (options.command.size() >= honeypot::utils::admin_max_line_bytes
+        || options.command.find('\n') != std::string::npos)
+    {
+        std::cerr << "FATAL: command must be a single line under " << honeypot::utils::admin_max_line_bytes
+            << " bytes." << std::endl;
+        return 1;
+    }
+
+#ifndef _WIN32
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (options.socket_path.size() >= sizeof(address.sun_path))
+    {
+        std::cerr << "FATAL: socket path too long: " << options.socket_path << std::endl;
+        return 1;
+    }
+    std::memcpy(address.sun_path, options.socket_path.c_str(), options.socket_path.size() + 1);
+
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        std::cerr << "FATAL: cannot connect to " << options.socket_path << ": " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    std::string reply;
+    const bool answered = send_all(fd, options.command + '\n') && read_line(fd, reply);
+    ::close(fd);
+    if (!answered)
+    {
+        std::cerr << "FATAL: the server closed the connection without replying." << std::endl;
+        return 1;
+    }
+
+    if (options.raw)
+    {
+        std::cout << reply << std::endl;
+        return 0;
+    }
+    const auto parsed = nlohmann::json::parse(reply, nullptr, false);
+    if (parsed.is_discarded() || !parsed.is_object())
+    {
+        std::cerr << "FATAL: unreadable reply: " << reply << std::endl;
+        return 1;
+    }
+    if (!parsed.value("ok", false))
+    {
+        std::cerr << "Error: " << parsed.value("error", std::string("unknown")) << std::endl;
+        return 1;
+    }
+    std::cout << parsed["result"].dump(2) << std::endl;
+    return 0;
+#else
+    std::cerr << "FATAL: the admin socket needs Unix domain sockets." << std::endl;
+    return 1;
+#endif
+}
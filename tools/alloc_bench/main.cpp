@@ -0,0 +1,190 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <crow.h>
+#include <fmt/core.h>
+
+#include "api/delete.hpp"
+#include "api/show.hpp"
+#include "state/honeypot_state.hpp"
+#include "utils/config.hpp"
+#include "utils/logging.hpp"
+
+// Every allocation in the process goes through here, so the deltas below are exact.
+namespace
+{
+    std::atomic<uint64_t> allocation_count{0};
+}
+
+void* operator new(const size_t size)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](const size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace
+{
+    struct Options
+    {
+        std::string config_path;
+        uint32_t iterations = 20000;
+        uint32_t warmup = 100; // fills thread-local arenas and caches before counting
+    };
+
+    void print_usage(const char* program, std::ostream& out)
+    {
+        out << "Usage: " << program << " [--iterations N] <honeypot.json>" << std::endl
+            << "  Counts heap allocations and time per request on the hot paths: request logging and" << std::endl
+            << "  the /api/show and /api/delete handlers. Logs go to alloc_bench_*.log in the working" << std::endl
+            << "  directory." << std::endl;
+    }
+
+    template <typename Fn>
+    void measure(const Options& options, const std::string_view name, Fn&& fn)
+    {
+        for (uint32_t i = 0; i < options.warmup; ++i)
+        {
+            fn();
+        }
+
+        const uint64_t before = allocation_count.load(std::memory_order_relaxed);
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < options.iterations; ++i)
+        {
+            fn();
+        }
+        const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+        const uint64_t allocations = allocation_count.load(std::memory_order_relaxed) - before;
+
+        std::cout << fmt::format("{:<32} {:>8.1f} allocs/req {:>9.2f} us/req", name,
+                                 static_cast<double>(allocations) / options.iterations,
+                                 elapsed.count() / options.iterations) << std::endl;
+    }
+
+    // A typical scanner request: a handful of headers and a JSON body naming a model that does not exist.
+    crow::request make_request()
+    {
+        crow::request req;
+        req.remote_ip_address = "203.0.113.77";
+        req.method = crow::HTTPMethod::Post;
+        req.url = "/api/show";
+        for (const auto& [name, value] : {
+                 std::pair{"Host", "honeypot.example:11434"},
+                 std::pair{"User-Agent", "python-requests/2.31.0"},
+                 std::pair{"Accept-Encoding", "gzip, deflate"},
+                 std::pair{"Accept", "*/*"},
+                 std::pair{"Connection", "keep-alive"},
+                 std::pair{"Content-Length", "64"},
+                 std::pair{"Content-Type", "application/json"},
+             })
+        {
+            req.headers.emplace(name, value);
+        }
+        req.body = R"({"model":"llama3-unknown-model:70b-instruct-q4","verbose":false})";
+        return req;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    using namespace honeypot;
+
+    Options options;
+
+    std::vector<std::string_view> args(argv, argv + argc);
+    for (size_t i = 1; i < args.size(); ++i)
+    {
+        if (args[i] == "--iterations" && i + 1 < args.size())
+        {
+            options.iterations = static_cast<uint32_t>(std::strtoul(std::string(args[++i]).c_str(), nullptr, 10));
+        }
+        else if (args[i] == "-h" || args[i] == "--help")
+        {
+            print_usage(argv[0], std::cout);
+            return 0;
+        }
+        else if (options.config_path.empty())
+        {
+            options.config_path = std::string(args[i]);
+        }
+        else
+        {
+            print_usage(argv[0], std::cerr);
+            return 1;
+        }
+    }
+    if (options.config_path.empty() || options.iterations == 0)
+    {
+        print_usage(argv[0], std::cerr);
+        return 1;
+    }
+
+    auto config = std::make_shared<config::HoneypotConfig>();
+    try
+    {
+        *config = config::load_config(options.config_path);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "FATAL: " << e.what() << std::endl;
+        return 1;
+    }
+    // Only the work a request always does: no console output, no prompt tagging, no collapsing.
+    config->logging.log_outputs = {"file"};
+    config->logging.log_file_path = "alloc_bench_operational.log";
+    config->logging.request_log_path = "alloc_bench_requests.log";
+    config->logging.prompt_signatures_path.clear();
+    config->logging.event_socket_path.clear();
+    config->logging.collapse_window_seconds = 0;
+    utils::init_logging(*config);
+    const auto state = std::make_shared<state::HoneypotState>(*config);
+
+    crow::request req = make_request();
+    const crow::response logged(crow::status::NOT_FOUND);
+    measure(options, "log_request", [&] { utils::log_request(req, logged, {}); });
+    measure(options, "show (unknown model)", [&] { [[maybe_unused]] const auto res = api::handle_show(config, state, req); });
+    measure(options, "delete (unknown model)", [&] { [[maybe_unused]] const auto res = api::handle_delete(state, req); });
+    req.body = "{not json";
+    measure(options, "show (malformed body)", [&] { [[maybe_unused]] const auto res = api::handle_show(config, state, req); });
+
+    utils::shutdown_request_log();
+    return 0;
+}
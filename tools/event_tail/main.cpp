@@ -0,0 +1,155 @@
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fmt/core.h>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "utils/event_stream.hpp"
+
+namespace
+{
+    struct Options
+    {
+        std::string socket_path;
+        uint64_t limit = 0;                      // stop after this many records, 0 = run until closed
+        std::chrono::milliseconds delay{0};      // pause after every record, to exercise the drop path
+        bool quiet = false;                      // count records without printing them
+    };
+
+    void print_usage(const char* program, std::ostream& out)
+    {
+        out << "Usage: " << program << " [-n limit] [--delay-ms N] [-q] <event.sock>" << std::endl
+            << "  Connects to the honeypot's request event stream and prints one JSON record per line." << std::endl
+            << "  --delay-ms slows the consumer down to test how the server drops frames for it." << std::endl;
+    }
+
+#ifndef _WIN32
+    /**
+     * Reads exactly @p size bytes; false once the server closes the stream.
+     */
+    bool read_exact(const int fd, char* out, size_t size)
+    {
+        while (size > 0)
+        {
+            const ssize_t received = ::recv(fd, out, size, 0);
+            if (received <= 0)
+            {
+                if (received < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            out += received;
+            size -= static_cast<size_t>(received);
+        }
+        return true;
+    }
+#endif
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+
+    std::vector<std::string_view> args(argv, argv + argc);
+    for (size_t i = 1; i < args.size(); ++i)
+    {
+        const bool has_value = i + 1 < args.size();
+        if ((args[i] == "-n" || args[i] == "--limit") && has_value)
+        {
+            options.limit = std::stoull(std::string(args[++i]));
+        }
+        else if (args[i] == "--delay-ms" && has_value)
+        {
+            options.delay = std::chrono::milliseconds(std::stoul(std::string(args[++i])));
+        }
+        else if (args[i] == "-q" || args[i] == "--quiet")
+        {
+            options.quiet = true;
+        }
+        else if (args[i] == "-h" || args[i] == "--help")
+        {
+            print_usage(argv[0], std::cout);
+            return 0;
+        }
+        else
+        {
+            options.socket_path = std::string(args[i]);
+        }
+    }
+
+    if (options.socket_path.empty())
+    {
+        print_usage(argv[0], std::cerr);
+        return 1;
+    }
+
+#ifndef _WIN32
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (options.socket_path.size() >= sizeof(address.sun_path))
+    {
+        std::cerr << "FATAL: socket path too long: " << options.socket_path << std::endl;
+        return 1;
+    }
+    std::memcpy(address.sun_path, options.socket_path.c_str(), options.socket_path.size() + 1);
+
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        std::cerr << "FATAL: cannot connect to " << options.socket_path << ": " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    uint64_t records = 0;
+    uint64_t bytes = 0;
+    std::string record;
+    unsigned char header[honeypot::utils::event_frame_header_bytes];
+    while (options.limit == 0 || records < options.limit)
+    {
+        if (!read_exact(fd, reinterpret_cast<char*>(header), sizeof(header)))
+        {
+            break;
+        }
+        const uint32_t length = header[0] | header[1] << 8 | header[2] << 16 | static_cast<uint32_t>(header[3]) << 24;
+        record.resize(length);
+        if (!read_exact(fd, record.data(), length))
+        {
+            std::cerr << "Stream ended inside a frame." << std::endl;
+            break;
+        }
+        ++records;
+        bytes += length;
+        if (!options.quiet)
+        {
+            std::cout << record << '\n';
+        }
+        if (options.delay.count() > 0)
+        {
+            std::this_thread::sleep_for(options.delay);
+        }
+    }
+    ::close(fd);
+
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << fmt::format("{} records, {:.2f} MB in {:.2f}s", records, static_cast<double>(bytes) / 1e6, elapsed)
+              << std::endl;
+    return 0;
+#else
+    std::cerr << "FATAL: the request event stream needs Unix domain sockets." << std::endl;
+    return 1;
+#endif
+}
@@ -0,0 +1,475 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <asio.hpp>
+#include <fmt/core.h>
+#include <tsl/robin_map.h>
+
+#include "utils/hash.hpp"
+#include "utils/ip_index.hpp"
+
+namespace fs = std::filesystem;
+using namespace honeypot::utils;
+
+namespace
+{
+    using Address = std::array<uint8_t, 16>; // big-endian; IPv4 uses the first four bytes
+
+    // Build-time trie entries: 0 is empty, a set high bit marks a record, anything else a child.
+    constexpr size_t stride = 256;
+    constexpr uint32_t leaf_bit = 0x80000000u;
+    constexpr uint32_t empty = 0;
+
+    struct Prefix
+    {
+        Address address{};
+        uint8_t length = 0;
+        bool v6 = false;
+        uint32_t record = 0;
+    };
+
+    bool parse_address(const std::string_view text, Address& out, bool& v6)
+    {
+        asio::error_code ec;
+        const auto parsed = asio::ip::make_address(std::string(text), ec);
+        if (ec)
+        {
+            return false;
+        }
+        out = {};
+        if (parsed.is_v4())
+        {
+            const auto bytes = parsed.to_v4().to_bytes();
+            std::copy(bytes.begin(), bytes.end(), out.begin());
+            v6 = false;
+        }
+        else
+        {
+            out = parsed.to_v6().to_bytes();
+            v6 = true;
+        }
+        return true;
+    }
+
+    bool bit_set(const Address& address, const unsigned bit)
+    {
+        return (address[bit / 8] >> (7 - bit % 8)) & 1;
+    }
+
+    // Number of trailing zero bits within the first @p width bits.
+    unsigned trailing_zeros(const Address& address, const unsigned width)
+    {
+        unsigned zeros = 0;
+        while (zeros < width && !bit_set(address, width - 1 - zeros))
+        {
+            ++zeros;
+        }
+        return zeros;
+    }
+
+    // Adds 2^@p power to an address of @p width bits; returns false on overflow.
+    bool add_power_of_two(Address& address, const unsigned width, const unsigned power)
+    {
+        if (power >= width)
+        {
+            return false;
+        }
+        int byte = static_cast<int>((width - 1 - power) / 8);
+        unsigned carry = 1u << (7 - (width - 1 - power) % 8);
+        while (byte >= 0 && carry != 0)
+        {
+            const unsigned sum = address[byte] + carry;
+            address[byte] = static_cast<uint8_t>(sum);
+            carry = sum >> 8;
+            --byte;
+        }
+        return carry == 0;
+    }
+
+    // First address of the block of 2^@p power addresses containing @p address.
+    Address block_start(Address address, const unsigned width, const unsigned power)
+    {
+        for (unsigned bit = width - power; bit < width; ++bit)
+        {
+            address[bit / 8] &= static_cast<uint8_t>(~(1u << (7 - bit % 8)));
+        }
+        return address;
+    }
+
+    // Last address of the block of 2^@p power addresses starting at @p start.
+    Address block_end(Address start, const unsigned width, const unsigned power)
+    {
+        for (unsigned bit = width - power; bit < width; ++bit)
+        {
+            start[bit / 8] |= static_cast<uint8_t>(1u << (7 - bit % 8));
+        }
+        return start;
+    }
+
+    // Splits [first, last] into the minimal list of CIDR blocks.
+    void range_to_prefixes(Address first, const Address& last, const bool v6, const uint32_t record,
+                           std::vector<Prefix>& out)
+    {
+        const unsigned width = v6 ? 128 : 32;
+        while (first <= last)
+        {
+            unsigned power = trailing_zeros(first, width);
+            while (power > 0 && block_end(first, width, power) > last)
+            {
+                --power;
+            }
+            out.push_back({first, static_cast<uint8_t>(width - power), v6, record});
+            if (!add_power_of_two(first, width, power))
+            {
+                break;
+            }
+        }
+    }
+
+    class IpIndexBuilder
+    {
+    public:
+        IpIndexBuilder()
+        {
+            nodes_.resize(3); // 0 reserved, 1 IPv4 root, 2 IPv6 root
+        }
+
+        bool add_line(const std::string_view line)
+        {
+            std::vector<std::string_view> fields;
+            size_t pos = 0;
+            while (pos <= line.size())
+            {
+                const size_t tab = std::min(line.find('\t', pos), line.size());
+                fields.push_back(line.substr(pos, tab - pos));
+                pos = tab + 1;
+            }
+
+            // ip2asn layout: first \t last \t asn \t country \t organization
+            // CIDR layout:   prefix/len \t asn \t country \t organization
+            Address first{}, last{};
+            bool v6 = false, last_v6 = false;
+            size_t asn_field = 2;
+            if (const size_t slash = fields[0].find('/'); slash != std::string_view::npos)
+            {
+                unsigned length = 0;
+                for (const char c : fields[0].substr(slash + 1))
+                {
+                    length = length * 10 + static_cast<unsigned>(c - '0');
+                }
+                if (!parse_address(fields[0].substr(0, slash), first, v6) || length > (v6 ? 128u : 32u))
+                {
+                    return false;
+                }
+                const unsigned width = v6 ? 128 : 32;
+                first = block_start(first, width, width - length);
+                last = block_end(first, width, width - length);
+                asn_field = 1;
+            }
+            else if (fields.size() < 2 || !parse_address(fields[0], first, v6) || !parse_address(fields[1], last, last_v6)
+                     || v6 != last_v6 || last < first)
+            {
+                return false;
+            }
+            if (fields.size() < asn_field + 1)
+            {
+                return false;
+            }
+
+            uint32_t asn = 0;
+            for (const char c : fields[asn_field])
+            {
+                if (c >= '0' && c <= '9')
+                {
+                    asn = asn * 10 + static_cast<uint32_t>(c - '0');
+                }
+            }
+            const std::string_view country = fields.size() > asn_field + 1 ? fields[asn_field + 1] : "";
+            const std::string_view organization = fields.size() > asn_field + 2 ? fields[asn_field + 2] : "";
+            if (asn == 0 && (country.size() != 2 || country == "ZZ"))
+            {
+                return true; // unrouted space, nothing worth recording
+            }
+
+            range_to_prefixes(first, last, v6, record_for(asn, country, organization), prefixes_);
+            return true;
+        }
+
+        size_t prefix_count() const { return prefixes_.size(); }
+        size_t record_count() const { return records_.size(); }
+        size_t trie_node_count() const { return nodes_.size() - 1; }
+
+        std::string serialize()
+        {
+            // Shorter prefixes first, so more specific ones overwrite them (longest prefix wins).
+            std::ranges::stable_sort(prefixes_, {}, &Prefix::length);
+            for (const auto& prefix : prefixes_)
+            {
+                insert(prefix);
+            }
+
+            std::vector<IpIndexNode> nodes;
+            std::vector<uint32_t> leaves;
+            compress(nodes, leaves);
+
+            IpIndexFileHeader header{};
+            std::memcpy(header.magic, ip_index_magic, sizeof(ip_index_magic));
+            header.version = ip_index_format_version;
+            header.endian_tag = ip_index_endian_tag;
+            header.node_count = static_cast<uint32_t>(nodes.size());
+            header.leaf_count = static_cast<uint32_t>(leaves.size());
+            header.record_count = static_cast<uint32_t>(records_.size());
+            header.v4_root = 0;
+            header.v6_root = 1;
+
+            std::string out(sizeof(IpIndexFileHeader), '\0');
+            const auto append_section = [&out](const void* data, const size_t bytes) {
+                out.resize((out.size() + 7) & ~size_t{7}, '\0');
+                const uint64_t offset = out.size();
+                out.append(static_cast<const char*>(data), bytes);
+                return offset;
+            };
+            header.nodes_offset = append_section(nodes.data(), nodes.size() * sizeof(IpIndexNode));
+            header.leaves_offset = append_section(leaves.data(), leaves.size() * sizeof(uint32_t));
+            header.records_offset = append_section(records_.data(), records_.size() * sizeof(IpIndexRecord));
+            header.strings_offset = append_section(strings_.data(), strings_.size());
+            header.strings_size = strings_.size();
+            out.resize((out.size() + 7) & ~size_t{7}, '\0');
+            header.file_size = out.size();
+            std::memcpy(out.data(), &header, sizeof(header));
+            return out;
+        }
+
+    private:
+        using Node = std::array<uint32_t, stride>;
+
+        uint32_t record_for(const uint32_t asn, const std::string_view country, const std::string_view organization)
+        {
+            const std::string key = fmt::format("{}\t{}\t{}", asn, country, organization);
+            if (const auto it = record_ids_.find(key); it != record_ids_.end())
+            {
+                return it->second;
+            }
+
+            IpIndexRecord record{};
+            record.asn = asn;
+            const std::string_view name = organization.substr(0, UINT16_MAX);
+            if (const auto it = organization_offsets_.find(name); it != organization_offsets_.end())
+            {
+                record.organization_offset = it->second;
+            }
+            else
+            {
+                record.organization_offset = static_cast<uint32_t>(strings_.size());
+                organization_offsets_.emplace(std::string(name), record.organization_offset);
+                strings_.append(name);
+            }
+            record.organization_length = static_cast<uint16_t>(name.size());
+            if (country.size() == 2 && country != "ZZ")
+            {
+                record.country[0] = country[0];
+                record.country[1] = country[1];
+            }
+
+            const auto id = static_cast<uint32_t>(records_.size());
+            records_.push_back(record);
+            record_ids_.emplace(key, id);
+            return id;
+        }
+
+        void fill(const uint32_t node, const size_t slot, const uint32_t leaf)
+        {
+            const uint32_t entry = nodes_[node][slot];
+            if (entry != empty && (entry & leaf_bit) == 0)
+            {
+                for (size_t i = 0; i < stride; ++i)
+                {
+                    fill(entry, i, leaf);
+                }
+                return;
+            }
+            nodes_[node][slot] = leaf;
+        }
+
+        void insert(const Prefix& prefix)
+        {
+            const uint32_t leaf = leaf_bit | prefix.record;
+            uint32_t node = prefix.v6 ? 2 : 1;
+            size_t depth = 0;
+            while (prefix.length > (depth + 1) * 8)
+            {
+                const uint8_t byte = prefix.address[depth];
+                uint32_t entry = nodes_[node][byte];
+                if (entry == empty || (entry & leaf_bit))
+                {
+                    // Push the covering record down into the new child.
+                    const auto child = static_cast<uint32_t>(nodes_.size());
+                    nodes_.emplace_back().fill(entry);
+                    nodes_[node][byte] = child;
+                    entry = child;
+                }
+                node = entry;
+                ++depth;
+            }
+
+            const unsigned remaining = prefix.length - static_cast<unsigned>(depth) * 8;
+            const size_t span = size_t{1} << (8 - remaining);
+            const size_t first = prefix.address[depth] & ~(span - 1);
+            for (size_t slot = first; slot < first + span; ++slot)
+            {
+                fill(node, slot, leaf);
+            }
+        }
+
+        // Lays the trie out breadth first, so every node's children end up contiguous and can be
+        // addressed as child_base + rank; runs of equal answers share one leaf.
+        void compress(std::vector<IpIndexNode>& nodes, std::vector<uint32_t>& leaves) const
+        {
+            std::vector<uint32_t> order{1, 2};
+            for (size_t next = 0; next < order.size(); ++next)
+            {
+                const Node& source = nodes_[order[next]];
+                IpIndexNode node{};
+                node.child_base = static_cast<uint32_t>(order.size());
+                node.leaf_base = static_cast<uint32_t>(leaves.size());
+
+                bool have_previous = false;
+                uint32_t previous = 0;
+                for (size_t slot = 0; slot < stride; ++slot)
+                {
+                    const uint32_t entry = source[slot];
+                    if (entry != empty && (entry & leaf_bit) == 0)
+                    {
+                        node.child_bits[slot / 64] |= uint64_t{1} << (slot % 64);
+                        order.push_back(entry);
+                        continue;
+                    }
+                    const uint32_t leaf = entry == empty ? 0 : (entry & ~leaf_bit) + 1;
+                    if (!have_previous || leaf != previous)
+                    {
+                        node.leaf_bits[slot / 64] |= uint64_t{1} << (slot % 64);
+                        leaves.push_back(leaf);
+                        previous = leaf;
+                        have_previous = true;
+                    }
+                }
+                for (size_t word = 1; word < 4; ++word)
+                {
+                    node.child_rank[word] = static_cast<uint8_t>(
+                        node.child_rank[word - 1] + std::popcount(node.child_bits[word - 1]));
+                    node.leaf_rank[word] = static_cast<uint8_t>(
+                        node.leaf_rank[word - 1] + std::popcount(node.leaf_bits[word - 1]));
+                }
+                nodes.push_back(node);
+            }
+        }
+
+        std::vector<Prefix> prefixes_;
+        std::vector<Node> nodes_;
+        std::vector<IpIndexRecord> records_;
+        std::string strings_;
+        tsl::robin_map<std::string, uint32_t, TransparentStringHash, TransparentStringEqual> record_ids_;
+        tsl::robin_map<std::string, uint32_t, TransparentStringHash, TransparentStringEqual> organization_offsets_;
+    };
+}
+
+int main(int argc, char* argv[])
+{
+    std::string output_path;
+    std::vector<fs::path> inputs;
+
+    std::vector<std::string_view> args(argv, argv + argc);
+    for (size_t i = 1; i < args.size(); ++i)
+    {
+        if ((args[i] == "-o" || args[i] == "--output") && (i + 1 < args.size()))
+        {
+            output_path = args[++i];
+        }
+        else if (args[i] == "-h" || args[i] == "--help")
+        {
+            std::cout << "Usage: " << argv[0] << " -o <ip_index.bin> <ip2asn.tsv>..." << std::endl;
+            std::cout << "Input lines are 'first<TAB>last<TAB>asn<TAB>country<TAB>organization' "
+                      << "or 'prefix/len<TAB>asn<TAB>country<TAB>organization'." << std::endl;
+            return 0;
+        }
+        else
+        {
+            inputs.emplace_back(args[i]);
+        }
+    }
+
+    if (output_path.empty() || inputs.empty())
+    {
+        std::cerr << "Usage: " << argv[0] << " -o <ip_index.bin> <ip2asn.tsv>..." << std::endl;
+        return 1;
+    }
+
+    IpIndexBuilder builder;
+    size_t skipped = 0;
+    for (const auto& file : inputs)
+    {
+        std::ifstream in(file, std::ios::binary);
+        if (!in.is_open())
+        {
+            std::cerr << "[WARN] Skipping unreadable input file: " << file.string() << std::endl;
+            continue;
+        }
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+            if (line.empty() || line.front() == '#')
+            {
+                continue;
+            }
+            if (!builder.add_line(line))
+            {
+                ++skipped;
+            }
+        }
+    }
+
+    if (builder.prefix_count() == 0)
+    {
+        std::cerr << "FATAL: inputs produced no IP ranges." << std::endl;
+        return 1;
+    }
+
+    const std::string index_bytes = builder.serialize();
+    const std::string temp_path = output_path + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        out.write(index_bytes.data(), static_cast<std::streamsize>(index_bytes.size()));
+        if (!out)
+        {
+            std::cerr << "FATAL: failed to write " << temp_path << std::endl;
+            return 1;
+        }
+    }
+    // rename() swaps the file atomically; a running server picks it up on SIGHUP.
+    std::error_code ec;
+    fs::rename(temp_path, output_path, ec);
+    if (ec)
+    {
+        std::cerr << "FATAL: failed to move index into place: " << ec.message() << std::endl;
+        return 1;
+    }
+
+    std::cout << fmt::format("[INFO] Wrote {} ({} bytes): {} prefixes, {} records, {} trie nodes, {} unparsable lines",
+                             output_path, index_bytes.size(), builder.prefix_count(), builder.record_count(),
+                             builder.trie_node_count(), skipped)
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,809 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+#include <tsl/robin_map.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "utils/hash.hpp"
+
+using namespace honeypot::utils;
+
+namespace
+{
+    constexpr uint64_t mix64(uint64_t z) noexcept
+    {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t hash_key(const std::string_view key)
+    {
+        return mix64(std::hash<std::string_view>{}(key));
+    }
+
+    /**
+     * Read-only view of a capture file: mmap where available, a heap copy elsewhere.
+     */
+    class MappedFile
+    {
+    public:
+        explicit MappedFile(const std::string& path)
+        {
+#ifndef _WIN32
+            const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+            {
+                throw std::runtime_error(fmt::format("failed to open '{}': {}", path, std::strerror(errno)));
+            }
+            struct stat st{};
+            if (::fstat(fd, &st) != 0)
+            {
+                ::close(fd);
+                throw std::runtime_error(fmt::format("failed to stat '{}': {}", path, std::strerror(errno)));
+            }
+            size_ = static_cast<size_t>(st.st_size);
+            if (size_ > 0)
+            {
+                void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapping == MAP_FAILED)
+                {
+                    ::close(fd);
+                    throw std::runtime_error(fmt::format("failed to map '{}': {}", path, std::strerror(errno)));
+                }
+                data_ = static_cast<const char*>(mapping);
+#ifdef MADV_SEQUENTIAL
+                ::madvise(mapping, size_, MADV_SEQUENTIAL);
+#endif
+            }
+            ::close(fd);
+#else
+            std::ifstream in(path, std::ios::binary | std::ios::ate);
+            if (!in.is_open())
+            {
+                throw std::runtime_error(fmt::format("failed to open '{}'", path));
+            }
+            size_ = static_cast<size_t>(in.tellg());
+            heap_copy_ = std::make_unique<char[]>(size_);
+            in.seekg(0);
+            in.read(heap_copy_.get(), static_cast<std::streamsize>(size_));
+            data_ = heap_copy_.get();
+#endif
+        }
+
+        ~MappedFile()
+        {
+#ifndef _WIN32
+            if (data_ != nullptr)
+            {
+                ::munmap(const_cast<char*>(data_), size_);
+            }
+#endif
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        std::string_view view() const { return {data_, size_}; }
+
+    private:
+        const char* data_ = nullptr;
+        size_t size_ = 0;
+        std::unique_ptr<char[]> heap_copy_;
+    };
+
+    /**
+     * Fields of one request record, as raw (still JSON-escaped) slices of the mapped line.
+     */
+    struct RecordFields
+    {
+        std::string_view timestamp;
+        std::string_view source_ip;
+        std::string_view method;
+        std::string_view url;
+        std::string_view user_agent;
+        std::string_view body;
+        std::string_view response_status;
+        uint64_t count = 1; // requests a collapsed record stands for
+    };
+
+    // Returns the position just past the closing quote of the string starting at `pos` (on the quote).
+    size_t skip_string(const std::string_view line, size_t pos)
+    {
+        ++pos;
+        while (true)
+        {
+            const size_t quote = line.find('"', pos);
+            if (quote == std::string_view::npos)
+            {
+                return line.size();
+            }
+            size_t backslashes = 0;
+            while (quote - backslashes > pos && line[quote - backslashes - 1] == '\\')
+            {
+                ++backslashes;
+            }
+            if (backslashes % 2 == 0)
+            {
+                return quote + 1;
+            }
+            pos = quote + 1;
+        }
+    }
+
+    size_t skip_value(const std::string_view line, size_t pos)
+    {
+        if (pos >= line.size())
+        {
+            return pos;
+        }
+        if (line[pos] == '"')
+        {
+            return skip_string(line, pos);
+        }
+        if (line[pos] == '{' || line[pos] == '[')
+        {
+            int depth = 0;
+            while (pos < line.size())
+            {
+                const char c = line[pos];
+                if (c == '"')
+                {
+                    pos = skip_string(line, pos);
+                    continue;
+                }
+                depth += (c == '{' || c == '[') - (c == '}' || c == ']');
+                ++pos;
+                if (depth == 0)
+                {
+                    break;
+                }
+            }
+            return pos;
+        }
+        while (pos < line.size() && line[pos] != ',' && line[pos] != '}')
+        {
+            ++pos;
+        }
+        return pos;
+    }
+
+    /**
+     * Walks the top-level keys of one compact JSON object (as written by log_request) and
+     * slices out the fields we aggregate, skipping nested values without building a DOM.
+     */
+    bool extract_fields(const std::string_view line, RecordFields& fields)
+    {
+        fields = {};
+        size_t pos = line.find('{');
+        if (pos == std::string_view::npos)
+        {
+            return false;
+        }
+        ++pos;
+        while (pos < line.size())
+        {
+            while (pos < line.size() && (line[pos] == ' ' || line[pos] == ','))
+            {
+                ++pos;
+            }
+            if (pos >= line.size() || line[pos] != '"')
+            {
+                break;
+            }
+            const size_t key_end = skip_string(line, pos);
+            const std::string_view key = line.substr(pos + 1, key_end - pos - 2);
+            pos = key_end;
+            while (pos < line.size() && (line[pos] == ' ' || line[pos] == ':'))
+            {
+                ++pos;
+            }
+            const size_t value_start = pos;
+            pos = skip_value(line, pos);
+            std::string_view value = line.substr(value_start, pos - value_start);
+            if (value.size() >= 2 && value.front() == '"')
+            {
+                value = value.substr(1, value.size() - 2);
+            }
+
+            if (key == "timestamp") fields.timestamp = value;
+            else if (key == "source_ip") fields.source_ip = value;
+            else if (key == "method") fields.method = value;
+            else if (key == "url") fields.url = value;
+            else if (key == "user_agent") fields.user_agent = value;
+            else if (key == "body") fields.body = value;
+            else if (key == "response_status") fields.response_status = value;
+            else if (key == "count")
+            {
+                uint64_t count = 0;
+                for (const char c : value)
+                {
+                    count = count * 10 + static_cast<uint64_t>(c - '0');
+                }
+                fields.count = std::max<uint64_t>(count, 1);
+            }
+        }
+        return !fields.method.empty();
+    }
+
+    // Pulls "model" out of a JSON-escaped request body: ...\"model\":\"phi4:latest\"...
+    std::string_view extract_model(const std::string_view escaped_body)
+    {
+        constexpr std::string_view needle = R"(\"model\")";
+        size_t pos = escaped_body.find(needle);
+        if (pos == std::string_view::npos)
+        {
+            return {};
+        }
+        pos += needle.size();
+        while (pos < escaped_body.size() && (escaped_body[pos] == ' ' || escaped_body[pos] == ':'))
+        {
+            ++pos;
+        }
+        if (escaped_body.substr(pos, 2) != R"(\")")
+        {
+            return {};
+        }
+        pos += 2;
+        const size_t end = escaped_body.find(R"(\")", pos);
+        if (end == std::string_view::npos || end - pos > 256)
+        {
+            return {};
+        }
+        return escaped_body.substr(pos, end - pos);
+    }
+
+    // Minutes since the epoch from "YYYY-MM-DDTHH:MM:SSZ", or -1.
+    int64_t minute_of(const std::string_view timestamp)
+    {
+        if (timestamp.size() < 16)
+        {
+            return -1;
+        }
+        const auto number = [&](const size_t pos, const size_t width) {
+            int value = 0;
+            for (size_t i = pos; i < pos + width; ++i)
+            {
+                const char c = timestamp[i];
+                if (c < '0' || c > '9')
+                {
+                    return -1;
+                }
+                value = value * 10 + (c - '0');
+            }
+            return value;
+        };
+        const int year = number(0, 4);
+        const int month = number(5, 2);
+        const int day = number(8, 2);
+        const int hour = number(11, 2);
+        const int minute = number(14, 2);
+        if (year < 0 || month < 1 || day < 1 || hour < 0 || minute < 0)
+        {
+            return -1;
+        }
+        const std::chrono::year_month_day date{std::chrono::year(year), std::chrono::month(month),
+                                               std::chrono::day(day)};
+        if (!date.ok())
+        {
+            return -1;
+        }
+        return std::chrono::sys_days(date).time_since_epoch().count() * 1440 + hour * 60 + minute;
+    }
+
+    /**
+     * HyperLogLog with 2^14 registers (~0.8% standard error).
+     */
+    class HyperLogLog
+    {
+    public:
+        void add(const uint64_t hash)
+        {
+            const size_t index = hash >> (64 - precision);
+            const uint64_t rest = (hash << precision) | (uint64_t{1} << (precision - 1));
+            const auto rank = static_cast<uint8_t>(std::countl_zero(rest) + 1);
+            registers_[index] = std::max(registers_[index], rank);
+        }
+
+        void merge(const HyperLogLog& other)
+        {
+            for (size_t i = 0; i < registers_.size(); ++i)
+            {
+                registers_[i] = std::max(registers_[i], other.registers_[i]);
+            }
+        }
+
+        uint64_t estimate() const
+        {
+            constexpr double m = static_cast<double>(register_count);
+            const double alpha = 0.7213 / (1.0 + 1.079 / m);
+            double sum = 0.0;
+            size_t zeros = 0;
+            for (const uint8_t r : registers_)
+            {
+                sum += std::ldexp(1.0, -r);
+                zeros += r == 0;
+            }
+            const double raw = alpha * m * m / sum;
+            if (raw <= 2.5 * m && zeros > 0)
+            {
+                return static_cast<uint64_t>(m * std::log(m / static_cast<double>(zeros)));
+            }
+            return static_cast<uint64_t>(raw);
+        }
+
+    private:
+        static constexpr unsigned precision = 14;
+        static constexpr size_t register_count = size_t{1} << precision;
+        std::array<uint8_t, register_count> registers_{};
+    };
+
+    /**
+     * Count-min sketch plus a bounded candidate set: the sketch estimates any key's
+     * frequency, the candidates remember which keys might be heavy. Sketches merge by
+     * addition, candidates by union and re-estimation.
+     */
+    class HeavyHitters
+    {
+    public:
+        explicit HeavyHitters(const size_t capacity) : capacity_(capacity), table_(depth * width, 0) {}
+
+        void add(const std::string_view key, const uint64_t hash, const uint64_t weight)
+        {
+            // Conservative update: only the cells at the current minimum grow, which keeps
+            // collisions from inflating light keys nearly as much as a plain increment.
+            std::array<uint64_t*, depth> cells{};
+            uint64_t estimate = UINT64_MAX;
+            for (size_t row = 0; row < depth; ++row)
+            {
+                cells[row] = &table_[row * width + slot(hash, row)];
+                estimate = std::min(estimate, *cells[row]);
+            }
+            estimate += weight;
+            for (uint64_t* cell : cells)
+            {
+                *cell = std::max(*cell, estimate);
+            }
+
+            if (const auto it = candidates_.find(key); it != candidates_.end())
+            {
+                it.value() = estimate;
+                return;
+            }
+            if (candidates_.size() < capacity_)
+            {
+                candidates_.emplace(std::string(key), estimate);
+                return;
+            }
+            if (estimate <= floor_)
+            {
+                return;
+            }
+            // Evict the weakest candidate; the floor only rises, so scans get rarer over time.
+            auto weakest = candidates_.begin();
+            for (auto it = candidates_.begin(); it != candidates_.end(); ++it)
+            {
+                if (it->second < weakest->second)
+                {
+                    weakest = it;
+                }
+            }
+            floor_ = weakest->second;
+            if (estimate > floor_)
+            {
+                candidates_.erase(weakest);
+                candidates_.emplace(std::string(key), estimate);
+            }
+        }
+
+        void merge(const HeavyHitters& other)
+        {
+            for (size_t i = 0; i < table_.size(); ++i)
+            {
+                table_[i] += other.table_[i];
+            }
+            for (const auto& [key, count] : other.candidates_)
+            {
+                candidates_.try_emplace(key, 0);
+            }
+        }
+
+        std::vector<std::pair<std::string, uint64_t>> top(const size_t k) const
+        {
+            std::vector<std::pair<std::string, uint64_t>> result;
+            result.reserve(candidates_.size());
+            for (const auto& [key, count] : candidates_)
+            {
+                result.emplace_back(key, estimate(hash_key(key)));
+            }
+            std::ranges::sort(result, std::ranges::greater{}, &std::pair<std::string, uint64_t>::second);
+            if (result.size() > k)
+            {
+                result.resize(k);
+            }
+            return result;
+        }
+
+    private:
+        static constexpr size_t depth = 4;
+        static constexpr size_t width = size_t{1} << 15;
+
+        static size_t slot(const uint64_t hash, const size_t row)
+        {
+            const uint64_t h1 = hash;
+            const uint64_t h2 = mix64(hash) | 1;
+            return static_cast<size_t>((h1 + row * h2) & (width - 1));
+        }
+
+        uint64_t estimate(const uint64_t hash) const
+        {
+            uint64_t result = UINT64_MAX;
+            for (size_t row = 0; row < depth; ++row)
+            {
+                result = std::min(result, table_[row * width + slot(hash, row)]);
+            }
+            return result;
+        }
+
+        size_t capacity_;
+        uint64_t floor_ = 0;
+        std::vector<uint64_t> table_;
+        tsl::robin_map<std::string, uint64_t, TransparentStringHash, TransparentStringEqual> candidates_;
+    };
+
+    struct Aggregates
+    {
+        explicit Aggregates(const size_t candidates)
+            : ips(candidates), user_agents(candidates), urls(candidates), models(candidates)
+        {
+        }
+
+        uint64_t records = 0; // requests, counting each collapsed record as its count
+        uint64_t malformed = 0;
+        uint64_t bytes = 0;
+        HyperLogLog distinct_ips;
+        HyperLogLog distinct_user_agents;
+        HyperLogLog distinct_urls;
+        HeavyHitters ips;
+        HeavyHitters user_agents;
+        HeavyHitters urls;
+        HeavyHitters models;
+        std::array<uint64_t, 600> status{};
+        tsl::robin_map<std::string, uint64_t, TransparentStringHash, TransparentStringEqual> methods;
+        tsl::robin_map<int64_t, uint64_t> per_minute;
+
+        void add(const RecordFields& fields)
+        {
+            const uint64_t weight = fields.count;
+            records += weight;
+
+            if (!fields.source_ip.empty())
+            {
+                const uint64_t h = hash_key(fields.source_ip);
+                distinct_ips.add(h);
+                ips.add(fields.source_ip, h, weight);
+            }
+            if (!fields.user_agent.empty())
+            {
+                const uint64_t h = hash_key(fields.user_agent);
+                distinct_user_agents.add(h);
+                user_agents.add(fields.user_agent, h, weight);
+            }
+            if (!fields.url.empty())
+            {
+                const uint64_t h = hash_key(fields.url);
+                distinct_urls.add(h);
+                urls.add(fields.url, h, weight);
+            }
+            if (const std::string_view model = extract_model(fields.body); !model.empty())
+            {
+                models.add(model, hash_key(model), weight);
+            }
+
+            unsigned code = 0;
+            for (const char c : fields.response_status)
+            {
+                code = code * 10 + static_cast<unsigned>(c - '0');
+            }
+            status[code < status.size() ? code : 0] += weight;
+
+            if (const auto it = methods.find(fields.method); it != methods.end())
+            {
+                it.value() += weight;
+            }
+            else
+            {
+                methods.emplace(std::string(fields.method), weight);
+            }
+
+            if (const int64_t minute = minute_of(fields.timestamp); minute >= 0)
+            {
+                per_minute[minute] += weight;
+            }
+        }
+
+        void merge(const Aggregates& other)
+        {
+            records += other.records;
+            malformed += other.malformed;
+            bytes += other.bytes;
+            distinct_ips.merge(other.distinct_ips);
+            distinct_user_agents.merge(other.distinct_user_agents);
+            distinct_urls.merge(other.distinct_urls);
+            ips.merge(other.ips);
+            user_agents.merge(other.user_agents);
+            urls.merge(other.urls);
+            models.merge(other.models);
+            for (size_t i = 0; i < status.size(); ++i)
+            {
+                status[i] += other.status[i];
+            }
+            for (const auto& [method, count] : other.methods)
+            {
+                methods[method] += count;
+            }
+            for (const auto& [minute, count] : other.per_minute)
+            {
+                per_minute[minute] += count;
+            }
+        }
+    };
+
+    struct Chunk
+    {
+        size_t file = 0;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    // Splits a file into pieces of roughly `target` bytes that start and end on line boundaries.
+    void split_chunks(const std::string_view data, const size_t file, const size_t target, std::vector<Chunk>& chunks)
+    {
+        size_t begin = 0;
+        while (begin < data.size())
+        {
+            size_t end = std::min(begin + target, data.size());
+            if (end < data.size())
+            {
+                const size_t newline = data.find('\n', end);
+                end = newline == std::string_view::npos ? data.size() : newline + 1;
+            }
+            chunks.push_back({file, begin, end});
+            begin = end;
+        }
+    }
+
+    void scan_chunk(const std::string_view data, Aggregates& aggregates)
+    {
+        RecordFields fields;
+        size_t pos = 0;
+        while (pos < data.size())
+        {
+            const void* found = std::memchr(data.data() + pos, '\n', data.size() - pos);
+            const size_t end = found ? static_cast<size_t>(static_cast<const char*>(found) - data.data()) : data.size();
+            const std::string_view line = data.substr(pos, end - pos);
+            if (!line.empty())
+            {
+                if (extract_fields(line, fields))
+                {
+                    aggregates.add(fields);
+                }
+                else
+                {
+                    ++aggregates.malformed;
+                }
+            }
+            pos = end + 1;
+        }
+        aggregates.bytes += data.size();
+    }
+
+    void print_top(const std::string_view title, const HeavyHitters& hitters, const size_t k, const uint64_t distinct)
+    {
+        std::cout << fmt::format("\n{}", title);
+        if (distinct > 0)
+        {
+            std::cout << fmt::format(" (~{} distinct)", distinct);
+        }
+        std::cout << std::endl;
+        for (const auto& [key, count] : hitters.top(k))
+        {
+            std::cout << fmt::format("  {:>10}  {}", count, key) << std::endl;
+        }
+    }
+
+    void print_usage(const char* program, std::ostream& out)
+    {
+        out << "Usage: " << program << " [-j threads] [-k top] [--bucket-minutes N] <requests.jsonl>..." << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t top_k = 20;
+    int64_t bucket_minutes = 60;
+    std::vector<std::string> paths;
+
+    std::vector<std::string_view> args(argv, argv + argc);
+    try
+    {
+        for (size_t i = 1; i < args.size(); ++i)
+        {
+            const bool has_value = i + 1 < args.size();
+            if ((args[i] == "-j" || args[i] == "--threads") && has_value)
+            {
+                threads = std::max<size_t>(1, std::stoul(std::string(args[++i])));
+            }
+            else if ((args[i] == "-k" || args[i] == "--top") && has_value)
+            {
+                top_k = std::max<size_t>(1, std::stoul(std::string(args[++i])));
+            }
+            else if (args[i] == "--bucket-minutes" && has_value)
+            {
+                bucket_minutes = std::max<int64_t>(1, std::stoll(std::string(args[++i])));
+            }
+            else if (args[i] == "-h" || args[i] == "--help")
+            {
+                print_usage(argv[0], std::cout);
+                return 0;
+            }
+            else
+            {
+                paths.emplace_back(args[i]);
+            }
+        }
+    }
+    catch (const std::logic_error&)
+    {
+        // std::stoul and std::stoll reject non-numeric or out-of-range values.
+        print_usage(argv[0], std::cerr);
+        return 1;
+    }
+
+    if (paths.empty())
+    {
+        print_usage(argv[0], std::cerr);
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::unique_ptr<MappedFile>> files;
+    std::vector<Chunk> chunks;
+    constexpr size_t chunk_bytes = size_t{32} << 20;
+    for (const auto& path : paths)
+    {
+        try
+        {
+            files.push_back(std::make_unique<MappedFile>(path));
+            split_chunks(files.back()->view(), files.size() - 1, chunk_bytes, chunks);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "[WARN] Skipping " << path << ": " << e.what() << std::endl;
+        }
+    }
+
+    const size_t candidates = std::max<size_t>(top_k * 8, 256);
+    threads = std::min(threads, std::max<size_t>(chunks.size(), 1));
+    std::vector<std::unique_ptr<Aggregates>> partials;
+    for (size_t i = 0; i < threads; ++i)
+    {
+        partials.push_back(std::make_unique<Aggregates>(candidates));
+    }
+
+    std::atomic<size_t> next_chunk{0};
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&, t] {
+            for (size_t i = next_chunk.fetch_add(1); i < chunks.size(); i = next_chunk.fetch_add(1))
+            {
+                const Chunk& chunk = chunks[i];
+                scan_chunk(files[chunk.file]->view().substr(chunk.begin, chunk.end - chunk.begin), *partials[t]);
+            }
+        });
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    Aggregates& total = *partials.front();
+    for (size_t i = 1; i < partials.size(); ++i)
+    {
+        total.merge(*partials[i]);
+    }
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << fmt::format("{} requests ({} malformed records) from {} files, {:.2f} GB in {:.2f}s on {} threads "
+                             "({:.1f} GB/min)",
+                             total.records, total.malformed, files.size(), static_cast<double>(total.bytes) / 1e9,
+                             elapsed, threads,
+                             elapsed > 0 ? static_cast<double>(total.bytes) / 1e9 / elapsed * 60.0 : 0.0)
+              << std::endl;
+
+    print_top("Top source IPs", total.ips, top_k, total.distinct_ips.estimate());
+    print_top("Top user agents", total.user_agents, top_k, total.distinct_user_agents.estimate());
+    print_top("Top URLs", total.urls, top_k, total.distinct_urls.estimate());
+    print_top("Top requested models", total.models, top_k, 0);
+
+    std::cout << "\nMethods" << std::endl;
+    for (const auto& [method, count] : total.methods)
+    {
+        std::cout << fmt::format("  {:>10}  {}", count, method) << std::endl;
+    }
+
+    std::cout << "\nResponse status" << std::endl;
+    for (size_t code = 0; code < total.status.size(); ++code)
+    {
+        if (total.status[code] > 0)
+        {
+            std::cout << fmt::format("  {:>10}  {}", total.status[code], code == 0 ? "other" : std::to_string(code))
+                      << std::endl;
+        }
+    }
+
+    std::vector<std::pair<int64_t, uint64_t>> timeline;
+    for (const auto& [minute, count] : total.per_minute)
+    {
+        const int64_t bucket = minute - minute % bucket_minutes;
+        if (timeline.empty() || timeline.back().first != bucket)
+        {
+            timeline.emplace_back(bucket, 0);
+        }
+        timeline.back().second += count;
+    }
+    std::ranges::sort(timeline);
+    // Unordered iteration can split a bucket; fold adjacent duplicates after sorting.
+    std::vector<std::pair<int64_t, uint64_t>> folded;
+    for (const auto& [bucket, count] : timeline)
+    {
+        if (!folded.empty() && folded.back().first == bucket)
+        {
+            folded.back().second += count;
+        }
+        else
+        {
+            folded.emplace_back(bucket, count);
+        }
+    }
+
+    std::cout << fmt::format("\nRequests per {} min", bucket_minutes) << std::endl;
+    for (const auto& [bucket, count] : folded)
+    {
+        const std::chrono::sys_seconds when{std::chrono::minutes(bucket)};
+        const std::chrono::year_month_day date{std::chrono::floor<std::chrono::days>(when)};
+        const auto time_of_day = std::chrono::hh_mm_ss(when - std::chrono::floor<std::chrono::days>(when));
+        std::cout << fmt::format("  {:04}-{:02}-{:02} {:02}:{:02}  {:>10}", static_cast<int>(date.year()),
+                                 static_cast<unsigned>(date.month()), static_cast<unsigned>(date.day()),
+                                 time_of_day.hours().count(), time_of_day.minutes().count(), count)
+                  << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,390 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fmt/core.h>
+#include <tsl/robin_map.h>
+
+#include "utils/hash.hpp"
+#include "utils/ngram_model.hpp"
+
+namespace fs = std::filesystem;
+using namespace honeypot::utils;
+
+namespace
+{
+    struct Successor
+    {
+        uint32_t token;
+        uint32_t count;
+    };
+
+    class NgramBuilder
+    {
+    public:
+        void add_document(const std::string_view text)
+        {
+            uint32_t prev2 = no_token;
+            uint32_t prev1 = no_token;
+
+            tokenize(text, [&](const std::string_view token_text) {
+                const uint32_t token = intern(token_text);
+                if (prev1 != no_token)
+                {
+                    context_for(prev1, token);
+                }
+                if (prev2 != no_token)
+                {
+                    const uint32_t context = context_for(prev2, prev1);
+                    record(context, token);
+                }
+                prev2 = prev1;
+                prev1 = token;
+            });
+        }
+
+        std::string serialize() const
+        {
+            std::vector<NgramContext> contexts(context_tokens_.size());
+            std::vector<NgramEdge> edges;
+            std::vector<uint32_t> starts;
+
+            for (uint32_t id = 0; id < contexts.size(); ++id)
+            {
+                const auto [first, last] = context_tokens_[id];
+                contexts[id].token = last;
+                contexts[id].edge_begin = static_cast<uint32_t>(edges.size());
+                contexts[id].edge_count = static_cast<uint32_t>(successors_[id].size());
+                append_alias_table(last, successors_[id], edges);
+
+                if (is_sentence_end(token_strings_[first]) && starts_sentence(token_strings_[last]))
+                {
+                    starts.push_back(id);
+                }
+            }
+
+            std::vector<uint32_t> token_offsets;
+            std::string strings;
+            token_offsets.reserve(token_strings_.size() + 1);
+            for (const auto& token : token_strings_)
+            {
+                token_offsets.push_back(static_cast<uint32_t>(strings.size()));
+                strings.append(token);
+            }
+            token_offsets.push_back(static_cast<uint32_t>(strings.size()));
+
+            NgramFileHeader header{};
+            std::memcpy(header.magic, ngram_magic, sizeof(ngram_magic));
+            header.version = ngram_format_version;
+            header.endian_tag = ngram_endian_tag;
+            header.token_count = static_cast<uint32_t>(token_strings_.size());
+            header.context_count = static_cast<uint32_t>(contexts.size());
+            header.edge_count = static_cast<uint32_t>(edges.size());
+            header.start_count = static_cast<uint32_t>(starts.size());
+
+            std::string out(sizeof(NgramFileHeader), '\0');
+            const auto append_section = [&out](const void* data, const size_t bytes) {
+                out.resize((out.size() + 7) & ~size_t{7}, '\0');
+                const uint64_t offset = out.size();
+                out.append(static_cast<const char*>(data), bytes);
+                return offset;
+            };
+            header.token_offsets_offset = append_section(token_offsets.data(), token_offsets.size() * sizeof(uint32_t));
+            header.strings_offset = append_section(strings.data(), strings.size());
+            header.contexts_offset = append_section(contexts.data(), contexts.size() * sizeof(NgramContext));
+            header.edges_offset = append_section(edges.data(), edges.size() * sizeof(NgramEdge));
+            header.starts_offset = append_section(starts.data(), starts.size() * sizeof(uint32_t));
+            out.resize((out.size() + 7) & ~size_t{7}, '\0');
+            header.file_size = out.size();
+
+            std::memcpy(out.data(), &header, sizeof(header));
+            return out;
+        }
+
+        size_t token_count() const { return token_strings_.size(); }
+        size_t context_count() const { return context_tokens_.size(); }
+
+    private:
+        static constexpr uint32_t no_token = UINT32_MAX;
+
+        /**
+         * Splits text into tokens that carry their leading whitespace, so concatenating
+         * generated tokens reproduces natural spacing. Words (including UTF-8 sequences and
+         * inner apostrophes) form one token, every other punctuation byte its own.
+         */
+        template <typename Callback>
+        static void tokenize(const std::string_view text, Callback&& emit)
+        {
+            std::string token;
+            size_t pos = 0;
+            while (pos < text.size())
+            {
+                size_t newlines = 0;
+                bool whitespace = false;
+                while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos])))
+                {
+                    newlines += text[pos] == '\n';
+                    whitespace = true;
+                    ++pos;
+                }
+                if (pos >= text.size())
+                {
+                    break;
+                }
+
+                token.clear();
+                if (newlines >= 2)
+                {
+                    token = "\n\n";
+                }
+                else if (whitespace)
+                {
+                    token = newlines == 1 ? "\n" : " ";
+                }
+
+                const auto is_word_byte = [](const unsigned char c) {
+                    return std::isalnum(c) || c >= 0x80;
+                };
+                if (is_word_byte(static_cast<unsigned char>(text[pos])))
+                {
+                    while (pos < text.size())
+                    {
+                        const auto c = static_cast<unsigned char>(text[pos]);
+                        const bool inner_apostrophe = c == '\'' && pos + 1 < text.size()
+                                                      && is_word_byte(static_cast<unsigned char>(text[pos + 1]));
+                        if (!is_word_byte(c) && !inner_apostrophe)
+                        {
+                            break;
+                        }
+                        token.push_back(text[pos++]);
+                    }
+                }
+                else
+                {
+                    token.push_back(text[pos++]);
+                }
+                emit(std::string_view(token));
+            }
+        }
+
+        static bool is_sentence_end(const std::string_view token)
+        {
+            return token.ends_with('.') || token.ends_with('!') || token.ends_with('?');
+        }
+
+        static bool starts_sentence(std::string_view token)
+        {
+            while (!token.empty() && std::isspace(static_cast<unsigned char>(token.front())))
+            {
+                token.remove_prefix(1);
+            }
+            return !token.empty() && std::isupper(static_cast<unsigned char>(token.front()));
+        }
+
+        /**
+         * Vose's alias method: turns successor counts into a table where one uniform slot pick
+         * plus one threshold comparison samples the exact empirical distribution.
+         */
+        void append_alias_table(const uint32_t context_last_token, const std::vector<Successor>& successors,
+                                std::vector<NgramEdge>& edges) const
+        {
+            const size_t n = successors.size();
+            if (n == 0)
+            {
+                return;
+            }
+
+            uint64_t total = 0;
+            for (const auto& s : successors)
+            {
+                total += s.count;
+            }
+
+            std::vector<double> scaled(n);
+            std::vector<uint32_t> small;
+            std::vector<uint32_t> large;
+            for (uint32_t i = 0; i < n; ++i)
+            {
+                scaled[i] = static_cast<double>(successors[i].count) * static_cast<double>(n)
+                            / static_cast<double>(total);
+                (scaled[i] < 1.0 ? small : large).push_back(i);
+            }
+
+            std::vector<NgramEdge> table(n);
+            for (uint32_t i = 0; i < n; ++i)
+            {
+                table[i].next_context = context_ids_.at(pair_key(context_last_token, successors[i].token));
+                table[i].alias = i;
+                table[i].threshold = UINT32_MAX;
+            }
+
+            while (!small.empty() && !large.empty())
+            {
+                const uint32_t s = small.back();
+                small.pop_back();
+                const uint32_t l = large.back();
+
+                table[s].threshold = static_cast<uint32_t>(std::clamp(scaled[s], 0.0, 1.0) * 4294967295.0);
+                table[s].alias = l;
+                scaled[l] -= 1.0 - scaled[s];
+                if (scaled[l] < 1.0)
+                {
+                    large.pop_back();
+                    small.push_back(l);
+                }
+            }
+
+            edges.insert(edges.end(), table.begin(), table.end());
+        }
+
+        static uint64_t pair_key(const uint32_t first, const uint32_t second)
+        {
+            return (static_cast<uint64_t>(first) << 32) | second;
+        }
+
+        uint32_t intern(const std::string_view token)
+        {
+            const auto it = vocab_.find(token);
+            if (it != vocab_.end())
+            {
+                return it->second;
+            }
+            const auto id = static_cast<uint32_t>(token_strings_.size());
+            token_strings_.emplace_back(token);
+            vocab_.emplace(std::string(token), id);
+            return id;
+        }
+
+        uint32_t context_for(const uint32_t first, const uint32_t second)
+        {
+            const auto [it, inserted] = context_ids_.try_emplace(pair_key(first, second),
+                                                                 static_cast<uint32_t>(context_tokens_.size()));
+            if (inserted)
+            {
+                context_tokens_.emplace_back(first, second);
+                successors_.emplace_back();
+            }
+            return it->second;
+        }
+
+        void record(const uint32_t context, const uint32_t token)
+        {
+            auto& list = successors_[context];
+            const auto it = std::ranges::find(list, token, &Successor::token);
+            if (it != list.end())
+            {
+                ++it->count;
+            }
+            else
+            {
+                list.push_back({token, 1});
+            }
+        }
+
+        tsl::robin_map<std::string, uint32_t, TransparentStringHash, TransparentStringEqual> vocab_;
+        std::vector<std::string> token_strings_;
+        tsl::robin_map<uint64_t, uint32_t> context_ids_;
+        std::vector<std::pair<uint32_t, uint32_t>> context_tokens_;
+        std::vector<std::vector<Successor>> successors_;
+    };
+
+    void collect_inputs(const fs::path& input, std::vector<fs::path>& files)
+    {
+        if (fs::is_directory(input))
+        {
+            for (const auto& entry : fs::recursive_directory_iterator(input))
+            {
+                if (entry.is_regular_file())
+                {
+                    files.push_back(entry.path());
+                }
+            }
+        }
+        else
+        {
+            files.push_back(input);
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::string output_path;
+    std::vector<fs::path> inputs;
+
+    std::vector<std::string_view> args(argv, argv + argc);
+    for (size_t i = 1; i < args.size(); ++i)
+    {
+        if ((args[i] == "-o" || args[i] == "--output") && (i + 1 < args.size()))
+        {
+            output_path = args[++i];
+        }
+        else if (args[i] == "-h" || args[i] == "--help")
+        {
+            std::cout << "Usage: " << argv[0] << " -o <model.bin> <corpus file or directory>..." << std::endl;
+            return 0;
+        }
+        else
+        {
+            collect_inputs(fs::path(args[i]), inputs);
+        }
+    }
+
+    if (output_path.empty() || inputs.empty())
+    {
+        std::cerr << "Usage: " << argv[0] << " -o <model.bin> <corpus file or directory>..." << std::endl;
+        return 1;
+    }
+    std::ranges::sort(inputs);
+
+    NgramBuilder builder;
+    for (const auto& file : inputs)
+    {
+        std::ifstream in(file, std::ios::binary);
+        if (!in.is_open())
+        {
+            std::cerr << "[WARN] Skipping unreadable corpus file: " << file.string() << std::endl;
+            continue;
+        }
+        const std::string text{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+        builder.add_document(text);
+    }
+
+    if (builder.context_count() == 0)
+    {
+        std::cerr << "FATAL: corpus produced no token pairs." << std::endl;
+        return 1;
+    }
+
+    const std::string model_bytes = builder.serialize();
+    const std::string temp_path = output_path + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        out.write(model_bytes.data(), static_cast<std::streamsize>(model_bytes.size()));
+        if (!out)
+        {
+            std::cerr << "FATAL: failed to write " << temp_path << std::endl;
+            return 1;
+        }
+    }
+    std::error_code ec;
+    fs::rename(temp_path, output_path, ec);
+    if (ec)
+    {
+        std::cerr << "FATAL: failed to move model into place: " << ec.message() << std::endl;
+        return 1;
+    }
+
+    std::cout << fmt::format("[INFO] Wrote {} ({} bytes): {} files, {} tokens, {} contexts", output_path,
+                             model_bytes.size(), inputs.size(), builder.token_count(), builder.context_count())
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,685 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <asio.hpp>
+#include <fmt/core.h>
+#include <nlohmann/json.hpp>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Options
+    {
+        std::string host = "127.0.0.1";
+        std::string port = "11434";
+        size_t concurrency = 16;
+        double speedup = 1.0;
+        bool max_rate = false;
+        uint64_t limit = 0;
+        std::vector<std::string> captures;
+    };
+
+    struct ReplayRequest
+    {
+        std::string method;
+        std::string url;
+        std::vector<std::pair<std::string, std::string>> headers;
+        std::string body;
+        int recorded_status = 0;
+        std::chrono::seconds offset{0}; // since the first record of the capture
+        bool body_truncated = false;
+        uint64_t repeat = 1;            // a collapsed record's count
+        std::chrono::seconds spread{0}; // a collapsed record's first_seen to last_seen
+    };
+
+    /**
+     * Bounded hand-off between the capture reader and the workers, so memory stays
+     * proportional to the concurrency rather than the capture size.
+     */
+    class RequestQueue
+    {
+    public:
+        explicit RequestQueue(const size_t capacity) : capacity_(capacity) {}
+
+        void push(ReplayRequest request)
+        {
+            std::unique_lock lock(mutex_);
+            not_full_.wait(lock, [this] { return queue_.size() < capacity_; });
+            queue_.push_back(std::move(request));
+            not_empty_.notify_one();
+        }
+
+        std::optional<ReplayRequest> pop()
+        {
+            std::unique_lock lock(mutex_);
+            not_empty_.wait(lock, [this] { return !queue_.empty() || closed_; });
+            if (queue_.empty())
+            {
+                return std::nullopt;
+            }
+            ReplayRequest request = std::move(queue_.front());
+            queue_.pop_front();
+            not_full_.notify_one();
+            return request;
+        }
+
+        void close()
+        {
+            std::scoped_lock lock(mutex_);
+            closed_ = true;
+            not_empty_.notify_all();
+        }
+
+    private:
+        const size_t capacity_;
+        std::mutex mutex_;
+        std::condition_variable not_full_;
+        std::condition_variable not_empty_;
+        std::deque<ReplayRequest> queue_;
+        bool closed_ = false;
+    };
+
+    /**
+     * Log-linear latency histogram in microseconds: 32 sub-buckets per power of two, so
+     * percentiles are within ~3% regardless of how many samples are recorded.
+     */
+    class LatencyHistogram
+    {
+    public:
+        void record(const uint64_t micros)
+        {
+            ++buckets_[bucket_of(micros)];
+            ++count_;
+            max_ = std::max(max_, micros);
+            sum_ += micros;
+        }
+
+        void merge(const LatencyHistogram& other)
+        {
+            for (size_t i = 0; i < buckets_.size(); ++i)
+            {
+                buckets_[i] += other.buckets_[i];
+            }
+            count_ += other.count_;
+            max_ = std::max(max_, other.max_);
+            sum_ += other.sum_;
+        }
+
+        uint64_t percentile(const double p) const
+        {
+            if (count_ == 0)
+            {
+                return 0;
+            }
+            const auto rank = static_cast<uint64_t>(p / 100.0 * static_cast<double>(count_ - 1)) + 1;
+            uint64_t seen = 0;
+            for (size_t i = 0; i < buckets_.size(); ++i)
+            {
+                seen += buckets_[i];
+                if (seen >= rank)
+                {
+                    return std::min(upper_bound_of(i), max_);
+                }
+            }
+            return max_;
+        }
+
+        uint64_t count() const { return count_; }
+        uint64_t max() const { return max_; }
+        double mean() const { return count_ ? static_cast<double>(sum_) / static_cast<double>(count_) : 0.0; }
+
+    private:
+        static constexpr unsigned sub_bits = 5;
+        static constexpr size_t sub_count = size_t{1} << sub_bits;
+
+        static size_t bucket_of(const uint64_t value)
+        {
+            if (value < sub_count)
+            {
+                return value;
+            }
+            const unsigned exponent = std::bit_width(value) - 1 - sub_bits;
+            return (exponent + 1) * sub_count + ((value >> exponent) - sub_count);
+        }
+
+        static uint64_t upper_bound_of(const size_t bucket)
+        {
+            if (bucket < sub_count)
+            {
+                return bucket;
+            }
+            const size_t exponent = bucket / sub_count - 1;
+            return ((bucket % sub_count + sub_count + 1) << exponent) - 1;
+        }
+
+        std::array<uint64_t, (64 - sub_bits + 1) * sub_count> buckets_{};
+        uint64_t count_ = 0;
+        uint64_t max_ = 0;
+        uint64_t sum_ = 0;
+    };
+
+    struct Divergence
+    {
+        uint64_t count = 0;
+        std::string example; // first request that diverged this way
+    };
+
+    struct WorkerStats
+    {
+        LatencyHistogram latency;
+        uint64_t completed = 0;
+        uint64_t errors = 0;
+        uint64_t late = 0; // sent more than 100 ms after their scheduled time
+        uint64_t bytes_received = 0;
+        std::map<std::pair<int, int>, Divergence> divergences; // keyed by (recorded, actual)
+    };
+
+    std::optional<std::chrono::sys_seconds> parse_timestamp(const std::string_view text)
+    {
+        // log_request writes "%Y-%m-%dT%H:%M:%SZ".
+        int values[6] = {};
+        const size_t widths[6] = {4, 2, 2, 2, 2, 2};
+        size_t pos = 0;
+        for (size_t i = 0; i < 6; ++i)
+        {
+            if (pos + widths[i] > text.size())
+            {
+                return std::nullopt;
+            }
+            const auto [ptr, ec] = std::from_chars(text.data() + pos, text.data() + pos + widths[i], values[i]);
+            if (ec != std::errc{})
+            {
+                return std::nullopt;
+            }
+            pos += widths[i] + 1;
+        }
+        const std::chrono::year_month_day date{std::chrono::year(values[0]),
+                                               std::chrono::month(static_cast<unsigned>(values[1])),
+                                               std::chrono::day(static_cast<unsigned>(values[2]))};
+        if (!date.ok())
+        {
+            return std::nullopt;
+        }
+        return std::chrono::sys_days(date) + std::chrono::hours(values[3]) + std::chrono::minutes(values[4])
+               + std::chrono::seconds(values[5]);
+    }
+
+    bool is_managed_header(const std::string_view name)
+    {
+        const auto equals = [name](const std::string_view other) {
+            return std::ranges::equal(name, other, [](const char a, const char b) {
+                return std::tolower(static_cast<unsigned char>(a)) == b;
+            });
+        };
+        return equals("host") || equals("content-length") || equals("connection") || equals("transfer-encoding");
+    }
+
+    std::string build_request(const ReplayRequest& request, const Options& options)
+    {
+        std::string out;
+        out.reserve(256 + request.body.size());
+        out.append(request.method).append(" ").append(request.url).append(" HTTP/1.1\r\n");
+        out.append("Host: ").append(options.host).append(":").append(options.port).append("\r\n");
+        for (const auto& [name, value] : request.headers)
+        {
+            if (!is_managed_header(name))
+            {
+                out.append(name).append(": ").append(value).append("\r\n");
+            }
+        }
+        if (!request.body.empty() || request.method == "POST" || request.method == "PUT")
+        {
+            out.append(fmt::format("Content-Length: {}\r\n", request.body.size()));
+        }
+        out.append("Connection: keep-alive\r\n\r\n");
+        out.append(request.body);
+        return out;
+    }
+
+    /**
+     * Minimal HTTP/1.1 client on one keep-alive connection. Reads exactly one response,
+     * honouring Content-Length, chunked encoding and Connection: close.
+     */
+    class Connection
+    {
+    public:
+        Connection(asio::io_context& io_context, const asio::ip::tcp::resolver::results_type& endpoints)
+            : socket_(io_context), endpoints_(endpoints)
+        {
+        }
+
+        int exchange(const std::string& request, const bool head_request, uint64_t& bytes_received)
+        {
+            if (!socket_.is_open())
+            {
+                asio::connect(socket_, endpoints_);
+                socket_.set_option(asio::ip::tcp::no_delay(true));
+                buffer_.clear();
+            }
+            asio::write(socket_, asio::buffer(request));
+
+            const size_t header_end = read_until("\r\n\r\n");
+            const std::string_view head(buffer_.data(), header_end);
+            int status = 0;
+            if (head.size() < 12 || std::from_chars(head.data() + 9, head.data() + 12, status).ec != std::errc{})
+            {
+                throw std::runtime_error("malformed status line");
+            }
+
+            const bool chunked = header_value(head, "transfer-encoding").find("chunked") != std::string_view::npos;
+            const bool close = header_value(head, "connection") == "close";
+            size_t content_length = 0;
+            const std::string_view length_text = header_value(head, "content-length");
+            std::from_chars(length_text.data(), length_text.data() + length_text.size(), content_length);
+
+            consume(header_end);
+            if (head_request || status == 204 || status == 304 || (status >= 100 && status < 200))
+            {
+                // No body follows, whatever the headers announce.
+            }
+            else if (chunked)
+            {
+                while (true)
+                {
+                    const size_t line_end = read_until("\r\n");
+                    size_t chunk_size = 0;
+                    std::from_chars(buffer_.data(), buffer_.data() + line_end, chunk_size, 16);
+                    consume(line_end);
+                    read_exactly(chunk_size + 2);
+                    consume(chunk_size + 2);
+                    bytes_received += chunk_size;
+                    if (chunk_size == 0)
+                    {
+                        break;
+                    }
+                }
+            }
+            else
+            {
+                read_exactly(content_length);
+                consume(content_length);
+                bytes_received += content_length;
+            }
+
+            if (close)
+            {
+                reset();
+            }
+            return status;
+        }
+
+        void reset()
+        {
+            asio::error_code ignored;
+            socket_.close(ignored);
+            buffer_.clear();
+        }
+
+    private:
+        static std::string_view header_value(const std::string_view head, const std::string_view lower_name)
+        {
+            size_t pos = head.find("\r\n");
+            while (pos != std::string_view::npos && pos + 2 < head.size())
+            {
+                const size_t start = pos + 2;
+                const size_t end = std::min(head.find("\r\n", start), head.size());
+                const std::string_view line = head.substr(start, end - start);
+                const size_t colon = line.find(':');
+                if (colon == lower_name.size()
+                    && std::ranges::equal(line.substr(0, colon), lower_name, [](const char a, const char b) {
+                        return std::tolower(static_cast<unsigned char>(a)) == b;
+                    }))
+                {
+                    std::string_view value = line.substr(colon + 1);
+                    while (!value.empty() && value.front() == ' ')
+                    {
+                        value.remove_prefix(1);
+                    }
+                    return value;
+                }
+                pos = end;
+            }
+            return {};
+        }
+
+        // Returns the offset just past the delimiter.
+        size_t read_until(const std::string_view delimiter)
+        {
+            return asio::read_until(socket_, asio::dynamic_buffer(buffer_), delimiter);
+        }
+
+        void read_exactly(const size_t bytes)
+        {
+            if (buffer_.size() < bytes)
+            {
+                asio::read(socket_, asio::dynamic_buffer(buffer_), asio::transfer_exactly(bytes - buffer_.size()));
+            }
+        }
+
+        void consume(const size_t bytes)
+        {
+            buffer_.erase(0, bytes);
+        }
+
+        asio::ip::tcp::socket socket_;
+        asio::ip::tcp::resolver::results_type endpoints_;
+        std::string buffer_;
+    };
+
+    // Bounds what one corrupt or hostile "count" can queue.
+    constexpr uint64_t max_repeat = 1'000'000;
+
+    std::optional<ReplayRequest> parse_record(const std::string& line, std::optional<std::chrono::sys_seconds>& first)
+    {
+        const auto record = nlohmann::json::parse(line, nullptr, false);
+        if (record.is_discarded() || !record.is_object() || !record.contains("method") || !record.contains("url"))
+        {
+            return std::nullopt;
+        }
+
+        ReplayRequest request;
+        request.method = record.value("method", std::string{"GET"});
+        request.url = record.value("url", std::string{"/"});
+        request.body = record.value("body", std::string{});
+        request.body_truncated = record.value("body_truncated", false);
+        request.recorded_status = record.value("response_status", 0);
+        if (const auto headers = record.find("headers"); headers != record.end() && headers->is_object())
+        {
+            for (const auto& [name, value] : headers->items())
+            {
+                if (value.is_string())
+                {
+                    request.headers.emplace_back(name, value.get<std::string>());
+                }
+            }
+        }
+
+        if (const auto timestamp = parse_timestamp(record.value("timestamp", std::string{})))
+        {
+            if (!first)
+            {
+                first = timestamp;
+            }
+            request.offset = std::max(*timestamp - *first, std::chrono::seconds::zero());
+        }
+
+        if (const auto count = record.find("count"); count != record.end() && count->is_number_unsigned())
+        {
+            request.repeat = std::clamp<uint64_t>(count->get<uint64_t>(), 1, max_repeat);
+            const auto first_seen = parse_timestamp(record.value("first_seen", std::string{}));
+            const auto last_seen = parse_timestamp(record.value("last_seen", std::string{}));
+            if (first_seen && last_seen)
+            {
+                request.spread = std::max(*last_seen - *first_seen, std::chrono::seconds::zero());
+            }
+        }
+        return request;
+    }
+
+    void run_worker(const Options& options, const asio::ip::tcp::resolver::results_type& endpoints,
+                    RequestQueue& queue, const Clock::time_point start, WorkerStats& stats)
+    {
+        asio::io_context io_context;
+        Connection connection(io_context, endpoints);
+
+        while (auto request = queue.pop())
+        {
+            if (!options.max_rate)
+            {
+                const auto due = start + std::chrono::duration_cast<Clock::duration>(
+                                     std::chrono::duration<double>(request->offset) / options.speedup);
+                const auto now = Clock::now();
+                if (due > now)
+                {
+                    std::this_thread::sleep_until(due);
+                }
+                else if (now - due > std::chrono::milliseconds(100))
+                {
+                    ++stats.late;
+                }
+            }
+
+            const std::string wire = build_request(*request, options);
+            const bool head_request = request->method == "HEAD";
+            const auto sent = Clock::now();
+            int status = 0;
+            try
+            {
+                status = connection.exchange(wire, head_request, stats.bytes_received);
+            }
+            catch (const std::exception&)
+            {
+                // One retry on a fresh connection covers keep-alive connections the server closed.
+                connection.reset();
+                try
+                {
+                    status = connection.exchange(wire, head_request, stats.bytes_received);
+                }
+                catch (const std::exception&)
+                {
+                    connection.reset();
+                    ++stats.errors;
+                    continue;
+                }
+            }
+
+            stats.latency.record(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - sent).count()));
+            ++stats.completed;
+
+            if (request->recorded_status != 0 && status != request->recorded_status)
+            {
+                auto& divergence = stats.divergences[{request->recorded_status, status}];
+                if (divergence.count++ == 0)
+                {
+                    divergence.example = request->method + " " + request->url;
+                }
+            }
+        }
+    }
+
+    void print_usage(const char* program, std::ostream& out)
+    {
+        out << "Usage: " << program
+            << " [-t host:port] [-c concurrency] [--speed N | --max-rate] [-n limit] <capture.jsonl>..." << std::endl
+            << "  Replays request logs against a running honeypot. Default timing follows the recorded" << std::endl
+            << "  inter-arrival times (1 s resolution); --speed N compresses them N times. A collapsed" << std::endl
+            << "  record is sent \"count\" times, spread evenly from its first_seen to its last_seen." << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+
+    std::vector<std::string_view> args(argv, argv + argc);
+    try
+    {
+        for (size_t i = 1; i < args.size(); ++i)
+        {
+            const bool has_value = i + 1 < args.size();
+            if ((args[i] == "-t" || args[i] == "--target") && has_value)
+            {
+                const std::string_view target = args[++i];
+                const size_t colon = target.rfind(':');
+                options.host = std::string(target.substr(0, colon));
+                if (colon != std::string_view::npos)
+                {
+                    options.port = std::string(target.substr(colon + 1));
+                }
+            }
+            else if ((args[i] == "-c" || args[i] == "--concurrency") && has_value)
+            {
+                options.concurrency = std::max<size_t>(1, std::stoul(std::string(args[++i])));
+            }
+            else if (args[i] == "--speed" && has_value)
+            {
+                options.speedup = std::stod(std::string(args[++i]));
+            }
+            else if (args[i] == "--max-rate")
+            {
+                options.max_rate = true;
+            }
+            else if ((args[i] == "-n" || args[i] == "--limit") && has_value)
+            {
+                options.limit = std::stoull(std::string(args[++i]));
+            }
+            else if (args[i] == "-h" || args[i] == "--help")
+            {
+                print_usage(argv[0], std::cout);
+                return 0;
+            }
+            else
+            {
+                options.captures.emplace_back(args[i]);
+            }
+        }
+    }
+    catch (const std::logic_error&)
+    {
+        // std::stoul and friends reject non-numeric or out-of-range values.
+        print_usage(argv[0], std::cerr);
+        return 1;
+    }
+
+    if (options.captures.empty() || options.speedup <= 0.0)
+    {
+        print_usage(argv[0], std::cerr);
+        return 1;
+    }
+
+    asio::ip::tcp::resolver::results_type endpoints;
+    try
+    {
+        asio::io_context io_context;
+        asio::ip::tcp::resolver resolver(io_context);
+        endpoints = resolver.resolve(options.host, options.port);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "FATAL: cannot resolve " << options.host << ":" << options.port << ": " << e.what() << std::endl;
+        return 1;
+    }
+
+    RequestQueue queue(options.concurrency * 4);
+    std::vector<WorkerStats> stats(options.concurrency);
+    std::vector<std::thread> workers;
+    const auto start = Clock::now();
+    for (size_t i = 0; i < options.concurrency; ++i)
+    {
+        workers.emplace_back(run_worker, std::cref(options), std::cref(endpoints), std::ref(queue), start,
+                             std::ref(stats[i]));
+    }
+
+    uint64_t read = 0;
+    uint64_t skipped = 0;
+    uint64_t truncated = 0;
+    for (const auto& capture : options.captures)
+    {
+        std::ifstream in(capture, std::ios::binary);
+        if (!in.is_open())
+        {
+            std::cerr << "[WARN] Skipping unreadable capture: " << capture << std::endl;
+            continue;
+        }
+
+        // Each capture keeps its own timeline; arrival offsets restart at zero per file.
+        std::optional<std::chrono::sys_seconds> first;
+        std::string line;
+        while ((options.limit == 0 || read < options.limit) && std::getline(in, line))
+        {
+            auto request = parse_record(line, first);
+            if (!request)
+            {
+                ++skipped;
+                continue;
+            }
+            const uint64_t repeat = request->repeat;
+            const std::chrono::seconds offset = request->offset;
+            const std::chrono::seconds spread = request->spread;
+            for (uint64_t k = 0; k < repeat && (options.limit == 0 || read < options.limit); ++k)
+            {
+                ReplayRequest copy = k + 1 < repeat ? *request : std::move(*request);
+                if (repeat > 1)
+                {
+                    copy.offset = offset + spread * static_cast<int64_t>(k) / static_cast<int64_t>(repeat - 1);
+                }
+                truncated += copy.body_truncated;
+                ++read;
+                queue.push(std::move(copy));
+            }
+        }
+    }
+    queue.close();
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    WorkerStats total;
+    for (const auto& worker : stats)
+    {
+        total.latency.merge(worker.latency);
+        total.completed += worker.completed;
+        total.errors += worker.errors;
+        total.late += worker.late;
+        total.bytes_received += worker.bytes_received;
+        for (const auto& [key, divergence] : worker.divergences)
+        {
+            auto& merged = total.divergences[key];
+            if (merged.count == 0)
+            {
+                merged.example = divergence.example;
+            }
+            merged.count += divergence.count;
+        }
+    }
+
+    std::cout << fmt::format("Replayed {} requests ({} unparsable lines skipped, {} with truncated bodies) "
+                             "in {:.2f}s with concurrency {}",
+                             read, skipped, truncated, elapsed, options.concurrency) << std::endl;
+    std::cout << fmt::format("  completed {}  errors {}  late {}  throughput {:.1f} req/s  {:.2f} MB received",
+                             total.completed, total.errors, total.late,
+                             elapsed > 0 ? static_cast<double>(total.completed) / elapsed : 0.0,
+                             static_cast<double>(total.bytes_received) / 1e6) << std::endl;
+    std::cout << fmt::format("  latency ms: mean {:.2f}  p50 {:.2f}  p90 {:.2f}  p99 {:.2f}  p99.9 {:.2f}  max {:.2f}",
+                             total.latency.mean() / 1e3, total.latency.percentile(50) / 1e3,
+                             total.latency.percentile(90) / 1e3, total.latency.percentile(99) / 1e3,
+                             total.latency.percentile(99.9) / 1e3, total.latency.max() / 1e3) << std::endl;
+
+    if (total.divergences.empty())
+    {
+        std::cout << "  no status divergences from recorded response_status" << std::endl;
+    }
+    else
+    {
+        std::cout << "  status divergences (recorded -> actual):" << std::endl;
+        for (const auto& [key, divergence] : total.divergences)
+        {
+            std::cout << fmt::format("    {} -> {}: {} (e.g. {})", key.first, key.second, divergence.count,
+                                     divergence.example) << std::endl;
+        }
+    }
+
+    return total.errors == 0 ? 0 : 2;
+}